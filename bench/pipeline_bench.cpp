@@ -0,0 +1,782 @@
+/**
+ * @file pipeline_bench.cpp
+ * @brief 处理流水线的微基准与整体基准
+ *
+ * 合成帧在进程内生成（解码与整体基准所需的视频同样由合成帧编码而来），不需要样例素材。
+ * 结果以 JSON 写到标准输出，每条结果占一行，便于在提交之间直接 diff；进度写到标准错误。
+ */
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <opencv2/imgproc.hpp>
+#include "cpu_features.h"
+#include "gif_lzw.h"
+#include "palette.h"
+#include "quantizer.h"
+#include "slice_scaler.h"
+#include "ssg_core.h"
+#include "video_decoder.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class PipelineBenchmark
+	 * @brief 依次计时解码、缩放、切片映射、调色板、量化、抖动、LZW 与完整任务
+	 *
+	 * 微基准的每个样本至少运行 MIN_SAMPLE_TIME，循环使用 RING_FRAMES 个不同的合成帧，
+	 * 报告单次调用（一帧）耗时的中位数与最小值。各阶段直接调用 slice_scaler.h、quantizer.h 等阶段头文件中
+	 * 流水线同样使用的函数，计时的就是流水线实际执行的代码。
+	 */
+	class PipelineBenchmark
+	{
+	public:
+		static int run(int argc, char *argv[]);
+
+	private:
+		using Processor = ShowcaseProcessor;
+
+		static constexpr int SLICE_COUNT = SliceScaler::SLICE_COUNT;
+
+		using SliceFrames  = std::array<AVFrame *, SLICE_COUNT>;
+		using SliceIndices = std::array<std::vector<uint8_t>, SLICE_COUNT>;
+
+		struct Input
+		{
+			std::string_view name;
+			int				 width;
+			int				 height;
+		};
+
+		struct Settings
+		{
+			int					  frames = 60; // 合成视频的帧数
+			int					  repeat = 5;  // 每项基准的样本数
+			std::vector<Input>	  inputs;
+			std::filesystem::path work_dir;
+		};
+
+		struct Timing
+		{
+			double median_ns = 0;
+			double min_ns	 = 0;
+		};
+
+		/**
+		 * @struct Scalers
+		 * @brief 五个切片各自的缩放上下文，与流水线中每个切片的编码状态一样逐切片复用，析构时释放
+		 */
+		struct Scalers
+		{
+			std::array<SwsContext *, SLICE_COUNT> contexts{};
+			int									  sws_flags;
+
+			explicit Scalers(const int quality_mode) : sws_flags(SliceScaler::select_sws_flags(quality_mode))
+			{
+			}
+			~Scalers()
+			{
+				for (auto *context: contexts)
+				{
+					sws_freeContext(context);
+				}
+			}
+
+			Scalers(const Scalers &)			= delete;
+			Scalers &operator=(const Scalers &) = delete;
+
+			bool scale(const AVFrame &frame, const int index, AVFrame *dst)
+			{
+				return SliceScaler::scale(contexts[index], sws_flags, SliceScaler::map_source(frame, index), dst);
+			}
+		};
+
+		/**
+		 * @struct Fixture
+		 * @brief 单个输入分辨率的合成数据，由 prepare() 填充，各微基准共用；析构时释放全部帧
+		 */
+		struct Fixture
+		{
+			Input							  input;
+			int								  target_h = 0;
+			std::vector<AVFrame *>			  frames;  // 解码器通常输出的 YUV420P 帧
+			std::vector<std::vector<uint8_t>> i420;	   // 同一帧的连续 I420 缓冲，供 OpenCV 路径使用
+			std::vector<SliceFrames>		  slices;  // 默认质量档位缩放后的 BGRA 切片
+			std::vector<SliceIndices>		  indices; // 无抖动量化得到的调色板索引
+			Palette							  palette;
+			int								  next	   = 0;
+
+			Fixture() = default;
+			~Fixture();
+
+			Fixture(const Fixture &)			= delete;
+			Fixture &operator=(const Fixture &) = delete;
+
+			/** @brief 轮流取下一帧的序号 */
+			int advance()
+			{
+				return std::exchange(next, (next + 1) % RING_FRAMES);
+			}
+
+			[[nodiscard]] double frame_pixels() const
+			{
+				return static_cast<double>(input.width) * input.height;
+			}
+
+			[[nodiscard]] double slice_pixels() const
+			{
+				return static_cast<double>(SliceScaler::SLICE_WIDTH) * target_h * SLICE_COUNT;
+			}
+		};
+
+		static constexpr std::array<Input, 3> INPUTS		  = {{{"480p", 854, 480}, {"1080p", 1920, 1080}, {"4k", 3840, 2160}}};
+		static constexpr int				  QUALITY_MODES	  = SliceScaler::QUALITY_LOSSY + 1;
+		static constexpr int				  RING_FRAMES	  = 8;
+		static constexpr int				  SYNTHETIC_FPS	  = 30;
+		static constexpr int				  LOSSY_ERROR	  = 32;
+		static constexpr auto				  MIN_SAMPLE_TIME = std::chrono::milliseconds(50);
+
+		static bool parse_arguments(int argc, char *argv[], Settings &settings);
+
+		// 合成帧：平滑渐变 + 随帧移动的反色圆 + 少量噪点，既有大块平坦区域，也有边缘和帧间变化
+		static void		   fill_synthetic(AVFrame *frame, int index);
+		static bool		   write_synthetic_video(const std::filesystem::path &path, int width, int height, int frames);
+		static void		   pack_i420(const AVFrame &frame, std::vector<uint8_t> &out);
+		static void		   prepare(Fixture &fixture, const Input &input);
+		static void		   map_slices(Fixture &fixture, Quantizer &quantizer, int index);
+		static const char *kernel_name(Quantizer::Kernel kernel);
+
+		/** @brief 预热一次后采集 samples 个样本，每个样本至少持续 min_sample，返回单次调用耗时 */
+		template <typename F>
+		static Timing measure(int samples, std::chrono::nanoseconds min_sample, F &&body);
+
+		void add(std::string_view	stage,
+				 std::string_view	input,
+				 std::string_view	variant,
+				 const Timing	   &timing,
+				 double				pixels,
+				 const std::string &extra = {});
+
+		void bench_resize(const Settings &settings, Fixture &fixture);
+		void bench_slice(const Settings &settings, Fixture &fixture);
+		void bench_palette(const Settings &settings, Fixture &fixture);
+		void bench_quantize(const Settings &settings, Fixture &fixture);
+		void bench_lzw(const Settings &settings, Fixture &fixture);
+		void bench_video(const Settings &settings, const Input &input, const std::filesystem::path &video);
+
+		std::vector<std::string> results_;
+	};
+
+	int PipelineBenchmark::run(const int argc, char *argv[])
+	{
+		Settings settings;
+		if (!parse_arguments(argc, argv, settings))
+		{
+			std::cerr << "usage: SS-G-bench [--frames N] [--repeat N] [--inputs 480p,1080p,4k]\n";
+			return 2;
+		}
+
+		Processor::silence_library_logs();
+		std::filesystem::create_directories(settings.work_dir);
+
+		PipelineBenchmark bench;
+		for (const auto &input: settings.inputs)
+		{
+			{
+				Fixture fixture;
+				prepare(fixture, input);
+				bench.bench_resize(settings, fixture);
+				bench.bench_slice(settings, fixture);
+				bench.bench_palette(settings, fixture);
+				bench.bench_quantize(settings, fixture);
+				bench.bench_lzw(settings, fixture);
+			}
+
+			const auto video = settings.work_dir / std::format("synthetic_{}.mp4", input.name);
+			if (write_synthetic_video(video, input.width, input.height, settings.frames))
+			{
+				bench.bench_video(settings, input, video);
+			}
+			else
+			{
+				std::cerr << "[bench] " << input.name << ": cannot write the synthetic video, skipping decode and full runs\n";
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::remove_all(settings.work_dir, ec);
+
+		std::cout << std::format(R"({{"benchmark":"ssg_pipeline","version":"{}","kernel":"{}","hardware_threads":{},"frames":{},"repeat":{},"results":[)",
+								 APP_VERSION,
+								 kernel_name(Quantizer::best_kernel()),
+								 std::thread::hardware_concurrency(),
+								 settings.frames,
+								 settings.repeat)
+				  << '\n';
+		for (std::size_t i = 0; i < bench.results_.size(); ++i)
+		{
+			std::cout << "  " << bench.results_[i] << (i + 1 < bench.results_.size() ? ",\n" : "\n");
+		}
+		std::cout << "]}\n";
+		return 0;
+	}
+
+	bool PipelineBenchmark::parse_arguments(const int argc, char *argv[], Settings &settings)
+	{
+		auto parse_int = [](const std::string_view text, int &value)
+		{
+			const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+			return result.ec == std::errc() && result.ptr == text.data() + text.size() && value > 0;
+		};
+
+		std::string_view names = "480p,1080p,4k";
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			const std::string_view value = argv[++i];
+			if (arg == "--frames")
+			{
+				if (!parse_int(value, settings.frames))
+				{
+					return false;
+				}
+			}
+			else if (arg == "--repeat")
+			{
+				if (!parse_int(value, settings.repeat))
+				{
+					return false;
+				}
+			}
+			else if (arg == "--inputs")
+			{
+				names = value;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		for (const auto name: std::views::split(names, ','))
+		{
+			const std::string_view wanted(name.begin(), name.end());
+			const auto			   it = std::ranges::find(INPUTS, wanted, &Input::name);
+			if (it == INPUTS.end())
+			{
+				return false;
+			}
+			settings.inputs.push_back(*it);
+		}
+		settings.work_dir = std::filesystem::temp_directory_path() / "ssg_bench";
+		return !settings.inputs.empty();
+	}
+
+	void PipelineBenchmark::fill_synthetic(AVFrame *frame, const int index)
+	{
+		const int w		 = frame->width;
+		const int h		 = frame->height;
+		const int cx	 = (index * 9 * w / 200) % w;
+		const int cy	 = h / 2 + static_cast<int>(h / 4 * std::sin(index * 0.2));
+		const int radius = h / 5;
+		uint32_t  seed	 = 0x9E3779B9u * static_cast<uint32_t>(index + 1);
+
+		for (int y = 0; y < h; ++y)
+		{
+			uint8_t *row = frame->data[0] + static_cast<std::ptrdiff_t>(y) * frame->linesize[0];
+			for (int x = 0; x < w; ++x)
+			{
+				int luma = 16 + (x * 160 / w) + (y * 60 / h);
+				if ((x - cx) * (x - cx) + (y - cy) * (y - cy) < radius * radius)
+				{
+					luma = 255 - luma;
+				}
+				seed   = seed * 1664525u + 1013904223u;
+				row[x] = static_cast<uint8_t>(std::clamp(luma + static_cast<int>(seed >> 29) - 4, 0, 255));
+			}
+		}
+		for (int y = 0; y < h / 2; ++y)
+		{
+			uint8_t *u = frame->data[1] + static_cast<std::ptrdiff_t>(y) * frame->linesize[1];
+			uint8_t *v = frame->data[2] + static_cast<std::ptrdiff_t>(y) * frame->linesize[2];
+			for (int x = 0; x < w / 2; ++x)
+			{
+				u[x] = static_cast<uint8_t>(64 + x * 128 / (w / 2));
+				v[x] = static_cast<uint8_t>(64 + (y * 128 / (h / 2) + index * 2) % 128);
+			}
+		}
+	}
+
+	bool PipelineBenchmark::write_synthetic_video(const std::filesystem::path &path, const int width, const int height, const int frames)
+	{
+		// MPEG-4 Part 2 编码器内置于 libavcodec，不依赖外部编码库
+		const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+		if (!codec)
+		{
+			return false;
+		}
+
+		AVFormatContext *fmt_ctx = nullptr;
+		if (avformat_alloc_output_context2(&fmt_ctx, nullptr, nullptr, path.string().c_str()) < 0)
+		{
+			return false;
+		}
+		AVStream	   *stream	  = avformat_new_stream(fmt_ctx, nullptr);
+		AVCodecContext *codec_ctx = avcodec_alloc_context3(codec);
+		AVFrame		   *frame	  = av_frame_alloc();
+		AVPacket	   *packet	  = av_packet_alloc();
+
+		bool ok = stream && codec_ctx && frame && packet;
+		if (ok)
+		{
+			codec_ctx->width	 = width;
+			codec_ctx->height	 = height;
+			codec_ctx->pix_fmt	 = AV_PIX_FMT_YUV420P;
+			codec_ctx->time_base = {1, SYNTHETIC_FPS};
+			codec_ctx->framerate = {SYNTHETIC_FPS, 1};
+			codec_ctx->gop_size	 = 12;
+			codec_ctx->bit_rate	 = static_cast<int64_t>(width) * height * SYNTHETIC_FPS / 8;
+			if (fmt_ctx->oformat->flags & AVFMT_GLOBALHEADER)
+			{
+				codec_ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+			}
+			ok = avcodec_open2(codec_ctx, codec, nullptr) >= 0 && avcodec_parameters_from_context(stream->codecpar, codec_ctx) >= 0;
+		}
+		if (ok)
+		{
+			stream->time_base = codec_ctx->time_base;
+			ok = avio_open(&fmt_ctx->pb, path.string().c_str(), AVIO_FLAG_WRITE) >= 0 && avformat_write_header(fmt_ctx, nullptr) >= 0;
+		}
+		if (ok)
+		{
+			frame->format = AV_PIX_FMT_YUV420P;
+			frame->width  = width;
+			frame->height = height;
+			ok			  = av_frame_get_buffer(frame, 0) >= 0;
+		}
+
+		auto drain = [&]
+		{
+			while (avcodec_receive_packet(codec_ctx, packet) == 0)
+			{
+				av_packet_rescale_ts(packet, codec_ctx->time_base, stream->time_base);
+				packet->stream_index = stream->index;
+				av_interleaved_write_frame(fmt_ctx, packet);
+			}
+		};
+		for (int i = 0; ok && i < frames; ++i)
+		{
+			ok = av_frame_make_writable(frame) >= 0;
+			if (ok)
+			{
+				fill_synthetic(frame, i);
+				frame->pts = i;
+				ok		   = avcodec_send_frame(codec_ctx, frame) >= 0;
+				drain();
+			}
+		}
+		if (ok)
+		{
+			avcodec_send_frame(codec_ctx, nullptr);
+			drain();
+			ok = av_write_trailer(fmt_ctx) >= 0;
+		}
+
+		av_packet_free(&packet);
+		av_frame_free(&frame);
+		avcodec_free_context(&codec_ctx);
+		if (fmt_ctx->pb)
+		{
+			avio_closep(&fmt_ctx->pb);
+		}
+		avformat_free_context(fmt_ctx);
+		return ok;
+	}
+
+	void PipelineBenchmark::pack_i420(const AVFrame &frame, std::vector<uint8_t> &out)
+	{
+		const int w = frame.width;
+		const int h = frame.height;
+		out.resize(static_cast<std::size_t>(w) * h * 3 / 2);
+		uint8_t *dst = out.data();
+		for (int p = 0; p < 3; ++p)
+		{
+			const int pw = p == 0 ? w : w / 2;
+			const int ph = p == 0 ? h : h / 2;
+			for (int y = 0; y < ph; ++y)
+			{
+				std::memcpy(dst, frame.data[p] + static_cast<std::ptrdiff_t>(y) * frame.linesize[p], pw);
+				dst += pw;
+			}
+		}
+	}
+
+	const char *PipelineBenchmark::kernel_name(const Quantizer::Kernel kernel)
+	{
+		switch (kernel)
+		{
+			case Quantizer::Kernel::Sse41:
+				return "sse41";
+			case Quantizer::Kernel::Avx2:
+				return "avx2";
+			case Quantizer::Kernel::Avx512:
+				return "avx512";
+			default:
+				return "scalar";
+		}
+	}
+
+	template <typename F>
+	PipelineBenchmark::Timing PipelineBenchmark::measure(const int samples, const std::chrono::nanoseconds min_sample, F &&body)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// 预热：建立缩放上下文、逆色表、文件缓存等一次性状态
+		body();
+
+		std::vector<double> per_call;
+		for (int s = 0; s < samples; ++s)
+		{
+			std::size_t		calls	= 0;
+			const auto		start	= Clock::now();
+			Clock::duration elapsed = {};
+			do
+			{
+				body();
+				++calls;
+				elapsed = Clock::now() - start;
+			} while (elapsed < min_sample);
+			per_call.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(calls));
+		}
+		std::ranges::sort(per_call);
+		return {per_call[per_call.size() / 2], per_call.front()};
+	}
+
+	void PipelineBenchmark::add(const std::string_view stage,
+								const std::string_view input,
+								const std::string_view variant,
+								const Timing		  &timing,
+								const double		   pixels,
+								const std::string	  &extra)
+	{
+		results_.push_back(std::format(R"({{"stage":"{}","input":"{}","variant":"{}","median_us":{:.3f},"min_us":{:.3f},"mpix_per_s":{:.2f}{}}})",
+									   stage,
+									   input,
+									   variant,
+									   timing.median_ns / 1e3,
+									   timing.min_ns / 1e3,
+									   pixels / timing.median_ns * 1e3,
+									   extra));
+		std::cerr << "[bench] " << stage << ' ' << input << ' ' << variant << ": " << std::format("{:.1f} us", timing.median_ns / 1e3) << '\n';
+	}
+
+	PipelineBenchmark::Fixture::~Fixture()
+	{
+		for (auto &slice_frames: slices)
+		{
+			for (auto &frame: slice_frames)
+			{
+				av_frame_free(&frame);
+			}
+		}
+		for (auto &frame: frames)
+		{
+			av_frame_free(&frame);
+		}
+	}
+
+	void PipelineBenchmark::prepare(Fixture &fixture, const Input &input)
+	{
+		fixture.input	 = input;
+		fixture.target_h = static_cast<int>(SliceScaler::SHOWCASE_WIDTH * (static_cast<double>(input.height) / input.width));
+		fixture.frames.resize(RING_FRAMES);
+		fixture.i420.resize(RING_FRAMES);
+		fixture.slices.resize(RING_FRAMES);
+		fixture.indices.resize(RING_FRAMES);
+
+		Scalers scalers(TaskOptions{}.quality_mode);
+
+		ColorHistogram histogram;
+		for (int f = 0; f < RING_FRAMES; ++f)
+		{
+			AVFrame *frame = av_frame_alloc();
+			frame->format  = AV_PIX_FMT_YUV420P;
+			frame->width   = input.width;
+			frame->height  = input.height;
+			av_frame_get_buffer(frame, 0);
+			fill_synthetic(frame, f * 5);
+			pack_i420(*frame, fixture.i420[f]);
+			fixture.frames[f] = frame;
+
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				AVFrame *slice = SliceScaler::alloc_frame(SliceScaler::SLICE_WIDTH, fixture.target_h, AV_PIX_FMT_BGRA);
+				scalers.scale(*frame, i, slice);
+				histogram.add(slice->data[0], slice->linesize[0], slice->width, slice->height);
+				fixture.slices[f][i] = slice;
+			}
+		}
+
+		// 与全局调色板模式相同：整段抽样生成一次
+		fixture.palette = histogram.build_palette(256);
+		Quantizer quantizer;
+		quantizer.set_palette(fixture.palette);
+		for (int f = 0; f < RING_FRAMES; ++f)
+		{
+			map_slices(fixture, quantizer, f);
+		}
+	}
+
+	void PipelineBenchmark::map_slices(Fixture &fixture, Quantizer &quantizer, const int index)
+	{
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			const AVFrame		 *slice	  = fixture.slices[index][i];
+			std::vector<uint8_t> &indices = fixture.indices[index][i];
+			indices.resize(static_cast<std::size_t>(slice->width) * slice->height);
+			quantizer.map(slice->data[0], slice->linesize[0], slice->width, slice->height, indices.data(), slice->width);
+		}
+	}
+
+	// 缩放：改造前的整帧转换 + cv::resize + 裁剪，对比逐切片一次完成裁剪、缩放与色彩转换的 sws 路径
+	void PipelineBenchmark::bench_resize(const Settings &settings, Fixture &fixture)
+	{
+		static constexpr std::array<int, QUALITY_MODES> interpolation = {
+			cv::INTER_NEAREST, cv::INTER_LINEAR, cv::INTER_CUBIC, cv::INTER_LANCZOS4, cv::INTER_CUBIC};
+
+		const int	width	 = fixture.input.width;
+		const int	height	 = fixture.input.height;
+		const int	target_h = fixture.target_h;
+		SliceFrames scaled{};
+		for (auto &frame: scaled)
+		{
+			frame = SliceScaler::alloc_frame(SliceScaler::SLICE_WIDTH, target_h, AV_PIX_FMT_BGRA);
+		}
+
+		for (int q = 0; q < QUALITY_MODES; ++q)
+		{
+			cv::Mat							 bgr, resized;
+			std::array<cv::Mat, SLICE_COUNT> cv_slices;
+			auto							 opencv_path = [&]
+			{
+				const cv::Mat yuv(height * 3 / 2, width, CV_8UC1, fixture.i420[fixture.advance()].data());
+				cv::cvtColor(yuv, bgr, cv::COLOR_YUV2BGR_I420);
+				cv::resize(bgr, resized, cv::Size(SliceScaler::SHOWCASE_WIDTH, target_h), 0, 0, interpolation[q]);
+				for (int i = 0; i < SLICE_COUNT; ++i)
+				{
+					const cv::Rect roi(i * (SliceScaler::SLICE_WIDTH + SliceScaler::GAP_WIDTH), 0, SliceScaler::SLICE_WIDTH, target_h);
+					cv::cvtColor(resized(roi), cv_slices[i], cv::COLOR_BGR2BGRA);
+				}
+			};
+			add("resize", fixture.input.name, std::format("cv_resize/q{}", q), measure(settings.repeat, MIN_SAMPLE_TIME, opencv_path), fixture.frame_pixels());
+
+			Scalers scalers(q);
+			auto	fused_path = [&]
+			{
+				const AVFrame &frame = *fixture.frames[fixture.advance()];
+				for (int i = 0; i < SLICE_COUNT; ++i)
+				{
+					scalers.scale(frame, i, scaled[i]);
+				}
+			};
+			add("resize", fixture.input.name, std::format("fused_sws/q{}", q), measure(settings.repeat, MIN_SAMPLE_TIME, fused_path), fixture.frame_pixels());
+		}
+
+		for (auto &frame: scaled)
+		{
+			av_frame_free(&frame);
+		}
+	}
+
+	// 切片映射：只计算五个跨步视图，不触及像素
+	void PipelineBenchmark::bench_slice(const Settings &settings, Fixture &fixture)
+	{
+		std::size_t checksum = 0;
+		auto		map		 = [&]
+		{
+			const AVFrame &frame = *fixture.frames[fixture.advance()];
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				checksum += static_cast<std::size_t>(SliceScaler::map_source(frame, i).width);
+			}
+		};
+		const Timing timing = measure(settings.repeat, MIN_SAMPLE_TIME, map);
+		add("slice", fixture.input.name, "map_source", timing, fixture.frame_pixels(), std::format(R"(,"checksum":{})", checksum % 1000));
+	}
+
+	// 调色板：五个切片合并统计直方图后中位切分，即逐帧调色板模式每帧的开销
+	void PipelineBenchmark::bench_palette(const Settings &settings, Fixture &fixture)
+	{
+		ColorHistogram histogram;
+		Palette		   palette;
+		auto		   build = [&]
+		{
+			histogram.clear();
+			for (const AVFrame *slice: fixture.slices[fixture.advance()])
+			{
+				histogram.add(slice->data[0], slice->linesize[0], slice->width, slice->height);
+			}
+			palette = histogram.build_palette(256);
+		};
+		add("palette", fixture.input.name, "histogram+median_cut", measure(settings.repeat, MIN_SAMPLE_TIME, build), fixture.slice_pixels());
+	}
+
+	// 量化：当前 CPU 支持的每个内核（无抖动），以及最快内核下的各抖动方式
+	void PipelineBenchmark::bench_quantize(const Settings &settings, Fixture &fixture)
+	{
+		const CpuFeatures			  &cpu	   = cpu_features();
+		std::vector<Quantizer::Kernel> kernels = {Quantizer::Kernel::Scalar};
+		if (SSG_ARCH_X86 && cpu.sse41)
+		{
+			kernels.push_back(Quantizer::Kernel::Sse41);
+		}
+		if (SSG_ARCH_X86 && cpu.avx2)
+		{
+			kernels.push_back(Quantizer::Kernel::Avx2);
+		}
+		if (SSG_ARCH_X86 && cpu.avx512)
+		{
+			kernels.push_back(Quantizer::Kernel::Avx512);
+		}
+
+		for (const auto kernel: kernels)
+		{
+			Quantizer quantizer(kernel);
+			quantizer.set_palette(fixture.palette);
+			const Timing timing = measure(settings.repeat, MIN_SAMPLE_TIME, [&] { map_slices(fixture, quantizer, fixture.advance()); });
+			add("quantize", fixture.input.name, kernel_name(kernel), timing, fixture.slice_pixels());
+		}
+
+		static constexpr std::array<std::pair<DitherMode, std::string_view>, 4> dither_modes = {
+			{{DitherMode::None, "none"}, {DitherMode::Bayer, "bayer"}, {DitherMode::FloydSteinberg, "floyd_steinberg"}, {DitherMode::BlueNoise, "blue_noise"}}};
+		for (const auto &[mode, name]: dither_modes)
+		{
+			Quantizer quantizer;
+			quantizer.set_palette(fixture.palette);
+			quantizer.set_dither(mode);
+			const Timing timing = measure(settings.repeat, MIN_SAMPLE_TIME, [&] { map_slices(fixture, quantizer, fixture.advance()); });
+			add("dither", fixture.input.name, name, timing, fixture.slice_pixels());
+		}
+
+		// 抖动基准覆盖了索引，恢复为无抖动的量化结果供 LZW 基准使用
+		Quantizer quantizer;
+		quantizer.set_palette(fixture.palette);
+		for (int f = 0; f < RING_FRAMES; ++f)
+		{
+			map_slices(fixture, quantizer, f);
+		}
+	}
+
+	// LZW：五个切片整帧索引的无损与有损压缩
+	void PipelineBenchmark::bench_lzw(const Settings &settings, Fixture &fixture)
+	{
+		LzwEncoder			 lzw;
+		std::vector<uint8_t> out;
+		for (const bool lossy: {false, true})
+		{
+			std::size_t bytes	 = 0;
+			auto		compress = [&]
+			{
+				out.clear();
+				for (const auto &indices: fixture.indices[fixture.advance()])
+				{
+					if (lossy)
+					{
+						lzw.encode_lossy(indices.data(), indices.size(), 8, fixture.palette.colors.data(), -1, LOSSY_ERROR, out);
+					}
+					else
+					{
+						lzw.encode(indices.data(), indices.size(), 8, out);
+					}
+				}
+				bytes = out.size();
+			};
+			const Timing timing	 = measure(settings.repeat, MIN_SAMPLE_TIME, compress);
+			const auto	 variant = lossy ? std::format("lossy_{}", LOSSY_ERROR) : std::string("lossless");
+			add("lzw", fixture.input.name, variant, timing, fixture.slice_pixels(), std::format(R"(,"bytes":{})", bytes));
+		}
+	}
+
+	void PipelineBenchmark::bench_video(const Settings &settings, const Input &input, const std::filesystem::path &video)
+	{
+		const double frame_px = static_cast<double>(input.width) * input.height;
+
+		// 解码：打开文件并顺序解码全部帧，按帧平均
+		AVFrame *frame		 = av_frame_alloc();
+		int		 decoded	 = 0;
+		auto	 decode_file = [&]
+		{
+			VideoDecoder decoder;
+			decoded = 0;
+			if (decoder.open(video, DecoderOptions{}))
+			{
+				while (decoder.decode_next(frame))
+				{
+					++decoded;
+				}
+			}
+		};
+		Timing decode = measure(settings.repeat, std::chrono::nanoseconds(0), decode_file);
+		av_frame_free(&frame);
+		if (decoded > 0)
+		{
+			decode.median_ns /= decoded;
+			decode.min_ns /= decoded;
+			add("decode", input.name, "mpeg4", decode, frame_px, std::format(R"(,"frames":{})", decoded));
+		}
+
+		// 完整任务：经 submit() 进入 run_internal，每个质量档位各自解码、缩放、量化、编码并写出切片
+		ShowcaseProcessor processor;
+		for (int q = 0; q < QUALITY_MODES; ++q)
+		{
+			TaskOptions options;
+			options.quality_mode = q;
+			options.frame_cache	 = false;
+
+			const auto out_dir = settings.work_dir / std::format("out_{}_q{}", input.name, q);
+			bool	   ok	   = true;
+			auto	   run_job = [&] { ok = processor.submit(video, out_dir, options, {}).result().get() && ok; };
+			const auto timing  = measure(settings.repeat, std::chrono::nanoseconds(0), run_job);
+
+			std::size_t bytes = 0;
+			for (int i = 1; i <= SLICE_COUNT; ++i)
+			{
+				std::error_code ec;
+				const auto		size = std::filesystem::file_size(out_dir / std::format("slice_{}.gif", i), ec);
+				bytes += ec ? 0 : static_cast<std::size_t>(size);
+			}
+			const double fps   = settings.frames / (timing.median_ns / 1e9);
+			const auto	 extra = std::format(R"(,"ok":{},"fps":{:.2f},"bytes":{})", ok, fps, bytes);
+			add("full", input.name, std::format("q{}", q), timing, frame_px * settings.frames, extra);
+		}
+	}
+} // namespace SteamShowcaseGen
+
+int main(int argc, char *argv[])
+{
+	return SteamShowcaseGen::PipelineBenchmark::run(argc, argv);
+}
@@ -23,12 +23,19 @@ namespace SteamShowcaseGen::AppText
 	inline constexpr std::string_view PLACEHOLDER_SRC = "源文件目录路径";
 	inline constexpr std::string_view BTN_SCAN		  = "扫描";
 	inline constexpr std::string_view LABEL_FILE_LIST = " 文件列表";
+	inline constexpr std::string_view LABEL_BATCH	  = " 批量处理";
+	inline constexpr std::string_view BATCH_ALL		  = "处理列表中的全部文件 (各自输出到子目录)";
 
 	// 主页输出区
-	inline constexpr std::string_view LABEL_DIR_OUT	  = " 输出路径";
-	inline constexpr std::string_view PLACEHOLDER_OUT = "输出保存路径";
-	inline constexpr std::string_view LABEL_SAMPLING  = " 帧采样率";
-	inline constexpr std::string_view LABEL_QUALITY	  = " 缩放质量";
+	inline constexpr std::string_view LABEL_DIR_OUT		 = " 输出路径";
+	inline constexpr std::string_view PLACEHOLDER_OUT	 = "输出保存路径";
+	inline constexpr std::string_view LABEL_SAMPLING	 = " 帧采样率";
+	inline constexpr std::string_view LABEL_QUALITY		 = " 缩放质量";
+	inline constexpr std::string_view LABEL_DITHER		 = " 抖动方式";
+	inline constexpr std::string_view LABEL_TARGET		 = " 体积上限";
+	inline constexpr std::string_view PLACEHOLDER_TARGET = "KB, 留空表示不限制";
+	inline constexpr std::string_view ESTIMATE_PENDING	 = "预估中...";
+	inline constexpr std::string_view ESTIMATE_RESULT	 = "约 {} KB/片";
 
 	inline constexpr std::string_view BTN_OPEN = "打开";
 
@@ -36,26 +43,67 @@ namespace SteamShowcaseGen::AppText
 	inline constexpr std::string_view QUALITY_MEDIUM = "均衡 - 双线性插值";
 	inline constexpr std::string_view QUALITY_HIGH	 = "质量 - 双三次插值";
 	inline constexpr std::string_view QUALITY_BEST	 = "最佳 - 兰索斯插值";
+	inline constexpr std::string_view QUALITY_LOSSY	 = "压缩 - 有损 LZW (双三次插值)";
+
+	inline constexpr std::string_view DITHER_NONE		= "关闭 - 最近色映射";
+	inline constexpr std::string_view DITHER_BAYER		= "有序 - Bayer 矩阵";
+	inline constexpr std::string_view DITHER_DIFFUSION	= "扩散 - Floyd-Steinberg";
+	inline constexpr std::string_view DITHER_BLUE_NOISE = "蓝噪 - 无纹理有序抖动";
 
 	// 运行状态与日志
 	inline constexpr std::string_view BTN_START		 = "开始生成";
 	inline constexpr std::string_view BTN_PROCESSING = "生成中";
 
-	inline constexpr std::string_view LOG_READY		= "就绪";
-	inline constexpr std::string_view LOG_SCANNING	= "正在扫描...";
-	inline constexpr std::string_view LOG_SCAN_DONE = "扫描完成，发现 {} 个文件";
-	inline constexpr std::string_view LOG_STARTING	= "启动处理任务...";
-	inline constexpr std::string_view LOG_ENCODING	= "正在编码... 已处理帧数: ";
-	inline constexpr std::string_view LOG_FINISHED	= "任务完成! 输出目录: ";
-	inline constexpr std::string_view LOG_HEX_HACK	= "应用 Hex Hack...";
-
-	inline constexpr std::string_view ERR_NO_FILE	  = "错误: 请先选择有效文件";
-	inline constexpr std::string_view ERR_DIR_INVALID = "目录不存在";
-	inline constexpr std::string_view ERR_OPEN_FAILED = "错误: 无法打开文件";
+	inline constexpr std::string_view LOG_READY			 = "就绪";
+	inline constexpr std::string_view LOG_SCANNING		 = "正在扫描...";
+	inline constexpr std::string_view LOG_SCAN_DONE		 = "扫描完成，发现 {} 个文件";
+	inline constexpr std::string_view LOG_STARTING		 = "启动处理任务...";
+	inline constexpr std::string_view LOG_ENCODING		 = "正在编码... 已处理帧数: ";
+	inline constexpr std::string_view LOG_FINISHED		 = "任务完成! 输出目录: ";
+	inline constexpr std::string_view LOG_MERGED		 = " (合并重复帧 {} 个)";
+	inline constexpr std::string_view LOG_RATE_PASS		 = "体积控制 第 {} 轮: 最大切片 {} KB (降帧 1/{}, {} 色, 有损 {})";
+	inline constexpr std::string_view LOG_RATE_OVER		 = " (未能压缩到体积上限以内，已输出最小结果)";
+	inline constexpr std::string_view LOG_HEX_HACK		 = "应用 Hex Hack...";
+	inline constexpr std::string_view LOG_BATCH_FINISHED = "批量处理完成: 成功 {} 个, 失败 {} 个, 输出目录: ";
+
+	inline constexpr std::string_view ERR_NO_FILE	   = "错误: 请先选择有效文件";
+	inline constexpr std::string_view ERR_DIR_INVALID  = "目录不存在";
+	inline constexpr std::string_view ERR_OPEN_FAILED  = "错误: 无法打开文件";
+	inline constexpr std::string_view ERR_CACHE_FAILED = "错误: 无法写入帧缓存 (内存或临时目录空间不足)";
+	inline constexpr std::string_view ERR_SCALE_FAILED = "错误: 切片缩放失败";
+	inline constexpr std::string_view ERR_NO_FRAMES	   = "错误: 未能解码出任何帧";
+	inline constexpr std::string_view ERR_WRITE_FAILED = "错误: 无法写出切片文件: ";
 
 	inline constexpr std::string_view TAG_NO_FILE	  = "<无文件>";
 	inline constexpr std::string_view TAG_INVALID_DIR = "<无效目录>";
 
+	// 命令行模式
+	inline constexpr std::string_view CLI_USAGE = R"(用法: SS-G-cli [选项] <输入>...
+      SS-G [选项] <输入>...    (终端界面程序带参数启动时同样以命令行模式运行)
+进度以 JSON Lines 逐行输出到标准输出。
+
+输入可以是文件、目录 (处理其中全部支持的文件) 或文件名中带 * ? 通配符的路径。
+只有一个输入文件时直接输出到输出目录；多个文件以批量模式并发处理，各自输出到以文件名命名的子目录。
+
+选项:
+  -o, --output <目录>     输出目录 (默认 output)
+  -s, --sampling <1-10>   帧采样率，10 表示保留全部帧 (默认 10)
+  -q, --quality <0-4>     质量档位: 0 最近邻, 1 双线性, 2 双三次, 3 兰索斯, 4 有损 LZW (默认 2)
+  -d, --dither <0-3>      抖动方式: 0 关闭, 1 Bayer, 2 Floyd-Steinberg, 3 蓝噪声 (默认 0)
+  -t, --target-kb <KB>    每个切片的体积上限，0 表示不限制 (默认 0)
+  -j, --threads <N>       线程总数 (调度器与解码线程合计)，0 表示按 CPU 核心数 (默认 0)
+  -h, --help              显示本帮助
+
+退出码: 0 全部成功, 1 处理失败, 2 参数错误, 130 被中断
+)";
+
+	inline constexpr std::string_view ERR_CLI_UNKNOWN_OPTION = "未知选项: ";
+	inline constexpr std::string_view ERR_CLI_MISSING_VALUE	 = "缺少参数值: ";
+	inline constexpr std::string_view ERR_CLI_INVALID_VALUE	 = "参数值无效: ";
+	inline constexpr std::string_view ERR_CLI_NO_INPUT		 = "未指定输入文件";
+	inline constexpr std::string_view ERR_CLI_INPUT_MISSING	 = "找不到支持的输入文件: ";
+	inline constexpr std::string_view ERR_CLI_OUTPUT_DIR	 = "无法创建输出目录: ";
+
 	// 关于页
 	inline constexpr std::string_view LABEL_VERSION = " Version : ";
 	inline constexpr std::string_view LABEL_REPO	= " Repo : ";
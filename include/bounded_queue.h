@@ -0,0 +1,92 @@
+/**
+ * @file bounded_queue.h
+ * @brief 固定容量的阻塞环形队列，用于处理流水线各阶段之间的数据传递
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_BOUNDED_QUEUE_H
+#define STEAM_SHOWCASE_GEN_BOUNDED_QUEUE_H
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class BoundedQueue
+	 * @brief 多生产者/多消费者的有界队列
+	 *
+	 * 队列满时 push 阻塞（背压），队列空时 pop 阻塞。
+	 * close() 之后 push 立即失败，pop 取完剩余元素后返回 std::nullopt。
+	 */
+	template <typename T, std::size_t Capacity>
+	class BoundedQueue
+	{
+		static_assert(Capacity > 0, "BoundedQueue capacity must be positive");
+
+	public:
+		BoundedQueue() = default;
+
+		BoundedQueue(const BoundedQueue &)			  = delete;
+		BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+		/** @brief 写入一个元素，队列已满时阻塞；队列关闭后返回 false */
+		bool push(T value)
+		{
+			std::unique_lock lock(mutex_);
+			not_full_.wait(lock, [this] { return closed_ || size_ < Capacity; });
+			if (closed_)
+			{
+				return false;
+			}
+
+			items_[(head_ + size_) % Capacity] = std::move(value);
+			++size_;
+			lock.unlock();
+			not_empty_.notify_one();
+			return true;
+		}
+
+		/** @brief 取出一个元素，队列为空时阻塞；队列关闭且已取空时返回 std::nullopt */
+		std::optional<T> pop()
+		{
+			std::unique_lock lock(mutex_);
+			not_empty_.wait(lock, [this] { return closed_ || size_ > 0; });
+			if (size_ == 0)
+			{
+				return std::nullopt;
+			}
+
+			std::optional<T> value(std::move(items_[head_]));
+			head_ = (head_ + 1) % Capacity;
+			--size_;
+			lock.unlock();
+			not_full_.notify_one();
+			return value;
+		}
+
+		/** @brief 关闭队列并唤醒所有等待方 */
+		void close()
+		{
+			{
+				std::lock_guard lock(mutex_);
+				closed_ = true;
+			}
+			not_full_.notify_all();
+			not_empty_.notify_all();
+		}
+
+	private:
+		std::mutex				mutex_;
+		std::condition_variable not_full_;
+		std::condition_variable not_empty_;
+		std::array<T, Capacity> items_{};
+		std::size_t				head_	= 0;
+		std::size_t				size_	= 0;
+		bool					closed_ = false;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_BOUNDED_QUEUE_H
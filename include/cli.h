@@ -0,0 +1,28 @@
+/**
+ * @file cli.h
+ * @brief 无界面的命令行模式：供脚本、构建机与无终端的远程会话调用
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_CLI_H
+#define STEAM_SHOWCASE_GEN_CLI_H
+
+namespace SteamShowcaseGen::Cli
+{
+	// 进程退出码
+	inline constexpr int EXIT_OK		  = 0;	 // 全部文件处理成功
+	inline constexpr int EXIT_FAILED	  = 1;	 // 有文件处理失败，或输出目录不可用
+	inline constexpr int EXIT_USAGE		  = 2;	 // 参数错误或找不到输入
+	inline constexpr int EXIT_INTERRUPTED = 130; // 收到中断信号后取消
+
+	/**
+	 * @brief 解析命令行参数并同步执行处理任务，全程不初始化 FTXUI
+	 *
+	 * 进度与日志以 JSON Lines 写到标准输出，每行一个事件对象，"event" 字段为
+	 * start / log / progress / done 之一；参数错误写到标准错误。
+	 * @return 进程退出码
+	 */
+	int Run(int argc, char *argv[]);
+
+} // namespace SteamShowcaseGen::Cli
+
+#endif // STEAM_SHOWCASE_GEN_CLI_H
@@ -0,0 +1,32 @@
+/**
+ * @file cpu_features.h
+ * @brief 运行时 CPU 特性检测，用于 SIMD 内核分派
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_CPU_FEATURES_H
+#define STEAM_SHOWCASE_GEN_CPU_FEATURES_H
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SSG_ARCH_X86 1
+#else
+#define SSG_ARCH_X86 0
+#endif
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct CpuFeatures
+	 * @brief 当前 CPU 及操作系统均支持的指令集扩展
+	 */
+	struct CpuFeatures
+	{
+		bool sse41	= false;
+		bool avx2	= false;
+		bool avx512 = false; // AVX-512 F + BW
+	};
+
+	/** @brief 首次调用时检测，之后返回缓存结果 */
+	const CpuFeatures &cpu_features();
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_CPU_FEATURES_H
@@ -0,0 +1,29 @@
+/**
+ * @file delta_kernels.h
+ * @brief 帧间增量比较内核声明
+ *
+ * 与量化内核相同，SIMD 实现位于以对应指令集单独编译的编译单元中，
+ * 这些编译单元只应包含本头文件与 intrinsics 头文件。
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_DELTA_KERNELS_H
+#define STEAM_SHOWCASE_GEN_DELTA_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SteamShowcaseGen::DeltaKernels
+{
+	/**
+	 * 逐行增量内核：按调色板展开 width 个索引的显示颜色并与画布逐像素比较。
+	 * 颜色未变化的像素改写为 transparent，画布更新为本行的显示颜色。
+	 * 返回本行第一个变化像素的位置，无变化时返回 -1；*last 输出最后一个变化像素的位置。
+	 * SIMD 内核的剩余像素交给 mark_row_scalar 处理。
+	 */
+	using MarkRow = int (*)(uint8_t *indices, int width, const uint32_t *palette, uint8_t transparent, uint32_t *canvas, int *last);
+
+	int mark_row_scalar(uint8_t *indices, int width, const uint32_t *palette, uint8_t transparent, uint32_t *canvas, int *last);
+	int mark_row_avx2(uint8_t *indices, int width, const uint32_t *palette, uint8_t transparent, uint32_t *canvas, int *last);
+} // namespace SteamShowcaseGen::DeltaKernels
+
+#endif // STEAM_SHOWCASE_GEN_DELTA_KERNELS_H
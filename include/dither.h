@@ -0,0 +1,32 @@
+/**
+ * @file dither.h
+ * @brief 抖动模式与有序抖动所用的阈值矩阵
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_DITHER_H
+#define STEAM_SHOWCASE_GEN_DITHER_H
+
+#include <cstdint>
+#include <vector>
+#include "task_options.h"
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct ThresholdMatrix
+	 * @brief size x size 的有序抖动阈值矩阵，ranks 中为 [0, size * size) 的排列
+	 */
+	struct ThresholdMatrix
+	{
+		int					  size = 0;
+		std::vector<uint16_t> ranks;
+	};
+
+	/** @brief 8x8 Bayer 矩阵 */
+	const ThresholdMatrix &bayer_matrix();
+
+	/** @brief 64x64 蓝噪声矩阵（void-and-cluster 算法），首次调用时生成 */
+	const ThresholdMatrix &blue_noise_matrix();
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_DITHER_H
@@ -0,0 +1,186 @@
+/**
+ * @file encode_stage.h
+ * @brief 解码流水线的后半段：帧槽、逐帧调色板量化与各切片的编码（去重、帧间增量与写出）
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_ENCODE_STAGE_H
+#define STEAM_SHOWCASE_GEN_ENCODE_STAGE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <vector>
+#include "bounded_queue.h"
+#include "encoder_pool.h"
+#include "frame_pool.h"
+#include "palette.h"
+#include "quantizer.h"
+#include "slice_scaler.h"
+#include "task_options.h"
+#include "thread_pool.h"
+
+struct AVFrame;
+struct SwsContext;
+
+namespace SteamShowcaseGen
+{
+	class FrameDelta;
+	class DuplicateDetector;
+	struct DeltaRect;
+
+	/**
+	 * @class EncodeStage
+	 * @brief 缩放之后的流水线阶段
+	 *
+	 * 构造时一次性分配 FRAME_SLOT_COUNT 个帧槽，调用方取出空闲帧槽、写入解码帧后经 scale() 缩放（或直接写入缩放结果）再提交；
+	 * 一帧的缩放全部完成后由最后完成的任务按提交顺序交给内部的量化 Strand，不占用线程等待，
+	 * 量化之后交给各切片的 Strand 编码，全部切片编码完成后帧槽归还。
+	 * 所有阶段都在共享调度器上执行，不各自占用线程。ShowcaseProcessor 的解码流水线与分配计数测试共用本类。
+	 */
+	class EncodeStage
+	{
+	public:
+		static constexpr int		 SLICE_COUNT	  = SliceScaler::SLICE_COUNT;
+		static constexpr std::size_t FRAME_SLOT_COUNT = 6; // 同时在各阶段中流转的帧数上限
+
+		using SliceFrames  = std::array<AVFrame *, SLICE_COUNT>;
+		using SliceScalers = std::array<SwsContext *, SLICE_COUNT>;
+
+		/**
+		 * @struct FrameSlot
+		 * @brief 流水线帧槽，各阶段之间只传递指针
+		 */
+		struct FrameSlot
+		{
+			AVFrame			 *frame		  = nullptr; // 解码输出，直接引用解码器的缓冲区
+			SliceFrames		  scaled{};				 // 缩放后的 BGRA 切片
+			SliceFrames		  quantized{};			 // 调色板量化后的 PAL8 切片，由对应切片的编码任务消费
+			SliceScalers	  sws{};				 // 本帧槽各切片独占的缩放上下文，多帧同时缩放时互不共享
+			int64_t			  pts		  = 0;		 // 输出时间戳（厘秒）
+			int				  transparent = -1;		 // 调色板中预留的透明色索引，-1 表示不做帧间增量
+			int				  colors	  = 0;		 // 调色板有效项数（含透明色）
+			std::atomic<int>  scaling{0};			 // 未完成的缩放切片数，另加 submit() 持有的一份；归零时本帧可以量化
+			std::atomic<bool> scale_failed{false};	 // 有切片缩放失败，缩放平面中仍是上一帧的内容
+			std::atomic<int>  pending{0};			 // 尚未完成编码的切片数
+		};
+
+		/** @brief 量化前对缩放结果的附加处理（如写入帧缓存），在量化 Strand 上按帧序调用 */
+		using ScaledHook = std::move_only_function<void(const FrameSlot &)>;
+
+		/**
+		 * @param encoders       各切片已打开的编码状态，须比本对象存活更久
+		 * @param quantizer      全局调色板模式下已设置好调色板的量化器，逐帧模式下每帧重设
+		 * @param palette_mode   实际使用的调色板模式
+		 * @param palette_colors 调色板颜色数上限（不含透明色）
+		 */
+		EncodeStage(ThreadPool				  &pool,
+					std::vector<EncoderState> &encoders,
+					int						   height,
+					const TaskOptions		  &options,
+					Quantizer				  &quantizer,
+					PaletteMode				   palette_mode,
+					int						   palette_colors,
+					const std::stop_token	  &stop,
+					ScaledHook				   on_scaled = {});
+		~EncodeStage();
+
+		EncodeStage(const EncodeStage &)			= delete;
+		EncodeStage &operator=(const EncodeStage &) = delete;
+
+		/** @brief 帧槽是否全部分配成功 */
+		[[nodiscard]] bool ready() const
+		{
+			return ready_;
+		}
+
+		/** @brief 取出一个空闲帧槽，全部帧槽都在途时阻塞 */
+		FrameSlot *acquire();
+
+		/**
+		 * @brief 将 slot.frame 的五个切片作为任务交给调度器并行缩放，写入 slot.scaled
+		 *
+		 * 任务提交后立即返回，随后可直接 submit()。各任务只使用本帧槽的缩放上下文，不同帧槽的缩放可以同时进行；
+		 * 缩放算法取自构造时的 TaskOptions::quality_mode。有切片缩放失败时该帧不再量化与编码，之后的帧一律丢弃，failed() 返回 true。
+		 */
+		void scale(FrameSlot &slot);
+
+		/**
+		 * @brief 提交一个帧槽：缩放全部完成后按提交顺序量化，再交给各切片编码；停止请求后不再处理，直接归还
+		 *
+		 * 调用时缩放尚未完成也不等待，由最后完成的缩放任务将本帧（及其后已缩放完成的帧）交给量化 Strand。
+		 */
+		void submit(FrameSlot &slot);
+
+		/** @brief 等待已提交的帧全部编码完毕；不可在调度器的工作线程中调用 */
+		void wait_idle();
+
+		/** @brief 是否有帧因缩放失败被丢弃；此后提交的帧都不再编码，调用方应放弃本次输出 */
+		[[nodiscard]] bool failed() const
+		{
+			return failed_.load();
+		}
+
+		/** @brief 各切片因重复而未编码的帧数之和 */
+		[[nodiscard]] int merged_frames() const;
+
+		/** @brief 量化 scaled 中的五个切片并写入 quantized 的索引与调色板平面，返回预留的透明色索引（-1 表示未预留） */
+		static int quantize_slices(const SliceFrames &scaled,
+								   const SliceFrames &quantized,
+								   PaletteMode		  mode,
+								   int				  max_colors,
+								   bool				  reserve_transparent,
+								   ColorHistogram	 &histogram,
+								   Quantizer		 &quantizer);
+
+		/** @brief 处理一个切片的一帧：重复帧只计数，其余帧做帧间增量后送入编码器；返回是否实际输出 */
+		static bool encode_slice_frame(EncoderState		 &state,
+									   FrameDelta		 &delta,
+									   DuplicateDetector &dedup,
+									   const AVFrame	 *scaled,
+									   AVFrame			 *quantized,
+									   int64_t			  pts,
+									   int				  colors,
+									   int				  transparent);
+
+		/** @brief 将 raw_frame 送入 libavcodec 编码器并写出得到的数据包，nullptr 表示冲刷 */
+		static void encode_raw_frame(EncoderState &state, const AVFrame *raw_frame);
+
+	private:
+		struct SliceEncoder;
+
+		static void push_frame(EncoderState &state, AVFrame *quantized, int64_t pts, const DeltaRect &rect, int colors, int transparent);
+
+		void quantize(FrameSlot &slot);
+		void scale_slice(int task);
+		void dispatch_scaled();
+
+		ThreadPool								   &pool_;
+		Quantizer								   &quantizer_;
+		const PaletteMode							palette_mode_;
+		const int									palette_colors_;
+		const bool									reserve_transparent_;
+		const int									sws_flags_;		  // scale() 使用的缩放算法标志
+		const std::stop_token					   &stop_;
+		ScaledHook									on_scaled_;
+		ColorHistogram								histogram_;		  // 逐帧模式的直方图，只在量化 Strand 上使用
+		FramePool									frame_pool_;
+		std::array<FrameSlot, FRAME_SLOT_COUNT>		slots_;
+		BoundedQueue<FrameSlot *, FRAME_SLOT_COUNT>	free_queue_;
+		bool										ready_		 = false;
+		std::atomic<bool>							failed_{false};	  // 有帧缩放失败
+		std::mutex									order_mutex_;
+		std::array<FrameSlot *, FRAME_SLOT_COUNT>	order_{};		  // 已提交、按提交顺序等待量化的帧槽，受 order_mutex_ 保护
+		std::size_t									order_head_	 = 0;
+		std::size_t									order_count_ = 0;
+		std::atomic<int>							scale_tasks_{0};  // 尚未返回的缩放任务数，wait_idle() 先等待其归零
+		std::vector<std::unique_ptr<SliceEncoder>>	slice_encoders_;
+		Strand										quantize_strand_; // 最后声明：析构时先等待量化任务，之后才不再有新的编码任务
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_ENCODE_STAGE_H
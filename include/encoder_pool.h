@@ -0,0 +1,110 @@
+/**
+ * @file encoder_pool.h
+ * @brief 切片编码状态（RAII）与跨任务复用的预热状态池
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_ENCODER_POOL_H
+#define STEAM_SHOWCASE_GEN_ENCODER_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "gif_writer.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVStream;
+struct AVPacket;
+struct AVFrame;
+struct SwsContext;
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct EncoderState
+	 * @brief 单个切片的编码状态，析构时释放其持有的全部 FFmpeg 资源
+	 *
+	 * 编码器与封装上下文属于单个任务，由 ShowcaseProcessor::finish_encoder 写尾后释放；
+	 * 缩放上下文、编码输出包、送入编码器的帧与自研写出器（连同其缓冲区）在任务之间保留，reset() 后可直接复用。
+	 */
+	struct EncoderState
+	{
+		AVFormatContext			  *fmt_ctx	   = nullptr;
+		AVCodecContext			  *codec_ctx   = nullptr;
+		AVStream				  *stream	   = nullptr;
+		AVPacket				  *packet	   = nullptr; // 复用的编码输出包，首次使用时分配
+		std::array<AVFrame *, 2>   send_frames{};		  // libavcodec 后端交替送入编码器的帧，首次使用时分配
+		std::unique_ptr<GifWriter> native;			 // 自研后端的写出器，未打开时表示使用 libavcodec 后端
+		SwsContext				  *sws_ctx	   = nullptr;
+		int						   sws_flags   = 0;
+		int						   frame_count = 0;
+		int64_t					   last_pts	   = -1; // 最近一次输出帧的时间戳（厘秒）
+		int						   final_delay = -1; // 最后一帧的显示时长（厘秒），-1 表示沿用上一帧的延迟
+
+		EncoderState() = default;
+		~EncoderState();
+
+		EncoderState(EncoderState &&other) noexcept;
+		EncoderState &operator=(EncoderState &&other) noexcept;
+		EncoderState(const EncoderState &)			  = delete;
+		EncoderState &operator=(const EncoderState &) = delete;
+
+		/** @brief 是否使用自研写出器输出 */
+		[[nodiscard]] bool uses_native() const
+		{
+			return native && native->is_open();
+		}
+
+		/** @brief 清除任务相关的状态，保留可复用的上下文与缓冲区 */
+		void reset();
+
+		/** @brief 释放编码器与封装上下文（不写文件尾） */
+		void release_codec();
+
+	private:
+		void swap(EncoderState &other) noexcept;
+	};
+
+	/**
+	 * @class EncoderPool
+	 * @brief 预热的切片编码状态池，线程安全
+	 *
+	 * 以（宽、高、缩放算法）为键保存任务结束后的编码状态。下一个任务取回同键的状态时，
+	 * 源尺寸不变则 sws_getCachedContext 直接沿用原缩放上下文，编码输出包与写出器的缓冲区也无需重新分配。
+	 */
+	class EncoderPool
+	{
+	public:
+		static constexpr std::size_t MAX_IDLE = 16; // 最多保留的空闲状态数
+
+		struct Key
+		{
+			int width	  = 0;
+			int height	  = 0;
+			int sws_flags = 0;
+
+			bool operator==(const Key &) const = default;
+		};
+
+		/** @brief 取出 count 个状态：优先复用同键的空闲状态，不足的部分新建 */
+		std::vector<EncoderState> acquire(const Key &key, std::size_t count);
+
+		/** @brief 归还状态以备复用，空闲状态超过 MAX_IDLE 个时丢弃最早归还的 */
+		void release(const Key &key, std::vector<EncoderState> &&states);
+
+	private:
+		struct Idle
+		{
+			Key			 key;
+			EncoderState state;
+		};
+
+		std::mutex		  mutex_;
+		std::vector<Idle> idle_;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_ENCODER_POOL_H
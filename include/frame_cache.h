@@ -0,0 +1,111 @@
+/**
+ * @file frame_cache.h
+ * @brief 定长帧的追加式缓存，内存预算用尽后溢出到内存映射的临时文件
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_FRAME_CACHE_H
+#define STEAM_SHOWCASE_GEN_FRAME_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct FrameCacheKey
+	 * @brief 决定缓存内容的全部输入：源文件（路径与修改时间）以及影响解码、缩放结果的参数
+	 */
+	struct FrameCacheKey
+	{
+		std::filesystem::path path;
+		int64_t				  mtime		 = 0; // 文件修改时间（file_clock 计数）
+		int					  height	 = 0;
+		int					  sws_flags	 = 0;
+		double				  frame_rate = 0.0; // 采样帧率
+		int					  max_frames = 0;
+
+		bool operator==(const FrameCacheKey &) const = default;
+
+		/** @brief 读取源文件的修改时间生成键，无法读取时 mtime 为 0 */
+		static FrameCacheKey of(const std::filesystem::path &path, int height, int sws_flags, double frame_rate, int max_frames);
+	};
+
+	/**
+	 * @class FrameCache
+	 * @brief 每帧 frame_bytes 字节、起始地址按 ALIGNMENT 对齐的帧存储
+	 *
+	 * 内存预算以内的帧放在堆上的大块内存中：reset() 按预计帧数一次分配，不足时再按块追加，
+	 * 追加一帧通常不发生堆分配；超出预算的部分写入临时文件并整体映射到内存，对调用方透明，
+	 * 临时文件在缓存释放时删除。追加过程中映射可能扩容重映射，已取得的溢出帧指针随之失效，
+	 * 追加结束后各帧地址保持不变。非线程安全。
+	 */
+	class FrameCache
+	{
+	public:
+		static constexpr std::size_t ALIGNMENT			   = 64;
+		static constexpr std::size_t DEFAULT_MEMORY_BUDGET = std::size_t{512} << 20;
+
+		explicit FrameCache(std::size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+		~FrameCache();
+
+		FrameCache(const FrameCache &)			  = delete;
+		FrameCache &operator=(const FrameCache &) = delete;
+
+		/** @brief 清空缓存并设置帧大小；expected_frames 为预计帧数，用于确定溢出文件的初始容量 */
+		void reset(std::size_t frame_bytes, std::size_t expected_frames = 0);
+
+		/** @brief 追加一帧并返回其存储（内容未初始化），分配或映射失败时返回 nullptr */
+		uint8_t *append();
+
+		/** @brief 移除最后一帧 */
+		void pop_back();
+
+		[[nodiscard]] uint8_t *frame(std::size_t index) const;
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return memory_count_ + spill_count_;
+		}
+
+		[[nodiscard]] std::size_t frame_bytes() const
+		{
+			return frame_bytes_;
+		}
+
+		/** @brief 是否已有帧溢出到临时文件 */
+		[[nodiscard]] bool spilled() const
+		{
+			return spill_count_ > 0;
+		}
+
+	private:
+		static constexpr std::size_t MIN_CHUNK_FRAMES = 16;
+
+		struct SpillFile;
+		struct AlignedDelete
+		{
+			void operator()(uint8_t *p) const;
+		};
+		struct Chunk
+		{
+			std::unique_ptr<uint8_t[], AlignedDelete> data;
+			std::size_t								  frames = 0;
+		};
+
+		bool add_chunk(std::size_t frames);
+
+		std::size_t				   memory_budget_;
+		std::size_t				   frame_bytes_		= 0;
+		std::size_t				   expected_frames_ = 0;
+		std::vector<Chunk>		   chunks_;
+		std::size_t				   memory_capacity_ = 0; // 各内存块可容纳的总帧数
+		std::size_t				   memory_count_	= 0; // 已使用的内存帧数
+		std::unique_ptr<SpillFile> spill_;
+		std::size_t				   spill_count_ = 0;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_FRAME_CACHE_H
@@ -0,0 +1,66 @@
+/**
+ * @file frame_dedup.h
+ * @brief 重复帧检测：与上一次输出的帧相同（或足够接近）的帧不再编码，由上一帧延长显示
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_FRAME_DEDUP_H
+#define STEAM_SHOWCASE_GEN_FRAME_DEDUP_H
+
+#include <cstdint>
+#include <vector>
+#include "task_options.h"
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class DuplicateDetector
+	 * @brief 单个切片的重复帧检测器
+	 *
+	 * 参照帧始终是上一次实际输出的帧，而不是上一次输入的帧：
+	 * 缓慢渐变的画面在累计差异超过阈值后必然会输出新帧，误差不会无限累积。
+	 */
+	class DuplicateDetector
+	{
+	public:
+		static constexpr int BLOCK_SIZE = 16;
+
+		/** @param threshold 感知模式下每块允许的平均通道差（0-255） */
+		DuplicateDetector(DedupMode mode, int threshold);
+
+		/**
+		 * @brief 判断一帧是否与参照帧重复；不重复时以该帧作为新的参照
+		 * @param bgra 缩放后的 BGRA 切片（感知模式使用）
+		 * @param indices 量化后的 PAL8 索引（精确模式使用，须在帧间增量改写之前传入）
+		 * @param palette 256 项调色板（精确模式使用）
+		 */
+		bool is_duplicate(const uint8_t	*bgra,
+						  int			 bgra_stride,
+						  const uint8_t	*indices,
+						  int			 index_stride,
+						  const uint32_t *palette,
+						  int			 width,
+						  int			 height);
+
+		[[nodiscard]] int skipped() const
+		{
+			return skipped_;
+		}
+
+	private:
+		[[nodiscard]] bool same_exact(const uint8_t *indices, int index_stride, const uint32_t *palette) const;
+		[[nodiscard]] bool same_perceptual(const uint8_t *bgra, int bgra_stride);
+		void			   remember(const uint8_t *bgra, int bgra_stride, const uint8_t *indices, int index_stride, const uint32_t *palette);
+
+		DedupMode			  mode_;
+		int					  threshold_;
+		int					  width_   = 0;
+		int					  height_  = 0;
+		bool				  valid_   = false;
+		int					  skipped_ = 0;
+		std::vector<uint8_t>  reference_;  // 精确模式：索引；感知模式：BGRA 像素
+		std::vector<uint32_t> palette_;
+		std::vector<uint32_t> block_sums_; // 感知模式：当前一行块的 SAD 累加
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_FRAME_DEDUP_H
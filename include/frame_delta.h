@@ -0,0 +1,67 @@
+/**
+ * @file frame_delta.h
+ * @brief 帧间增量：将与上一帧显示结果相同的像素标记为透明，并求出变化区域
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_FRAME_DELTA_H
+#define STEAM_SHOWCASE_GEN_FRAME_DELTA_H
+
+#include <cstdint>
+#include <vector>
+#include "delta_kernels.h"
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct DeltaRect
+	 * @brief 帧内发生变化的矩形区域，width 或 height 为 0 表示整帧无变化
+	 */
+	struct DeltaRect
+	{
+		int x	   = 0;
+		int y	   = 0;
+		int width  = 0;
+		int height = 0;
+
+		[[nodiscard]] bool empty() const
+		{
+			return width <= 0 || height <= 0;
+		}
+	};
+
+	/**
+	 * @class FrameDelta
+	 * @brief 单个切片的帧间增量状态
+	 *
+	 * 维护一张“画布”，记录播放器在上一帧之后实际显示的颜色（0xAARRGGBB）。
+	 * 比较的是显示颜色而非调色板索引，因此逐帧调色板下同样有效；
+	 * 未变化的像素改写为透明色，配合“保留上一帧”的处置方式，解码结果与不做增量时逐像素一致。
+	 * 编码器只需输出变化区域这一子矩形，静态画面占比越高，LZW 的工作量与输出字节越少。
+	 */
+	class FrameDelta
+	{
+	public:
+		FrameDelta();
+
+		/** @brief 丢弃画布，下一帧将作为完整的关键帧输出 */
+		void reset();
+
+		/**
+		 * @brief 对一帧 PAL8 索引做增量处理
+		 * @param indices 索引平面，原地改写
+		 * @param palette 256 项调色板（0xAARRGGBB），transparent 项不会出现在输入索引中
+		 * @param transparent 透明色索引
+		 * @return 变化区域；首帧（或 reset 之后）为整帧
+		 */
+		DeltaRect apply(uint8_t *indices, int stride, int width, int height, const uint32_t *palette, uint8_t transparent);
+
+	private:
+		DeltaKernels::MarkRow mark_row_;
+		std::vector<uint32_t> canvas_;
+		int					  width_  = 0;
+		int					  height_ = 0;
+		bool				  valid_  = false;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_FRAME_DELTA_H
@@ -0,0 +1,70 @@
+/**
+ * @file frame_pool.h
+ * @brief 任务开始时一次性分配的帧内存池，各平面按 64 字节对齐，由 AVFrame 直接引用而无需复制
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_FRAME_POOL_H
+#define STEAM_SHOWCASE_GEN_FRAME_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct AVFrame;
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class FramePool
+	 * @brief 线性切分的帧内存池
+	 *
+	 * reserve() 按任务所需的全部帧一次性分配，acquire() 依次切出一帧并包装为 AVFrame。
+	 * AVFrame 的缓冲区引用不拥有内存（释放函数为空操作），av_frame_make_writable 等检查照常生效，
+	 * 帧平面在稳态处理中不再分配。切出的帧由调用方以 av_frame_free 释放，且须早于池析构。
+	 */
+	class FramePool
+	{
+	public:
+		static constexpr std::size_t ALIGNMENT = 64;
+
+		FramePool() = default;
+		~FramePool();
+
+		FramePool(const FramePool &)			= delete;
+		FramePool &operator=(const FramePool &) = delete;
+
+		/** @brief 一帧所需的字节数：各行按 ALIGNMENT 对齐，PAL8 等格式包含调色板平面 */
+		static std::size_t frame_bytes(int width, int height, int format);
+
+		/** @brief 分配 bytes 字节的池空间，原有空间随之释放（此前切出的帧须已释放） */
+		bool reserve(std::size_t bytes);
+
+		/** @brief 切出一帧，池空间不足时返回 nullptr */
+		AVFrame *acquire(int width, int height, int format);
+
+		/** @brief 将一块外部内存包装为 frame 的首个数据平面，缓冲区引用不拥有该内存 */
+		static bool wrap_plane(AVFrame *frame, uint8_t *data, std::size_t bytes, int stride);
+
+		[[nodiscard]] std::size_t capacity() const
+		{
+			return capacity_;
+		}
+
+		[[nodiscard]] std::size_t used() const
+		{
+			return used_;
+		}
+
+	private:
+		struct AlignedDelete
+		{
+			void operator()(uint8_t *p) const;
+		};
+
+		std::unique_ptr<uint8_t[], AlignedDelete> arena_;
+		std::size_t								  capacity_ = 0;
+		std::size_t								  used_		= 0;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_FRAME_POOL_H
@@ -0,0 +1,78 @@
+/**
+ * @file frame_resampler.h
+ * @brief 基于展示时间戳的时域重采样：按目标输出帧率选帧，并生成精确的 GIF 帧延迟
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_FRAME_RESAMPLER_H
+#define STEAM_SHOWCASE_GEN_FRAME_RESAMPLER_H
+
+#include <cstdint>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class FrameSelector
+	 * @brief 解码阶段的选帧接口，时间参数均为相对流起点的展示时间（秒）
+	 */
+	class FrameSelector
+	{
+	public:
+		virtual ~FrameSelector() = default;
+
+		/** @brief 预判：解复用后、解码前判断该时间点的帧是否可能被选中（保守，可多不可少） */
+		[[nodiscard]] virtual bool wants(double t) const = 0;
+
+		/** @brief 决定：解码输出时按展示顺序确认是否选中该帧 */
+		virtual bool accept(double t) = 0;
+	};
+
+	/**
+	 * @class FrameResampler
+	 * @brief 时域重采样器
+	 *
+	 * 将时间轴划分为长度为 1/目标帧率 的区间，每个区间选取第一个到达的帧。
+	 * 输出时间戳取被选帧自身的展示时间（以厘秒计），因此可变帧率素材的 GIF 帧延迟
+	 * 与原片节奏一致；时间戳由绝对时间取整得到，舍入误差不会随帧数累积。
+	 */
+	class FrameResampler final : public FrameSelector
+	{
+	public:
+		/** GIF 延迟的最小可靠值：多数浏览器会把小于 2cs 的延迟按 10cs 播放 */
+		static constexpr int MIN_DELAY_CS = 2;
+
+		/**
+		 * @param target_fps 目标输出帧率
+		 * @param duration 素材时长（秒），未知时为 0
+		 * @param max_frames 最大输出帧数，0 表示不限制；与 duration 一起决定最低采样间隔
+		 */
+		FrameResampler(double target_fps, double duration = 0.0, int max_frames = 0);
+
+		[[nodiscard]] bool wants(double t) const override;
+		bool			   accept(double t) override;
+
+		/** @brief 最近一次被选中帧的输出时间戳（厘秒） */
+		[[nodiscard]] int64_t last_timestamp() const
+		{
+			return last_cs_;
+		}
+
+		/** @brief 最后一帧应保持的时长（厘秒），即一个采样间隔 */
+		[[nodiscard]] int final_delay() const;
+
+		[[nodiscard]] int accepted_count() const
+		{
+			return accepted_;
+		}
+
+	private:
+		[[nodiscard]] int64_t cell_of(double t) const;
+
+		double	interval_;		   // 采样间隔（秒）
+		int		max_frames_;
+		int64_t last_cell_ = -1;   // 最近一次选中帧所在的区间编号
+		int64_t last_cs_   = -1;   // 最近一次选中帧的输出时间戳（厘秒）
+		int		accepted_  = 0;
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_FRAME_RESAMPLER_H
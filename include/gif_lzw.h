@@ -0,0 +1,85 @@
+/**
+ * @file gif_lzw.h
+ * @brief GIF 变长码 LZW 压缩（无损与有损）
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_GIF_LZW_H
+#define STEAM_SHOWCASE_GEN_GIF_LZW_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class LzwEncoder
+	 * @brief GIF 图像数据的 LZW 编码器
+	 *
+	 * 无损模式的字典以开放寻址哈希表存储：每项 32 位，高 20 位为键（前缀码 << 8 | 像素），低 12 位为码值，
+	 * 一次探测只需一次内存读取，整张表 32KB 可常驻 L1 缓存。
+	 * 有损模式需要枚举某个码的全部后继，字典改用首子/兄弟链表形式的前缀树。
+	 * 码长增长与清表时机与 giflib 一致。实例可复用，非线程安全。
+	 */
+	class LzwEncoder
+	{
+	public:
+		static constexpr int MAX_CODE_BITS = 12;
+
+		/**
+		 * @brief 压缩一幅图像的索引数据，追加到 out
+		 * @param pixels 按行紧密排列的 count 个调色板索引，取值须小于 1 << min_code_size
+		 * @param min_code_size 最小码长 (2-8)
+		 *
+		 * 输出为完整的 GIF 图像数据：最小码长字节 + 若干不超过 255 字节的子块 + 块终止符。
+		 */
+		void encode(const uint8_t *pixels, std::size_t count, int min_code_size, std::vector<uint8_t> &out);
+
+		/**
+		 * @brief 有损压缩：延长当前串时接受颜色相近的已有字典项，以更少的码覆盖更长的像素串
+		 * @param palette 256 项调色板（0xAARRGGBB），用于计算替换误差
+		 * @param transparent 透明色索引（-1 表示无），透明像素只与自身匹配
+		 * @param max_error 解码后每个像素与源颜色之间允许的 RGB 欧氏距离；替换误差按 3/4 扩散，只用于在允许范围内挑选后继。0 等同于 encode
+		 */
+		void encode_lossy(const uint8_t		   *pixels,
+						  std::size_t			count,
+						  int					min_code_size,
+						  const uint32_t	   *palette,
+						  int					transparent,
+						  int					max_error,
+						  std::vector<uint8_t> &out);
+
+	private:
+		static constexpr int	  HASH_BITS	 = 13; // 8192 项，装载率不超过 1/2
+		static constexpr int	  HASH_SIZE	 = 1 << HASH_BITS;
+		static constexpr uint32_t HASH_EMPTY = 0xFFFFFFFFu; // 码值 4095 从不分配，该值不会与有效项冲突
+		static constexpr int	  TABLE_SIZE = 1 << MAX_CODE_BITS;
+		static constexpr uint16_t NO_CHILD	 = 0; // 码 0 是根节点，不会作为任何码的后继
+
+		void begin(int min_code_size, std::vector<uint8_t> &out);
+		void emit(uint32_t code, std::vector<uint8_t> &out);
+		bool grow(std::vector<uint8_t> &out); // 分配下一个码；字典已满时清表并返回 false
+		void end(uint32_t code, std::vector<uint8_t> &out);
+		void put_code(uint32_t code, std::vector<uint8_t> &out);
+		void flush_bits(std::vector<uint8_t> &out);
+
+		// 无损模式字典
+		std::array<uint32_t, HASH_SIZE> table_{};
+
+		// 有损模式字典
+		std::array<uint16_t, TABLE_SIZE> first_child_{};
+		std::array<uint16_t, TABLE_SIZE> next_sibling_{};
+		std::array<uint8_t, TABLE_SIZE>	 suffix_{};
+
+		uint32_t	clear_code_	 = 0;
+		uint32_t	next_code_	 = 0;
+		int			min_bits_	 = 0;
+		uint32_t	bit_buffer_	 = 0;
+		int			bit_count_	 = 0;
+		int			code_bits_	 = 0;
+		std::size_t block_start_ = 0; // 当前子块长度字节在 out 中的位置
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_GIF_LZW_H
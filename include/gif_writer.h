@@ -0,0 +1,133 @@
+/**
+ * @file gif_writer.h
+ * @brief 自研 GIF89a 写出器：各帧的 LZW 压缩在线程池中并行执行，按顺序写入文件
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_GIF_WRITER_H
+#define STEAM_SHOWCASE_GEN_GIF_WRITER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "frame_delta.h"
+
+namespace SteamShowcaseGen
+{
+	class ThreadPool;
+
+	/**
+	 * @class GifWriter
+	 * @brief 单个 GIF 文件的写出器
+	 *
+	 * 文件结构：文件头、逻辑屏幕描述符与全局颜色表（取自首帧调色板）、NETSCAPE2.0 无限循环扩展，
+	 * 每帧依次为图形控制扩展（延迟、透明色、处置方式“保留”）、图像描述符、
+	 * 与全局颜色表不同时的局部颜色表、LZW 图像数据，最后是结尾符 0x3B（Hex Hack 依赖此字节）。
+	 *
+	 * 帧延迟取相邻两帧时间戳之差，因此每帧要等到下一帧提交后才能写出；
+	 * 压缩任务提交后立即返回，写出时才等待对应结果，队列长度受 MAX_IN_FLIGHT 限制；
+	 * 任务槽与缓冲区循环复用，稳态下逐帧写出不产生堆分配。析构与重新打开时等待线程池中的压缩任务全部返回。
+	 * 输出先写入内存缓冲：文件模式下按块写入磁盘，内存模式下完整保留，供码率控制比较体积。
+	 */
+	class GifWriter
+	{
+	public:
+		GifWriter() = default;
+		~GifWriter();
+
+		GifWriter(const GifWriter &)			= delete;
+		GifWriter &operator=(const GifWriter &) = delete;
+
+		/**
+		 * @param pool 压缩线程池，为空时在调用线程中压缩
+		 * @param lossy_error 有损 LZW 的误差预算（见 LzwEncoder::encode_lossy），0 表示无损
+		 */
+		bool open(const std::filesystem::path &path, int width, int height, ThreadPool *pool, int lossy_error);
+
+		/** @brief 以内存模式打开：不写文件，finish() 之后由 bytes() 取得完整的 GIF 数据 */
+		void open_memory(int width, int height, ThreadPool *pool, int lossy_error);
+
+		/**
+		 * @brief 提交一帧
+		 * @param indices 整帧 PAL8 索引平面，只编码 rect 覆盖的子矩形（空矩形按 1x1 处理）
+		 * @param palette 256 项调色板（0xAARRGGBB）
+		 * @param colors 调色板中有效的项数（含透明色）
+		 * @param transparent 透明色索引，-1 表示无
+		 * @param pts 展示时间戳（厘秒）
+		 */
+		void add_frame(const uint8_t *indices, int stride, const DeltaRect &rect, const uint32_t *palette, int colors, int transparent, int64_t pts);
+
+		/** @brief 写出剩余帧与结尾符并关闭文件；最后一帧使用 final_delay，为负时沿用上一帧的延迟 */
+		bool finish(int final_delay);
+
+		[[nodiscard]] bool is_open() const
+		{
+			return open_;
+		}
+
+		/** @brief 内存模式下为完整输出；文件模式下为尚未写入磁盘的部分 */
+		[[nodiscard]] const std::vector<uint8_t> &bytes() const
+		{
+			return bytes_;
+		}
+
+		/** @brief 已输出的总字节数 */
+		[[nodiscard]] std::size_t size() const
+		{
+			return flushed_ + bytes_.size();
+		}
+
+	private:
+		static constexpr std::size_t MAX_IN_FLIGHT = 16;
+
+		/**
+		 * 一帧的压缩任务。任务槽组成固定长度的环形队列在各帧之间循环使用，
+		 * 像素与输出缓冲区保留已有容量，预热之后提交一帧不再分配内存。
+		 */
+		struct PendingFrame
+		{
+			DeltaRect				  rect;
+			int64_t					  pts			= 0;
+			int						  transparent	= -1;
+			int						  table_bits	= 0; // 局部颜色表位数，0 表示使用全局颜色表
+			int						  min_code_size = 0;
+			std::array<uint32_t, 256> palette{};		 // 本帧调色板：局部颜色表及有损压缩的误差参考
+			std::vector<uint8_t>	  pixels;			 // 子矩形的索引数据
+			std::vector<uint8_t>	  data;				 // LZW 图像数据
+			std::atomic<bool>		  done{false};		 // 压缩完成标志，写出前在其上等待
+		};
+
+		void compress(PendingFrame &frame) const;
+		void await(const PendingFrame &frame) const;
+		void wait_pending();
+		void write_header();
+		void write_frame(PendingFrame &frame, int delay);
+		void write_color_table(const std::array<uint32_t, 256> &palette, int bits);
+		void drain(bool all, int final_delay);
+		void put(uint8_t value);
+		void put_u16(int value);
+		void flush();
+
+		std::ofstream			  file_;
+		std::vector<uint8_t>	  bytes_;
+		std::size_t				  flushed_		  = 0; // 已写入文件的字节数
+		bool					  open_			  = false;
+		ThreadPool				 *pool_			  = nullptr;
+		int						  width_		  = 0;
+		int						  height_		  = 0;
+		int						  lossy_error_	  = 0;
+		bool					  header_written_ = false;
+		int						  global_bits_	  = 0; // 全局颜色表位数，0 表示尚未确定
+		int						  last_delay_	  = 0; // 最近写出的帧延迟（厘秒）
+		std::array<uint32_t, 256> global_palette_{};
+
+		std::array<PendingFrame, MAX_IN_FLIGHT + 1> pending_;
+		std::size_t									pending_head_  = 0;
+		std::size_t									pending_count_ = 0;
+		std::atomic<std::size_t>					tasks_{0}; // 线程池中尚未返回的压缩任务数，析构与重置前等待其归零
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_GIF_WRITER_H
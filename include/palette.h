@@ -0,0 +1,59 @@
+/**
+ * @file palette.h
+ * @brief 调色板生成（中位切分）
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_PALETTE_H
+#define STEAM_SHOWCASE_GEN_PALETTE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "task_options.h"
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct Palette
+	 * @brief 最多 256 色的调色板
+	 */
+	struct Palette
+	{
+		std::array<uint32_t, 256> colors{}; // 0xAARRGGBB，与 AV_PIX_FMT_PAL8 的调色板布局一致
+		int						  size = 0;
+
+		bool operator==(const Palette &) const = default;
+	};
+
+	/**
+	 * @class ColorHistogram
+	 * @brief 15 位（RGB 各 5 位）颜色直方图，可累积多个切片后统一生成调色板
+	 */
+	class ColorHistogram
+	{
+	public:
+		static constexpr int BITS = 5;
+		static constexpr int BINS = 1 << (BITS * 3);
+
+		void clear();
+
+		/** @brief 累积一块 BGRA 像素区域 */
+		void add(const uint8_t *bgra, int stride, int width, int height);
+
+		/** @brief 以中位切分算法生成不超过 max_colors 色的调色板；借用本对象的工作缓冲，同一对象不可并发调用 */
+		[[nodiscard]] Palette build_palette(int max_colors) const;
+
+		/** @brief 非空格子：颜色键与像素数 */
+		struct Bin
+		{
+			uint16_t key;
+			uint32_t count;
+		};
+
+	private:
+		std::vector<uint32_t>	 bins_ = std::vector<uint32_t>(BINS, 0);
+		mutable std::vector<Bin> scratch_; // build_palette 的非空格子缓冲，首次调用时按 BINS 预留
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_PALETTE_H
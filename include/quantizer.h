@@ -0,0 +1,87 @@
+/**
+ * @file quantizer.h
+ * @brief 基于三维逆色表（LUT）的调色板量化器，映射内核按 CPU 特性在运行时分派
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_QUANTIZER_H
+#define STEAM_SHOWCASE_GEN_QUANTIZER_H
+
+#include <cstdint>
+#include <vector>
+#include "dither.h"
+#include "palette.h"
+#include "quantizer_kernels.h"
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class Quantizer
+	 * @brief 将 BGRA 像素映射为调色板索引
+	 *
+	 * set_palette() 为调色板预先计算一张 RGB 5-6-5 位共 65536 格的逆色表，
+	 * 每格存放距格中心最近的调色板索引；调色板不变时逆色表直接复用。
+	 * 映射阶段每个像素只需一次移位拼接与一次查表，SIMD 内核用 gather 一次处理 8/16 个像素。
+	 * 所有内核共用同一张逆色表，输出与标量参考实现逐字节一致。
+	 *
+	 * 有序抖动（Bayer / 蓝噪声）以逐行预展开的偏置数组送入同一组 SIMD 内核；
+	 * 误差扩散（Floyd-Steinberg）逐像素依赖前一像素的误差，只有标量实现。
+	 * 映射时会复用内部缓冲区，非线程安全，每个量化线程应持有独立实例。
+	 */
+	class Quantizer
+	{
+	public:
+		enum class Kernel
+		{
+			Scalar,
+			Sse41,
+			Avx2,
+			Avx512,
+		};
+
+		/** @brief 当前 CPU 支持的最快内核 */
+		static Kernel best_kernel();
+
+		explicit Quantizer(Kernel kernel = best_kernel());
+
+		/** @brief 更换调色板，仅在调色板变化时重建逆色表 */
+		void set_palette(const Palette &palette);
+
+		void set_dither(DitherMode mode);
+
+		[[nodiscard]] const Palette &palette() const
+		{
+			return palette_;
+		}
+
+		[[nodiscard]] Kernel kernel() const
+		{
+			return kernel_;
+		}
+
+		[[nodiscard]] DitherMode dither() const
+		{
+			return dither_;
+		}
+
+		void map(const uint8_t *bgra, int src_stride, int width, int height, uint8_t *dst, int dst_stride);
+
+	private:
+		void build_lut();
+		void prepare_bias(int width);
+		void map_diffused(const uint8_t *bgra, int src_stride, int width, int height, uint8_t *dst, int dst_stride);
+
+		Kernel				 kernel_;
+		Palette				 palette_;
+		std::vector<uint8_t> lut_; // QuantizerKernels::LUT_SIZE 项，末尾另有填充供 32 位 gather 越界读取
+
+		DitherMode			 dither_ = DitherMode::None;
+		std::vector<uint8_t> bias_add_;		   // 有序抖动偏置：矩阵每行展开为 bias_width_ 个像素
+		std::vector<uint8_t> bias_sub_;
+		int					 bias_period_ = 0; // 矩阵边长，0 表示偏置尚未生成
+		int					 bias_width_  = 0;
+		int					 bias_spread_ = 0;
+		std::vector<int>	 diffusion_;	   // 误差扩散的两行误差缓冲
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_QUANTIZER_H
@@ -0,0 +1,44 @@
+/**
+ * @file quantizer_kernels.h
+ * @brief 量化映射内核声明
+ *
+ * 各 SIMD 内核位于独立的编译单元，并以对应的指令集开关单独编译。
+ * 这些编译单元只应包含本头文件与 intrinsics 头文件，避免带有高级指令的
+ * 内联模板实例泄漏到其它编译单元。
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_QUANTIZER_KERNELS_H
+#define STEAM_SHOWCASE_GEN_QUANTIZER_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SteamShowcaseGen::QuantizerKernels
+{
+	// 逆色表格数（RGB 5-6-5 位）与末尾填充字节数
+	inline constexpr int LUT_SIZE	 = 1 << 16;
+	inline constexpr int LUT_PADDING = 4;
+
+	/** @brief 像素（0xAARRGGBB，即内存中的 BGRA）在逆色表中的位置 */
+	constexpr uint32_t lut_index(const uint32_t pixel)
+	{
+		return ((pixel >> 8) & 0xF800) | ((pixel >> 5) & 0x07E0) | ((pixel >> 3) & 0x001F);
+	}
+
+	/**
+	 * 逐行映射内核：width 个 BGRA 像素 -> width 个调色板索引
+	 *
+	 * bias_add / bias_sub 为与像素一一对应的逐字节偏置（有序抖动），可同时为空。
+	 * 查表前每个通道先与 bias_add 做饱和加、再与 bias_sub 做饱和减，
+	 * 两者配合即可表示有符号偏置，且与 SIMD 的无符号饱和运算逐字节一致。
+	 * SIMD 内核的剩余像素交给 map_row_scalar 处理。
+	 */
+	using MapRow = void (*)(const uint8_t *bgra, int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst);
+
+	void map_row_scalar(const uint8_t *bgra, int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst);
+	void map_row_sse41(const uint8_t *bgra, int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst);
+	void map_row_avx2(const uint8_t *bgra, int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst);
+	void map_row_avx512(const uint8_t *bgra, int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst);
+} // namespace SteamShowcaseGen::QuantizerKernels
+
+#endif // STEAM_SHOWCASE_GEN_QUANTIZER_KERNELS_H
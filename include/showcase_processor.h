@@ -6,33 +6,92 @@
 #ifndef STEAM_SHOWCASE_GEN_SHOWCASE_PROCESSOR_H
 #define STEAM_SHOWCASE_GEN_SHOWCASE_PROCESSOR_H
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <functional>
-#include <opencv2/core/mat.hpp>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stop_token>
 #include <string_view>
-#include <thread>
-
-struct AVFormatContext;
-struct AVCodecContext;
-struct AVStream;
-struct AVFrame;
-struct SwsContext;
+#include <vector>
+#include "task_options.h"
 
 namespace SteamShowcaseGen
 {
 	/**
-	 * @struct EncoderState
-	 * @brief 用于管理单个切片编码状态的轻量化数据结构
+	 * @struct JobProgress
+	 * @brief 任务进度计数：由处理线程更新，可在任意线程读取
+	 */
+	struct JobProgress
+	{
+		std::atomic<std::size_t> frames{0};		 // 已处理的帧数（批量任务为各文件之和）
+		std::atomic<std::size_t> files_done{0};	 // 已结束的文件数
+		std::atomic<std::size_t> files_total{1}; // 文件总数
+		std::atomic<std::size_t> failures{0};	 // 未能写出全部切片的文件数
+	};
+
+	/**
+	 * @class JobHandle
+	 * @brief ShowcaseProcessor::submit 返回的任务句柄，可复制，各副本指向同一个任务
+	 *
+	 * 句柄不拥有处理线程：丢弃句柄不会取消或等待任务，任务结束前处理器析构时统一取消并等待。
 	 */
-	struct EncoderState
+	class JobHandle
 	{
-		AVFormatContext *fmt_ctx	 = nullptr;
-		AVCodecContext	*codec_ctx	 = nullptr;
-		AVStream		*stream		 = nullptr;
-		AVFrame			*frame		 = nullptr;
-		SwsContext		*sws_ctx	 = nullptr;
-		int				 frame_count = 0;
+	public:
+		JobHandle() = default;
+
+		[[nodiscard]] bool valid() const
+		{
+			return state_ != nullptr;
+		}
+
+		/** @brief 请求取消，任务在下一个检查点退出；不等待 */
+		void cancel() const
+		{
+			state_->stop.request_stop();
+		}
+
+		[[nodiscard]] std::stop_token stop_token() const
+		{
+			return state_->stop.get_token();
+		}
+
+		[[nodiscard]] const JobProgress &progress() const
+		{
+			return state_->progress;
+		}
+
+		/** @brief 任务结果：全部切片成功写出（批量任务为全部文件成功）时为 true，被取消或失败时为 false */
+		[[nodiscard]] const std::shared_future<bool> &result() const
+		{
+			return state_->result;
+		}
+
+		[[nodiscard]] bool finished() const
+		{
+			return state_->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+	private:
+		friend class ShowcaseProcessor;
+
+		struct State
+		{
+			std::stop_source		 stop;
+			JobProgress				 progress;
+			std::shared_future<bool> result;
+		};
+
+		explicit JobHandle(std::shared_ptr<State> state) : state_(std::move(state))
+		{
+		}
+
+		std::shared_ptr<State> state_;
 	};
 
 	/**
@@ -50,44 +109,93 @@ namespace SteamShowcaseGen
 		ShowcaseProcessor(const ShowcaseProcessor &)			= delete;
 		ShowcaseProcessor &operator=(const ShowcaseProcessor &) = delete;
 
+		/**
+		 * @brief 提交一个处理任务并立即返回其句柄
+		 *
+		 * 多个任务可同时进行并各自取消，计算工作共用处理器的调度器（大小由首个任务的 options.threads 决定，
+		 * 没有任务运行时才按新值重建）。on_update 在处理线程中调用。
+		 */
+		JobHandle submit(const std::filesystem::path &source_path,
+						 const std::filesystem::path &output_dir,
+						 const TaskOptions			 &options,
+						 const UpdateCallback		 &on_update);
+
+		/**
+		 * @brief 提交批量任务：每个源文件输出到 output_dir 下以其文件名命名的子目录
+		 *
+		 * 线程总数约为 thread_budget（0 表示 CPU 核心数），每 4 个线程同时处理一个文件。
+		 * 批量任务不使用帧缓存；进度消息带有 "[序号/总数] 文件名: " 前缀，全部结束后报告汇总。
+		 */
+		JobHandle submit_batch(const std::vector<std::filesystem::path> &sources,
+							   const std::filesystem::path				&output_dir,
+							   const TaskOptions						&options,
+							   const UpdateCallback						&on_update,
+							   unsigned									 thread_budget = 0);
+
+		/** @brief 界面使用的单任务接口：取消并等待体积预估与上一个由 start_task/start_batch 启动的任务，清空日志后提交新任务 */
 		void start_task(const std::filesystem::path &source_path,
 						const std::filesystem::path &output_dir,
-						int							 sampling_rate,
-						int							 quality_mode,
+						const TaskOptions			&options,
 						const UpdateCallback		&on_update);
+		void start_batch(const std::vector<std::filesystem::path> &sources,
+						 const std::filesystem::path			  &output_dir,
+						 const TaskOptions						  &options,
+						 const UpdateCallback					  &on_update,
+						 unsigned								   thread_budget = 0);
 		void stop_task();
 
-		[[nodiscard]] bool is_active() const
+		/** @brief 是否有任务正在运行 */
+		[[nodiscard]] bool is_active() const;
+
+		/**
+		 * @struct SizeEstimate
+		 * @brief 输出体积的快速预估结果
+		 */
+		struct SizeEstimate
 		{
-			return is_processing_.load();
-		}
+			std::vector<std::size_t> slice_bytes; // 各切片的预估字节数
+			int						 frames = 0;  // 预计输出帧数
+
+			[[nodiscard]] std::size_t largest() const
+			{
+				return slice_bytes.empty() ? 0 : std::ranges::max(slice_bytes);
+			}
+		};
+
+		using EstimateCallback = std::function<void(const std::optional<SizeEstimate> &)>;
+
+		/**
+		 * @brief 按当前配置快速预估各切片的输出体积
+		 *
+		 * 在素材中均匀抽取 8 组相隔一个输出采样间隔的两帧，分别测得首帧与增量帧的编码体积，
+		 * 再按预计输出帧数外推；耗时只取决于抽样数，与素材长度无关。
+		 * 抽样统一使用自研编码器在内存中编码，LZW 压缩在共享调度器上执行；图片输入或无法打开时返回 std::nullopt。
+		 */
+		std::optional<SizeEstimate> estimate_size(const std::stop_token &st, const std::filesystem::path &source_path, const TaskOptions &options);
+
+		/**
+		 * @brief 交给后台预估线程，完成后在该线程中调用 on_done；不阻塞调用方
+		 *
+		 * 新的请求取消正在进行的预估并替换尚未开始的请求，过期的结果不会回调。
+		 */
+		void request_estimate(const std::filesystem::path &source_path, const TaskOptions &options, const EstimateCallback &on_done);
+
+		/** @brief 取消正在进行与尚未开始的预估；wait 为 true 时等待正在执行的预估及其回调结束（不可在回调中使用） */
+		void cancel_estimate(bool wait = false);
 
 		/** @brief 静态方法：应用 Steam Hex Hack */
 		static bool apply_steam_hex_hack(const std::filesystem::path &file_path);
 
+		/** @brief 是否为支持的源文件类型（按扩展名判断，不区分大小写） */
+		static bool is_supported(const std::filesystem::path &path);
+
+		/** @brief 关闭 OpenCV 与 FFmpeg 写到控制台的日志，前端在启动时调用一次 */
+		static void silence_library_logs();
+
 	private:
-		/** @brief 内部执行主循环 */
-		void run_internal(const std::stop_token		  &st,
-						  const std::filesystem::path &source_path,
-						  const std::filesystem::path &output_dir,
-						  int						   sampling_rate,
-						  int						   quality_mode,
-						  const UpdateCallback		  &on_update);
-
-		// FFmpeg 静态辅助方法
-		static bool init_encoder(EncoderState &state, const std::string &filename, int width, int height, int fps, int quality_mode);
-		static void push_frame(EncoderState &state, const cv::Mat &cv_frame, int height);
-		static void encode_raw_frame(const EncoderState &state, const AVFrame *raw_frame);
-		static void finish_encoder(EncoderState &state);
-
-		// 常量定义
-		static constexpr int STEAM_SHOWCASE_WIDTH = 766;
-		static constexpr int SLICE_WIDTH		  = 150;
-		static constexpr int GAP_WIDTH			  = 4;
-		static constexpr int SLICE_COUNT		  = 5;
-
-		std::jthread	  worker_thread_;
-		std::atomic<bool> is_processing_{false};
+		// 解码、缩放、量化与编码的实现及其状态都在 showcase_processor.cpp 中，公共接口不暴露处理阶段的类型
+		struct Impl;
+		std::unique_ptr<Impl> impl_;
 	};
 } // namespace SteamShowcaseGen
 
@@ -0,0 +1,47 @@
+/**
+ * @file slice_scaler.h
+ * @brief 展柜切片的布局参数，以及切片源区域的映射与缩放（裁剪、缩放与转 BGRA 由一次 sws_scale 完成）
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_SLICE_SCALER_H
+#define STEAM_SHOWCASE_GEN_SLICE_SCALER_H
+
+#include "slice_view.h"
+
+struct AVFrame;
+struct SwsContext;
+
+namespace SteamShowcaseGen::SliceScaler
+{
+	// 展柜布局：SLICE_COUNT 个等宽切片依次排列，相邻切片之间留有 GAP_WIDTH 像素的间隙
+	inline constexpr int SHOWCASE_WIDTH	= 766;
+	inline constexpr int SLICE_WIDTH	= 150;
+	inline constexpr int GAP_WIDTH		= 4;
+	inline constexpr int SLICE_COUNT	= 5;
+
+	// 质量档位 0-3 依次为最近邻、双线性、双三次与 Lanczos 缩放，有损档位沿用双三次
+	inline constexpr int QUALITY_LOSSY = 4;
+
+	/** @brief 质量档位对应的 swscale 缩放算法标志 */
+	int select_sws_flags(int quality_mode);
+
+	/** @brief 分配 width x height、format 格式的帧及其缓冲区，失败时返回 nullptr */
+	AVFrame *alloc_frame(int width, int height, int format);
+
+	/**
+	 * @brief 将展柜坐标系中第 index 个切片的区间映射回源帧，得到不复制像素的跨步视图
+	 *
+	 * 左边界对齐到色度采样粒度；硬件帧或切片落在源帧之外时返回空视图。
+	 */
+	SliceView map_source(const AVFrame &frame, int index);
+
+	/**
+	 * @brief 将 src 缩放并转换为 dst 的尺寸与格式
+	 *
+	 * context 由 sws_getCachedContext 按需创建或沿用，调用方负责以 sws_freeContext 释放；
+	 * dst 仍被其他引用持有时先复制为独占缓冲区。
+	 */
+	bool scale(SwsContext *&context, int sws_flags, const SliceView &src, AVFrame *dst);
+} // namespace SteamShowcaseGen::SliceScaler
+
+#endif // STEAM_SHOWCASE_GEN_SLICE_SCALER_H
@@ -0,0 +1,37 @@
+/**
+ * @file slice_view.h
+ * @brief 切片视图：指向共享帧缓冲区的非拥有跨步视图
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_SLICE_VIEW_H
+#define STEAM_SHOWCASE_GEN_SLICE_VIEW_H
+
+#include <array>
+#include <cstdint>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @struct SliceView
+	 * @brief 切片的跨步视图（不拥有像素数据）
+	 *
+	 * 支持平面格式（如 YUV420P），每个平面各自携带起始地址与行跨度。
+	 * 视图的生命周期由其所属的帧槽保证：帧槽在所有切片编码完成之前不会被复用，
+	 * 因此其它线程可以在此期间安全地只读访问 data。
+	 */
+	struct SliceView
+	{
+		std::array<const uint8_t *, 4> data{};		 // 各平面中切片左上角像素
+		std::array<int, 4>			   stride{};	 // 各平面行跨度（字节），即底层缓冲区的行宽
+		int							   width  = 0;
+		int							   height = 0;
+		int							   format = -1; // AVPixelFormat
+
+		[[nodiscard]] bool empty() const
+		{
+			return data[0] == nullptr || width <= 0 || height <= 0;
+		}
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_SLICE_VIEW_H
@@ -0,0 +1,16 @@
+/**
+ * @file ssg_core.h
+ * @brief 核心库 ssg_core 的公共头文件
+ *
+ * 核心库提供 ShowcaseProcessor（解码、缩放、量化、GIF 编码与 Steam Hex Hack）及其任务接口，
+ * 不依赖 FTXUI。本文件只引入 TaskOptions（task_options.h）、任务句柄与处理器接口，处理器的内部状态
+ * 隐藏在实现中，修改处理阶段不会牵动前端的编译。终端界面与命令行只需包含本文件；各处理阶段的头文件
+ * 位于同一目录，供基准测试等需要单独调用某一阶段的代码按需包含。
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_SSG_CORE_H
+#define STEAM_SHOWCASE_GEN_SSG_CORE_H
+
+#include "showcase_processor.h"
+
+#endif // STEAM_SHOWCASE_GEN_SSG_CORE_H
@@ -0,0 +1,103 @@
+/**
+ * @file task_options.h
+ * @brief 处理任务的参数：TaskOptions 及其用到的各阶段模式枚举
+ *
+ * 本文件属于 ssg_core 的公共接口，只依赖标准库；各处理阶段的头文件从这里取得各自的模式枚举。
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_TASK_OPTIONS_H
+#define STEAM_SHOWCASE_GEN_TASK_OPTIONS_H
+
+#include <cstddef>
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @enum PaletteMode
+	 * @brief 调色板的作用范围，两种模式下五个切片都共享同一个调色板
+	 */
+	enum class PaletteMode
+	{
+		PerFrame, // 每帧生成一次：色彩更贴合当前画面，但帧间可能闪烁
+		Global,	  // 整段素材抽样生成一次：帧间稳定，且映射表可在全片复用
+	};
+
+	/**
+	 * @enum DitherMode
+	 * @brief 调色板量化时的抖动方式
+	 */
+	enum class DitherMode
+	{
+		None,			// 不抖动：直接取最近色，渐变处会出现色带
+		Bayer,			// 8x8 Bayer 有序抖动：图案规则、帧间稳定，最快
+		FloydSteinberg, // Floyd-Steinberg 误差扩散：细节最好，但逐像素串行且帧间噪点会变化
+		BlueNoise,		// 64x64 蓝噪声有序抖动：无明显纹理、帧间稳定
+	};
+
+	/**
+	 * @enum DedupMode
+	 * @brief 重复帧的判定方式
+	 */
+	enum class DedupMode
+	{
+		Off,		// 不检测
+		Exact,		// 量化结果（索引与调色板）完全一致才视为重复，输出无损
+		Perceptual, // 缩放后的画面逐块比较，每个 16x16 块的平均通道差都不超过阈值即视为重复
+	};
+
+	/**
+	 * @enum DecodeThreadType
+	 * @brief 解码多线程模式，取值与 FF_THREAD_FRAME / FF_THREAD_SLICE 一致
+	 */
+	enum class DecodeThreadType : int
+	{
+		Frame		  = 1, // 帧级并行：吞吐最高，但会引入 thread_count 帧的延迟
+		Slice		  = 2, // 片级并行：无额外延迟，依赖码流中的 slice 划分
+		FrameAndSlice = 3, // 由解码器在两者中自行选择
+	};
+
+	/**
+	 * @struct DecoderOptions
+	 * @brief 解码器配置
+	 */
+	struct DecoderOptions
+	{
+		int				 thread_count = 0; // 0 表示由 FFmpeg 按 CPU 核心数自动决定
+		DecodeThreadType thread_type  = DecodeThreadType::FrameAndSlice;
+	};
+
+	/**
+	 * @enum EncoderBackend
+	 * @brief GIF 编码后端
+	 */
+	enum class EncoderBackend
+	{
+		LibAvCodec, // libavcodec GIF 编码器 + libavformat 封装，逐帧串行压缩
+		Native,		// 自研写出器：各帧 LZW 压缩在线程池中并行执行
+	};
+
+	/**
+	 * @struct TaskOptions
+	 * @brief 单个处理任务的参数集合
+	 */
+	struct TaskOptions
+	{
+		int			   sampling_rate   = 10;					 // 帧采样率 (1-10)，10 表示保留全部帧
+		int			   quality_mode	   = 2;						 // 质量档位 (0-4)，0-3 为缩放算法，4 为双三次缩放 + 有损 LZW
+		int			   max_frames	   = 0;						 // 每个切片的最大输出帧数，0 表示不限制
+		PaletteMode	   palette_mode	   = PaletteMode::Global;	 // 调色板作用范围
+		int			   palette_colors  = 256;					 // 调色板颜色数 (2-256)
+		DitherMode	   dither		   = DitherMode::None;		 // 量化抖动方式
+		bool		   delta_frames	   = true;					 // 帧间增量：未变化的像素输出为透明
+		DedupMode	   dedup		   = DedupMode::Exact;		 // 重复帧合并方式
+		int			   dedup_threshold = 2;						 // 感知去重阈值：每块允许的平均通道差 (0-255)
+		EncoderBackend encoder		   = EncoderBackend::Native; // GIF 编码后端
+		int			   lossy_error	   = 32;					 // 有损档位的 LZW 误差预算（RGB 距离），仅自研后端支持
+		std::size_t	   target_bytes	   = 0;						 // 每个切片的体积上限（字节），0 表示不限制
+		bool		   frame_cache	   = true;					 // 保留缩放后的帧，源文件与缩放参数不变时跳过解码与缩放
+		unsigned	   threads		   = 0;						 // 线程预算：调度器与解码线程合计，0 表示按 CPU 核心数
+		DecoderOptions decoder;									 // 视频解码线程配置
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_TASK_OPTIONS_H
@@ -0,0 +1,159 @@
+/**
+ * @file thread_pool.h
+ * @brief 全局共享的工作窃取调度器，以及在其上串行执行任务的 Strand
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_THREAD_POOL_H
+#define STEAM_SHOWCASE_GEN_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SteamShowcaseGen
+{
+	using Task = std::move_only_function<void()>;
+
+	/**
+	 * @class TaskQueue
+	 * @brief 环形缓冲的任务队列，两端均可取出；只在积压超过已有容量时扩容。非线程安全
+	 */
+	class TaskQueue
+	{
+	public:
+		TaskQueue();
+
+		void push_back(Task task);
+		Task pop_front();
+		Task pop_back();
+
+		[[nodiscard]] bool empty() const
+		{
+			return count_ == 0;
+		}
+
+	private:
+		static constexpr std::size_t INITIAL_CAPACITY = 64;
+
+		void grow();
+
+		std::vector<Task> tasks_;
+		std::size_t		  head_	 = 0;
+		std::size_t		  count_ = 0;
+	};
+
+	/**
+	 * @class ThreadPool
+	 * @brief 工作窃取调度器：每个工作线程一个本地队列，外部线程提交的任务进入全局队列
+	 *
+	 * 工作线程提交的任务放入自己的本地队列并后进先出地执行（数据仍在缓存中）；本地队列为空时
+	 * 先取全局队列，再从其他线程的本地队列头部窃取。同一个调度器由全部任务共享，线程总数固定，
+	 * 不随同时处理的任务数增长。以 post() 提交、捕获不超过两个指针的任务不产生堆分配。
+	 * 析构时先执行完已提交的任务再退出。
+	 */
+	class ThreadPool
+	{
+	public:
+		/** @param threads 工作线程数，0 表示按硬件并发数 */
+		explicit ThreadPool(unsigned threads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &)			  = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		/** @brief 提交任务，返回其结果的 future */
+		template <typename F>
+		auto submit(F &&task) -> std::future<std::invoke_result_t<F>>
+		{
+			std::packaged_task<std::invoke_result_t<F>()> packaged(std::forward<F>(task));
+			auto										  result = packaged.get_future();
+			post(std::move(packaged));
+			return result;
+		}
+
+		/** @brief 提交不需要返回值的任务，完成通知由任务自行负责 */
+		void post(Task task);
+
+		/**
+		 * @brief 在本调度器的工作线程中调用时，取出并执行一个排队中的任务
+		 *
+		 * 工作线程中的任务需要等待其他任务时，应在等待期间循环调用本函数代为执行，
+		 * 返回 false（没有可执行的任务，被等待的任务必已在其他线程上运行）后再阻塞等待；
+		 * 否则全部工作线程可能同时阻塞在等待上。在其他线程中调用时直接返回 false。
+		 */
+		bool run_pending();
+
+		[[nodiscard]] unsigned size() const
+		{
+			return static_cast<unsigned>(workers_.size());
+		}
+
+	private:
+		struct LocalQueue
+		{
+			std::mutex mutex;
+			TaskQueue  tasks;
+		};
+
+		// 依次尝试本地队列（后进先出）、全局队列与其他线程的本地队列（先进先出）
+		Task take(std::size_t self);
+		void worker_loop(std::size_t index);
+
+		static thread_local ThreadPool *current_pool_;
+		static thread_local std::size_t current_index_;
+
+		std::vector<std::unique_ptr<LocalQueue>> locals_;
+		std::mutex								 global_mutex_;
+		TaskQueue								 global_;
+		std::atomic<std::size_t>				 queued_{0}; // 各队列中尚未被取出的任务总数
+		std::mutex								 sleep_mutex_;
+		std::condition_variable					 sleep_cv_;
+		bool									 stopping_ = false;
+		std::vector<std::jthread>				 workers_; // 最后声明：析构时最先 join，此时其余成员仍然有效
+	};
+
+	/**
+	 * @class Strand
+	 * @brief 在共享调度器上按提交顺序逐个执行的任务序列
+	 *
+	 * 同一个 Strand 的任务不会并发执行，适合持有顺序状态的工作（如单个切片的逐帧编码）；
+	 * 不同 Strand 之间并行，空闲时不占用任何线程。析构时等待已提交的任务全部完成。
+	 */
+	class Strand
+	{
+	public:
+		explicit Strand(ThreadPool &pool) : pool_(pool)
+		{
+		}
+		~Strand()
+		{
+			wait_idle();
+		}
+
+		Strand(const Strand &)			  = delete;
+		Strand &operator=(const Strand &) = delete;
+
+		void post(Task task);
+
+		/** @brief 等待已提交的任务全部执行完毕；不可在本调度器的工作线程中调用 */
+		void wait_idle();
+
+	private:
+		void run();
+
+		ThreadPool				&pool_;
+		std::mutex				mutex_;
+		std::condition_variable idle_cv_;
+		TaskQueue				tasks_;
+		bool					running_ = false; // 已有一个执行任务在调度器中排队或运行
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_THREAD_POOL_H
@@ -2,7 +2,9 @@
 #define STEAM_SHOWCASE_GEN_UI_COMPONENTS_H
 
 #include <functional>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "ftxui/component/component.hpp"
 
@@ -18,11 +20,23 @@ namespace SteamShowcaseGen::Ui
 		std::string				 out_dir = "output";
 		std::vector<std::string> file_list;
 		int						 selected_file_idx = 0;
+		bool					 batch_mode		   = false; // 批量处理列表中的全部文件
 		int						 sampling_rate	   = 10;
 		int						 quality_idx	   = 2;
+		int						 dither_idx		   = 0;
+		std::string				 target_kb;
+		std::string				 size_estimate; // 体积预估结果，空表示暂无
 		int						 tab_idx		   = 0;
-		std::string				 current_log;
+		std::string				 current_log;	// 状态栏消息，读写须持有 log_mutex
+		mutable std::mutex		 log_mutex;		// 批量任务的多个处理线程同时写入进度，渲染时读取
 		int						 spinner_index = 0;
+
+		/** @brief 替换状态栏消息，沿用已有容量；可在任意线程调用 */
+		void set_log(const std::string_view log)
+		{
+			std::lock_guard lock(log_mutex);
+			current_log.assign(log);
+		}
 	};
 
 	/**
@@ -30,9 +44,13 @@ namespace SteamShowcaseGen::Ui
 	 * @param state 应用状态引用
 	 * @param on_start 点击"开始生成"按钮的回调
 	 * @param is_busy 当前是否正在处理任务 (用于控制 UI 禁用/加载状态)
+	 * @param on_config_change 所选文件或影响输出体积的配置发生变化时的回调 (用于刷新体积预估)
 	 * @return 封装好的根组件
 	 */
-	ftxui::Component BuildMainInterface(AppState &state, const std::function<void()> &on_start, const std::function<bool()> &is_busy);
+	ftxui::Component BuildMainInterface(AppState					&state,
+										const std::function<void()> &on_start,
+										const std::function<bool()> &is_busy,
+										const std::function<void()> &on_config_change);
 
 } // namespace SteamShowcaseGen::Ui
 
@@ -0,0 +1,98 @@
+/**
+ * @file video_decoder.h
+ * @brief 基于 libavformat/libavcodec 的视频解码器，直接解码到调用方提供的帧池
+ */
+
+#ifndef STEAM_SHOWCASE_GEN_VIDEO_DECODER_H
+#define STEAM_SHOWCASE_GEN_VIDEO_DECODER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <stop_token>
+#include "frame_resampler.h"
+#include "task_options.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @class VideoDecoder
+	 * @brief 视频解码器：封装解复用与解码循环，只处理最佳视频流
+	 */
+	class VideoDecoder
+	{
+	public:
+		VideoDecoder() = default;
+		~VideoDecoder();
+
+		VideoDecoder(const VideoDecoder &)			  = delete;
+		VideoDecoder &operator=(const VideoDecoder &) = delete;
+
+		/** @brief 打开文件并初始化解码器，失败时返回 false */
+		bool open(const std::filesystem::path &path, const DecoderOptions &options);
+		void close();
+
+		/**
+		 * @brief 设置帧选择器（不转移所有权，须在解码期间保持有效）
+		 *
+		 * 设置后，不需要的帧会尽可能廉价地跳过：可丢弃的包在解复用后直接丢弃，
+		 * 其余包以 AVDISCARD_NONREF 送入解码器（跳过非参考帧），
+		 * 仍被解码出来的参考帧不会返回给调用方，也就不会进入后续的色彩转换。
+		 */
+		void set_frame_selector(FrameSelector *selector);
+
+		/**
+		 * @brief 解码下一个被选中的帧
+		 * @param dst 调用方帧池中的 AVFrame，原有引用会被释放，随后指向解码器输出的缓冲区
+		 * @return 成功得到一帧返回 true；流结束或出错返回 false
+		 * @note AVPacket 只分配一次并反复使用，但 av_read_frame 仍由解复用器为每个数据包分配数据缓冲区（av_malloc），
+		 *       这部分在 FFmpeg 内部，无法由调用方预分配
+		 */
+		bool decode_next(AVFrame *dst);
+
+		/**
+		 * @brief 定位并解码展示时间不早于 t 秒的第一帧（忽略帧选择器），用于抽样
+		 * @param st 从关键帧解码到目标时间的过程中检查，请求停止时返回 false
+		 * @note 抽样结束后应调用 rewind() 再开始顺序解码
+		 */
+		bool decode_at(double t, AVFrame *dst, const std::stop_token &st = {});
+
+		/** @brief 回到流起点，准备从头顺序解码 */
+		bool rewind();
+
+		/** @brief 帧的展示时间（秒，相对流起点） */
+		[[nodiscard]] double frame_time(const AVFrame &frame) const;
+
+		[[nodiscard]] bool is_open() const
+		{
+			return codec_ctx_ != nullptr;
+		}
+
+		[[nodiscard]] int	 width() const;
+		[[nodiscard]] int	 height() const;
+		[[nodiscard]] double frame_rate() const;
+		[[nodiscard]] double duration() const; // 秒，未知时为 0
+
+	private:
+		AVFormatContext *fmt_ctx_	   = nullptr;
+		AVCodecContext	*codec_ctx_	   = nullptr;
+		AVPacket		*packet_	   = nullptr;
+		int				 stream_index_ = -1;
+		double			 frame_rate_   = 0.0;
+		double			 duration_	   = 0.0;
+		double			 time_base_	   = 0.0; // 流时间基（秒/单位）
+		int64_t			 start_pts_	   = 0;
+		int64_t			 output_count_ = 0; // 已输出帧数，时间戳缺失时用于推算展示时间
+		bool			 draining_	   = false;
+		FrameSelector	*selector_	   = nullptr;
+
+		[[nodiscard]] bool wants_packet(const AVPacket &packet) const;
+		bool			   seek(double t);
+	};
+} // namespace SteamShowcaseGen
+
+#endif // STEAM_SHOWCASE_GEN_VIDEO_DECODER_H
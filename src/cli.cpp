@@ -0,0 +1,379 @@
+#include "cli.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "app_text.hpp"
+#include "ssg_core.h"
+
+namespace SteamShowcaseGen::Cli
+{
+	namespace txt = AppText;
+	namespace fs  = std::filesystem;
+
+	// 轮询任务进度的间隔
+	static constexpr auto PROGRESS_INTERVAL = std::chrono::milliseconds(250);
+
+	static volatile std::sig_atomic_t interrupted = 0;
+
+	/**
+	 * @struct Arguments
+	 * @brief 解析后的命令行参数
+	 */
+	struct Arguments
+	{
+		std::vector<std::string> inputs;
+		fs::path				 output_dir = "output";
+		TaskOptions				 options;
+		bool					 help = false;
+	};
+
+	static void on_interrupt(int)
+	{
+		interrupted = 1;
+	}
+
+	// 处理线程与主线程都会输出事件，每行须完整写出
+	static void emit(const std::string &line)
+	{
+		static std::mutex stdout_mutex;
+		std::lock_guard	  lock(stdout_mutex);
+		std::cout << line << '\n' << std::flush;
+	}
+
+	static std::string json_escape(const std::string_view text)
+	{
+		std::string out;
+		out.reserve(text.size());
+		for (const char c: text)
+		{
+			switch (c)
+			{
+				case '"':
+					out += "\\\"";
+					break;
+				case '\\':
+					out += "\\\\";
+					break;
+				case '\n':
+					out += "\\n";
+					break;
+				case '\r':
+					out += "\\r";
+					break;
+				case '\t':
+					out += "\\t";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+					}
+					else
+					{
+						out += c; // UTF-8 多字节序列原样输出
+					}
+			}
+		}
+		return out;
+	}
+
+	static void emit_progress(const JobProgress &progress)
+	{
+		emit(std::format(R"({{"event":"progress","frames":{},"files_done":{},"files_total":{},"failures":{}}})",
+						 progress.frames.load(),
+						 progress.files_done.load(),
+						 progress.files_total.load(),
+						 progress.failures.load()));
+	}
+
+	// 解析 [min, max] 范围内的整数，须完整消耗参数
+	template <typename T>
+	static bool parse_number(const std::string_view text, const T min, const T max, T &value)
+	{
+		T	 parsed{};
+		auto result = std::from_chars(text.data(), text.data() + text.size(), parsed);
+		if (result.ec != std::errc() || result.ptr != text.data() + text.size() || parsed < min || parsed > max)
+		{
+			return false;
+		}
+		value = parsed;
+		return true;
+	}
+
+	static std::optional<Arguments> parse_arguments(const int argc, char *argv[], std::string &error)
+	{
+		Arguments args;
+		bool	  options_done = false;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (options_done || !arg.starts_with('-') || arg == "-")
+			{
+				args.inputs.emplace_back(arg);
+				continue;
+			}
+			if (arg == "--")
+			{
+				options_done = true;
+				continue;
+			}
+			if (arg == "-h" || arg == "--help")
+			{
+				args.help = true;
+				continue;
+			}
+
+			static constexpr std::array value_options = {
+				"-o", "--output", "-s", "--sampling", "-q", "--quality", "-d", "--dither", "-t", "--target-kb", "-j", "--threads"};
+			if (std::ranges::find(value_options, arg) == value_options.end())
+			{
+				error = std::format("{}{}", txt::ERR_CLI_UNKNOWN_OPTION, arg);
+				return std::nullopt;
+			}
+			if (i + 1 >= argc)
+			{
+				error = std::format("{}{}", txt::ERR_CLI_MISSING_VALUE, arg);
+				return std::nullopt;
+			}
+			const std::string_view value = argv[++i];
+
+			auto &options = args.options;
+			bool  valid	  = true;
+			if (arg == "-o" || arg == "--output")
+			{
+				args.output_dir = value;
+			}
+			else if (arg == "-s" || arg == "--sampling")
+			{
+				valid = parse_number(value, 1, 10, options.sampling_rate);
+			}
+			else if (arg == "-q" || arg == "--quality")
+			{
+				valid = parse_number(value, 0, 4, options.quality_mode);
+			}
+			else if (arg == "-d" || arg == "--dither")
+			{
+				int dither	   = 0;
+				valid		   = parse_number(value, 0, 3, dither);
+				options.dither = static_cast<DitherMode>(dither);
+			}
+			else if (arg == "-t" || arg == "--target-kb")
+			{
+				std::size_t target_kb = 0;
+				valid				  = parse_number(value, std::size_t{0}, std::numeric_limits<std::size_t>::max() / 1024, target_kb);
+				options.target_bytes  = target_kb * 1024;
+			}
+			else
+			{
+				valid = parse_number(value, 0u, 1024u, options.threads);
+			}
+
+			if (!valid)
+			{
+				error = std::format("{}{} {}", txt::ERR_CLI_INVALID_VALUE, arg, value);
+				return std::nullopt;
+			}
+		}
+		return args;
+	}
+
+	// 通配符匹配：* 匹配任意长度，? 匹配单个字符
+	static bool wildcard_match(const std::string_view pattern, const std::string_view name)
+	{
+		std::size_t p = 0, n = 0;
+		std::size_t star = std::string_view::npos, resume = 0;
+		while (n < name.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+			{
+				++p;
+				++n;
+			}
+			else if (p < pattern.size() && pattern[p] == '*')
+			{
+				star   = p++;
+				resume = n;
+			}
+			else if (star != std::string_view::npos)
+			{
+				p = star + 1;
+				n = ++resume;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while (p < pattern.size() && pattern[p] == '*')
+		{
+			++p;
+		}
+		return p == pattern.size();
+	}
+
+	/**
+	 * @brief 展开输入参数：文件原样保留，目录与通配符（仅限文件名部分）展开为其中支持的文件
+	 *
+	 * Windows 的命令行不展开通配符，因此在这里自行处理。同一文件只保留一次，每个参数的展开结果按文件名排序。
+	 * @return 展开后的文件列表；任一参数没有匹配到文件时返回空并写入 error
+	 */
+	static std::vector<fs::path> expand_inputs(const std::vector<std::string> &inputs, std::string &error)
+	{
+		std::vector<fs::path> sources;
+		std::set<fs::path>	  seen;
+		for (const auto &input: inputs)
+		{
+			const fs::path		  path(input);
+			const std::string	  pattern = path.filename().string();
+			std::vector<fs::path> matches;
+			std::error_code		  ec;
+
+			if (pattern.find_first_of("*?") != std::string::npos)
+			{
+				const fs::path dir = path.has_parent_path() ? path.parent_path() : fs::path(".");
+				for (const auto &entry: fs::directory_iterator(dir, ec))
+				{
+					if (entry.is_regular_file(ec) && wildcard_match(pattern, entry.path().filename().string()) && ShowcaseProcessor::is_supported(entry.path()))
+					{
+						matches.push_back(entry.path());
+					}
+				}
+			}
+			else if (fs::is_directory(path, ec))
+			{
+				for (const auto &entry: fs::directory_iterator(path, ec))
+				{
+					if (entry.is_regular_file(ec) && ShowcaseProcessor::is_supported(entry.path()))
+					{
+						matches.push_back(entry.path());
+					}
+				}
+			}
+			else if (fs::is_regular_file(path, ec))
+			{
+				matches.push_back(path);
+			}
+
+			if (matches.empty())
+			{
+				error = std::format("{}{}", txt::ERR_CLI_INPUT_MISSING, input);
+				return {};
+			}
+			std::ranges::sort(matches);
+			for (auto &match: matches)
+			{
+				if (seen.insert(fs::weakly_canonical(match, ec)).second)
+				{
+					sources.push_back(std::move(match));
+				}
+			}
+		}
+		return sources;
+	}
+
+	int Run(const int argc, char *argv[])
+	{
+		std::string error;
+		const auto	args = parse_arguments(argc, argv, error);
+		if (!args)
+		{
+			std::cerr << error << "\n\n" << txt::CLI_USAGE;
+			return EXIT_USAGE;
+		}
+		if (args->help)
+		{
+			std::cout << txt::CLI_USAGE;
+			return EXIT_OK;
+		}
+		if (args->inputs.empty())
+		{
+			std::cerr << txt::ERR_CLI_NO_INPUT << "\n\n" << txt::CLI_USAGE;
+			return EXIT_USAGE;
+		}
+
+		const auto sources = expand_inputs(args->inputs, error);
+		if (sources.empty())
+		{
+			std::cerr << error << '\n';
+			return EXIT_USAGE;
+		}
+
+		std::error_code ec;
+		fs::create_directories(args->output_dir, ec);
+		if (!fs::is_directory(args->output_dir))
+		{
+			std::cerr << txt::ERR_CLI_OUTPUT_DIR << args->output_dir.string() << '\n';
+			return EXIT_FAILED;
+		}
+
+		std::signal(SIGINT, on_interrupt);
+		std::signal(SIGTERM, on_interrupt);
+
+		const auto start_time = std::chrono::steady_clock::now();
+		emit(std::format(R"({{"event":"start","files":{},"output":"{}"}})", sources.size(), json_escape(args->output_dir.string())));
+
+		// 逐帧计数的进度消息与 progress 事件重复，不再作为日志输出
+		auto on_update = [](const std::string_view message)
+		{
+			if (message.find(txt::LOG_ENCODING) == std::string_view::npos)
+			{
+				emit(std::format(R"({{"event":"log","message":"{}"}})", json_escape(message)));
+			}
+		};
+
+		// 进程结束即丢弃帧缓存，填充它只会多复制一遍帧数据，还可能向临时目录溢出大量数据
+		TaskOptions options = args->options;
+		options.frame_cache = false;
+
+		ShowcaseProcessor processor;
+		const JobHandle	  job = sources.size() == 1
+									? processor.submit(sources.front(), args->output_dir, options, on_update)
+									: processor.submit_batch(sources, args->output_dir, options, on_update, options.threads);
+
+		const JobProgress &progress	   = job.progress();
+		std::size_t		   last_frames = 0;
+		std::size_t		   last_files  = 0;
+		while (job.result().wait_for(PROGRESS_INTERVAL) != std::future_status::ready)
+		{
+			if (interrupted && !job.stop_token().stop_requested())
+			{
+				job.cancel();
+			}
+			if (progress.frames.load() != last_frames || progress.files_done.load() != last_files)
+			{
+				last_frames = progress.frames.load();
+				last_files	= progress.files_done.load();
+				emit_progress(progress);
+			}
+		}
+		emit_progress(progress);
+
+		const bool ok		  = job.result().get();
+		const bool cancelled  = job.stop_token().stop_requested();
+		const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+		emit(std::format(R"({{"event":"done","ok":{},"cancelled":{},"files_done":{},"failures":{},"elapsed_ms":{}}})",
+						 ok,
+						 cancelled,
+						 progress.files_done.load(),
+						 progress.failures.load(),
+						 elapsed_ms));
+
+		if (ok)
+		{
+			return EXIT_OK;
+		}
+		return cancelled ? EXIT_INTERRUPTED : EXIT_FAILED;
+	}
+} // namespace SteamShowcaseGen::Cli
@@ -0,0 +1,10 @@
+#include "cli.h"
+#include "ssg_core.h"
+
+namespace ssg = SteamShowcaseGen;
+
+int main(int argc, char *argv[])
+{
+	ssg::ShowcaseProcessor::silence_library_logs();
+	return ssg::Cli::Run(argc, argv);
+}
@@ -0,0 +1,46 @@
+#include "cpu_features.h"
+
+#if SSG_ARCH_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace SteamShowcaseGen
+{
+	static CpuFeatures detect_cpu_features()
+	{
+		CpuFeatures features;
+#if SSG_ARCH_X86 && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+
+		__cpuid(info, 1);
+		features.sse41		 = (info[2] & (1 << 19)) != 0;
+		const bool os_xsave	 = (info[2] & (1 << 27)) != 0;
+		const auto xcr0		 = os_xsave ? _xgetbv(0) : 0;
+		const bool os_avx	 = (xcr0 & 0x06) == 0x06; // XMM + YMM 状态
+		const bool os_avx512 = (xcr0 & 0xE6) == 0xE6; // 另加 opmask + ZMM 状态
+
+		if (max_leaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			features.avx2	= os_avx && (info[1] & (1 << 5)) != 0;
+			features.avx512 = os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+		}
+#elif SSG_ARCH_X86 && (defined(__GNUC__) || defined(__clang__))
+		// __builtin_cpu_supports 已同时检查操作系统是否保存扩展寄存器状态
+		__builtin_cpu_init();
+		features.sse41	= __builtin_cpu_supports("sse4.1");
+		features.avx2	= __builtin_cpu_supports("avx2");
+		features.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+		return features;
+	}
+
+	const CpuFeatures &cpu_features()
+	{
+		static const CpuFeatures features = detect_cpu_features();
+		return features;
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,168 @@
+#include "dither.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int BAYER_SIZE	  = 8;
+		constexpr int BLUE_NOISE_SIZE = 64;
+
+		// void-and-cluster 的高斯能量核标准差（Ulichney 推荐值）
+		constexpr double BLUE_NOISE_SIGMA = 1.5;
+
+		ThresholdMatrix generate_bayer()
+		{
+			ThresholdMatrix m{BAYER_SIZE, std::vector<uint16_t>(BAYER_SIZE * BAYER_SIZE)};
+			for (int y = 0; y < BAYER_SIZE; ++y)
+			{
+				for (int x = 0; x < BAYER_SIZE; ++x)
+				{
+					// 将 (x ^ y, y) 的各位按低位在高的顺序交错，即递归定义 M(2n) = [4M, 4M+2; 4M+3, 4M+1]
+					int v = 0;
+					for (int bit = 0; bit < 3; ++bit)
+					{
+						v = (v << 2) | ((((x ^ y) >> bit) & 1) << 1) | ((y >> bit) & 1);
+					}
+					m.ranks[y * BAYER_SIZE + x] = static_cast<uint16_t>(v);
+				}
+			}
+			return m;
+		}
+
+		/**
+		 * @brief void-and-cluster 生成蓝噪声阈值矩阵
+		 *
+		 * 在环面上以高斯核衡量每个位置周围已点亮像素的“能量”：
+		 * 能量最高的亮点是最密集的簇，能量最低的暗点是最大的空洞。
+		 * 先松弛一个随机初始图案，再依次移除簇、填补空洞，按顺序赋予排名。
+		 */
+		ThresholdMatrix generate_blue_noise()
+		{
+			constexpr int n		= BLUE_NOISE_SIZE;
+			constexpr int mask	= n - 1;
+			constexpr int count = n * n;
+			static_assert((n & mask) == 0, "blue noise size must be a power of two");
+
+			std::vector<float> kernel(count);
+			for (int dy = 0; dy < n; ++dy)
+			{
+				for (int dx = 0; dx < n; ++dx)
+				{
+					const int wx = std::min(dx, n - dx);
+					const int wy = std::min(dy, n - dy);
+
+					kernel[dy * n + dx] = static_cast<float>(std::exp(-(wx * wx + wy * wy) / (2.0 * BLUE_NOISE_SIGMA * BLUE_NOISE_SIGMA)));
+				}
+			}
+
+			std::vector<uint8_t> pattern(count, 0);
+			std::vector<float>	 energy(count, 0.0f);
+
+			auto toggle = [&](const int idx, const bool on)
+			{
+				pattern[idx]	  = on ? 1 : 0;
+				const float sign  = on ? 1.0f : -1.0f;
+				const int	py	  = idx / n;
+				const int	px	  = idx % n;
+				for (int y = 0; y < n; ++y)
+				{
+					const float *k = kernel.data() + ((y - py) & mask) * n;
+					float		*e = energy.data() + y * n;
+					for (int x = 0; x < n; ++x)
+					{
+						e[x] += sign * k[(x - px) & mask];
+					}
+				}
+			};
+			auto tightest_cluster = [&]
+			{
+				int best = -1;
+				for (int i = 0; i < count; ++i)
+				{
+					if (pattern[i] && (best < 0 || energy[i] > energy[best]))
+					{
+						best = i;
+					}
+				}
+				return best;
+			};
+			auto largest_void = [&]
+			{
+				int best = -1;
+				for (int i = 0; i < count; ++i)
+				{
+					if (!pattern[i] && (best < 0 || energy[i] < energy[best]))
+					{
+						best = i;
+					}
+				}
+				return best;
+			};
+
+			// 1. 随机初始图案（约 10% 点亮）；mt19937 的输出序列由标准规定，结果跨平台一致
+			std::mt19937 rng(0x5EED);
+			const int	 initial_ones = count / 10;
+			for (int placed = 0; placed < initial_ones;)
+			{
+				const int idx = static_cast<int>(rng() % count);
+				if (!pattern[idx])
+				{
+					toggle(idx, true);
+					++placed;
+				}
+			}
+
+			// 2. 松弛：把最密集的簇移到最大的空洞，直到移动回原位
+			for (int iter = 0; iter < count; ++iter)
+			{
+				const int cluster = tightest_cluster();
+				toggle(cluster, false);
+				const int hole = largest_void();
+				toggle(hole, true);
+				if (hole == cluster)
+				{
+					break;
+				}
+			}
+
+			const auto initial_pattern = pattern;
+			const auto initial_energy  = energy;
+
+			ThresholdMatrix m{n, std::vector<uint16_t>(count)};
+
+			// 3. 依次移除最密集的簇，排名从 initial_ones - 1 递减
+			for (int rank = initial_ones - 1; rank >= 0; --rank)
+			{
+				const int cluster = tightest_cluster();
+				toggle(cluster, false);
+				m.ranks[cluster] = static_cast<uint16_t>(rank);
+			}
+
+			// 4. 从初始图案起依次填补最大的空洞，排名递增直至填满
+			pattern = initial_pattern;
+			energy	= initial_energy;
+			for (int rank = initial_ones; rank < count; ++rank)
+			{
+				const int hole = largest_void();
+				toggle(hole, true);
+				m.ranks[hole] = static_cast<uint16_t>(rank);
+			}
+			return m;
+		}
+	} // namespace
+
+	const ThresholdMatrix &bayer_matrix()
+	{
+		static const ThresholdMatrix matrix = generate_bayer();
+		return matrix;
+	}
+
+	const ThresholdMatrix &blue_noise_matrix()
+	{
+		static const ThresholdMatrix matrix = generate_blue_noise();
+		return matrix;
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,379 @@
+#include "encode_stage.h"
+#include <cstring>
+#include <thread>
+#include "frame_dedup.h"
+#include "frame_delta.h"
+#include "gif_writer.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+namespace SteamShowcaseGen
+{
+	/**
+	 * @brief 单个切片的编码阶段
+	 *
+	 * 帧间增量、去重与写出器状态依赖帧的先后顺序，本切片的编码任务经 Strand 在共享调度器上逐帧串行执行；
+	 * 不同切片、不同任务的编码彼此并行，且不各自占用线程。
+	 */
+	struct EncodeStage::SliceEncoder
+	{
+		using FreeQueue = BoundedQueue<FrameSlot *, FRAME_SLOT_COUNT>;
+
+		SliceEncoder(
+			ThreadPool &pool, EncoderState &state, const int index, const TaskOptions &options, const std::stop_token &stop, FreeQueue &free_queue)
+			: state(state), index(index), dedup(options.dedup, options.dedup_threshold), stop(stop), free_queue(free_queue), strand(pool)
+		{
+		}
+
+		// 编码本切片的一帧；全部切片都完成后归还帧槽
+		void encode(FrameSlot &slot)
+		{
+			if (!stop.stop_requested())
+			{
+				encode_slice_frame(state, delta, dedup, slot.scaled[index], slot.quantized[index], slot.pts, slot.colors, slot.transparent);
+			}
+			if (slot.pending.fetch_sub(1) == 1)
+			{
+				free_queue.push(&slot);
+			}
+		}
+
+		EncoderState		  &state;
+		const int			   index;
+		FrameDelta			   delta;
+		DuplicateDetector	   dedup;
+		const std::stop_token &stop;
+		FreeQueue			  &free_queue;
+		Strand				   strand; // 最后声明：析构时最先等待已提交的编码任务完成
+	};
+
+	EncodeStage::EncodeStage(ThreadPool				   &pool,
+							 std::vector<EncoderState> &encoders,
+							 const int					height,
+							 const TaskOptions		   &options,
+							 Quantizer				   &quantizer,
+							 const PaletteMode			palette_mode,
+							 const int					palette_colors,
+							 const std::stop_token	   &stop,
+							 ScaledHook					on_scaled)
+		: pool_(pool),
+		  quantizer_(quantizer),
+		  palette_mode_(palette_mode),
+		  palette_colors_(palette_colors),
+		  reserve_transparent_(options.delta_frames),
+		  sws_flags_(SliceScaler::select_sws_flags(options.quality_mode)),
+		  stop_(stop),
+		  on_scaled_(std::move(on_scaled)),
+		  quantize_strand_(pool)
+	{
+		// 全部切片平面取自一次分配的帧池。自研后端预热后逐帧处理不再分配内存（量化到写出由 steady_state_alloc 测试检查），
+		// 余下的只有解复用器的数据包缓冲（见 VideoDecoder::decode_next）；libavcodec 后端的编码器另为每帧输出的数据包分配缓冲
+		const int		  width = SliceScaler::SLICE_WIDTH;
+		const std::size_t slice_bytes =
+			FramePool::frame_bytes(width, height, AV_PIX_FMT_BGRA) + FramePool::frame_bytes(width, height, AV_PIX_FMT_PAL8);
+		ready_ = frame_pool_.reserve(FRAME_SLOT_COUNT * SLICE_COUNT * slice_bytes);
+		for (auto &slot: slots_)
+		{
+			slot.frame = av_frame_alloc();
+			ready_	   = ready_ && slot.frame;
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				slot.scaled[i]	  = frame_pool_.acquire(width, height, AV_PIX_FMT_BGRA);
+				slot.quantized[i] = frame_pool_.acquire(width, height, AV_PIX_FMT_PAL8);
+				ready_			  = ready_ && slot.scaled[i] && slot.quantized[i];
+			}
+			free_queue_.push(&slot);
+		}
+
+		slice_encoders_.reserve(SLICE_COUNT);
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			slice_encoders_.push_back(std::make_unique<SliceEncoder>(pool, encoders[i], i, options, stop, free_queue_));
+		}
+	}
+
+	EncodeStage::~EncodeStage()
+	{
+		wait_idle();
+		for (auto &slot: slots_)
+		{
+			av_frame_free(&slot.frame);
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				av_frame_free(&slot.scaled[i]);
+				av_frame_free(&slot.quantized[i]);
+				sws_freeContext(slot.sws[i]);
+			}
+		}
+	}
+
+	EncodeStage::FrameSlot *EncodeStage::acquire()
+	{
+		const auto slot = free_queue_.pop();
+		if (!slot)
+		{
+			return nullptr;
+		}
+		// submit() 持有一份计数，缩放任务提交前后本帧都不会被提前量化
+		(*slot)->scaling.store(1);
+		(*slot)->scale_failed.store(false);
+		return *slot;
+	}
+
+	void EncodeStage::scale(FrameSlot &slot)
+	{
+		// SwsContext 不是线程安全的：在途的各帧同时缩放，每个任务只使用所属帧槽的上下文。
+		// 任务以帧槽序号与切片序号编成一个整数，只捕获它与 this，post 逐帧提交不产生堆分配
+		const int first = static_cast<int>(&slot - slots_.data()) * SLICE_COUNT;
+		slot.scaling.fetch_add(SLICE_COUNT);
+		scale_tasks_.fetch_add(SLICE_COUNT);
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			pool_.post([this, task = first + i] { scale_slice(task); });
+		}
+	}
+
+	void EncodeStage::scale_slice(const int task)
+	{
+		FrameSlot &slot	 = slots_[task / SLICE_COUNT];
+		const int  index = task % SLICE_COUNT;
+		if (!SliceScaler::scale(slot.sws[index], sws_flags_, SliceScaler::map_source(*slot.frame, index), slot.scaled[index]))
+		{
+			slot.scale_failed.store(true);
+		}
+		if (slot.scaling.fetch_sub(1) == 1)
+		{
+			dispatch_scaled();
+		}
+		scale_tasks_.fetch_sub(1, std::memory_order_release); // 此后不再访问本对象
+	}
+
+	void EncodeStage::submit(FrameSlot &slot)
+	{
+		{
+			std::lock_guard lock(order_mutex_);
+			order_[(order_head_ + order_count_) % order_.size()] = &slot;
+			++order_count_;
+		}
+		if (slot.scaling.fetch_sub(1) == 1)
+		{
+			dispatch_scaled();
+		}
+	}
+
+	void EncodeStage::dispatch_scaled()
+	{
+		// 各帧的缩放完成顺序不定，量化须按提交顺序进行：只从队首依次交出已缩放完成的帧。
+		// 持锁提交到量化 Strand，保证 Strand 中的顺序与出队顺序一致
+		std::lock_guard lock(order_mutex_);
+		while (order_count_ > 0 && order_[order_head_]->scaling.load() == 0)
+		{
+			FrameSlot *slot = order_[order_head_];
+			order_head_		= (order_head_ + 1) % order_.size();
+			--order_count_;
+			quantize_strand_.post([this, slot] { quantize(*slot); });
+		}
+	}
+
+	void EncodeStage::wait_idle()
+	{
+		// 缩放任务在交出帧之后才返回，须先等待其全部返回，量化 Strand 中才不会再有新任务
+		while (scale_tasks_.load(std::memory_order_acquire) != 0)
+		{
+			if (!pool_.run_pending())
+			{
+				std::this_thread::yield();
+			}
+		}
+		quantize_strand_.wait_idle();
+		for (auto &encoder: slice_encoders_)
+		{
+			encoder->strand.wait_idle();
+		}
+	}
+
+	int EncodeStage::merged_frames() const
+	{
+		int merged = 0;
+		for (const auto &encoder: slice_encoders_)
+		{
+			merged += encoder->dedup.skipped();
+		}
+		return merged;
+	}
+
+	void EncodeStage::quantize(FrameSlot &slot)
+	{
+		// 本帧的缩放已全部完成（见 dispatch_scaled）。缩放失败的帧槽中是上一帧的像素，不能编码；之后的帧也一并丢弃，输出不再完整
+		if (slot.scale_failed.load())
+		{
+			failed_.store(true);
+		}
+		if (stop_.stop_requested() || failed_.load())
+		{
+			free_queue_.push(&slot);
+			return;
+		}
+		if (on_scaled_)
+		{
+			on_scaled_(slot);
+		}
+		slot.transparent = quantize_slices(slot.scaled, slot.quantized, palette_mode_, palette_colors_, reserve_transparent_, histogram_, quantizer_);
+		slot.colors		 = quantizer_.palette().size + (slot.transparent >= 0 ? 1 : 0);
+		slot.pending.store(SLICE_COUNT);
+		for (auto &encoder: slice_encoders_)
+		{
+			encoder->strand.post([&slice = *encoder, &slot] { slice.encode(slot); });
+		}
+	}
+
+	int EncodeStage::quantize_slices(const SliceFrames &scaled,
+									 const SliceFrames &quantized,
+									 const PaletteMode	mode,
+									 const int			max_colors,
+									 const bool			reserve_transparent,
+									 ColorHistogram	   &histogram,
+									 Quantizer		   &quantizer)
+	{
+		// 逐帧模式：五个切片合并统计一次直方图，共用同一个调色板，切片接缝处颜色一致
+		if (mode == PaletteMode::PerFrame)
+		{
+			histogram.clear();
+			for (const AVFrame *src: scaled)
+			{
+				histogram.add(src->data[0], src->linesize[0], src->width, src->height);
+			}
+			quantizer.set_palette(histogram.build_palette(max_colors));
+		}
+
+		// 紧随有效颜色之后的表项作为透明色：量化器不会映射到它，且 alpha 为 0 时编码器会将其识别为透明索引
+		const Palette &palette	   = quantizer.palette();
+		const int	   transparent = reserve_transparent && palette.size < 256 ? palette.size : -1;
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			AVFrame *dst = quantized[i];
+			if (av_frame_make_writable(dst) < 0)
+			{
+				continue;
+			}
+			quantizer.map(scaled[i]->data[0], scaled[i]->linesize[0], dst->width, dst->height, dst->data[0], dst->linesize[0]);
+			std::memcpy(dst->data[1], palette.colors.data(), sizeof(palette.colors));
+			if (transparent >= 0)
+			{
+				reinterpret_cast<uint32_t *>(dst->data[1])[transparent] = 0x00000000u;
+			}
+		}
+		return transparent;
+	}
+
+	// 核心改进：修复了重复分支与性能问题的编码函数
+	void EncodeStage::encode_raw_frame(EncoderState &state, const AVFrame *raw_frame)
+	{
+		if (!state.codec_ctx)
+		{
+			return;
+		}
+
+		// 1. 发送帧
+		if (const int ret = avcodec_send_frame(state.codec_ctx, raw_frame); ret < 0)
+		{
+			return;
+		}
+
+		// 2. Packet 随编码状态分配一次，在各帧及各任务之间复用
+		if (!state.packet)
+		{
+			state.packet = av_packet_alloc();
+			if (!state.packet)
+			{
+				return;
+			}
+		}
+		AVPacket *pkt = state.packet;
+
+		// 3. 循环接收所有编码好的包。只要返回 0 说明有新数据
+		while (avcodec_receive_packet(state.codec_ctx, pkt) == 0)
+		{
+			// 时间戳转换
+			av_packet_rescale_ts(pkt, state.codec_ctx->time_base, state.stream->time_base);
+			pkt->stream_index = state.stream->index;
+
+			// 写入封装层
+			av_interleaved_write_frame(state.fmt_ctx, pkt);
+
+			// 重要：清除 packet 的 buffer 引用，以便下一次循环复用结构体
+			av_packet_unref(pkt);
+		}
+	}
+
+	void EncodeStage::push_frame(
+		EncoderState &state, AVFrame *quantized, const int64_t pts, const DeltaRect &rect, const int colors, const int transparent)
+	{
+		if ((!state.codec_ctx && !state.uses_native()) || !quantized)
+		{
+			return;
+		}
+
+		state.last_pts = pts;
+		++state.frame_count;
+
+		// 自研后端只压缩变化区域；libavcodec 后端由编码器自行裁掉四周的透明边框
+		if (state.uses_native())
+		{
+			const auto *palette = reinterpret_cast<const uint32_t *>(quantized->data[1]);
+			state.native->add_frame(quantized->data[0], quantized->linesize[0], rect, palette, colors, transparent, pts);
+			return;
+		}
+
+		// GIF 编码器保留上一帧的引用用于比较。直接送入帧槽的平面时，帧槽回到量化阶段时引用往往尚未释放，
+		// av_frame_make_writable 只能重新分配并复制；改为复制到两帧交替的发送缓冲，编码器引用的总是另一帧
+		AVFrame *&send = state.send_frames[state.frame_count & 1];
+		if (send && (send->width != quantized->width || send->height != quantized->height))
+		{
+			av_frame_free(&send);
+		}
+		if (!send)
+		{
+			send = SliceScaler::alloc_frame(quantized->width, quantized->height, AV_PIX_FMT_PAL8);
+		}
+		if (!send || av_frame_make_writable(send) < 0 || av_frame_copy(send, quantized) < 0)
+		{
+			return;
+		}
+		send->pts = pts;
+		encode_raw_frame(state, send);
+	}
+
+	bool EncodeStage::encode_slice_frame(EncoderState	   &state,
+										 FrameDelta		   &delta,
+										 DuplicateDetector &dedup,
+										 const AVFrame	   *scaled,
+										 AVFrame		   *quantized,
+										 const int64_t		pts,
+										 const int			colors,
+										 const int			transparent)
+	{
+		// 重复帧不编码：下一帧的时间戳更晚，上一帧的显示时长随之自然延长
+		const auto *palette = reinterpret_cast<const uint32_t *>(quantized->data[1]);
+		if (dedup.is_duplicate(
+				scaled->data[0], scaled->linesize[0], quantized->data[0], quantized->linesize[0], palette, quantized->width, quantized->height))
+		{
+			return false;
+		}
+
+		DeltaRect rect{0, 0, quantized->width, quantized->height};
+		if (transparent >= 0)
+		{
+			rect = delta.apply(
+				quantized->data[0], quantized->linesize[0], quantized->width, quantized->height, palette, static_cast<uint8_t>(transparent));
+		}
+		push_frame(state, quantized, pts, rect, colors, transparent);
+		return true;
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,115 @@
+#include "encoder_pool.h"
+#include <utility>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+namespace SteamShowcaseGen
+{
+	EncoderState::~EncoderState()
+	{
+		release_codec();
+		av_packet_free(&packet);
+		for (AVFrame *&frame: send_frames)
+		{
+			av_frame_free(&frame);
+		}
+		sws_freeContext(sws_ctx);
+	}
+
+	EncoderState::EncoderState(EncoderState &&other) noexcept
+	{
+		swap(other);
+	}
+
+	EncoderState &EncoderState::operator=(EncoderState &&other) noexcept
+	{
+		EncoderState moved(std::move(other));
+		swap(moved);
+		return *this;
+	}
+
+	void EncoderState::swap(EncoderState &other) noexcept
+	{
+		std::swap(fmt_ctx, other.fmt_ctx);
+		std::swap(codec_ctx, other.codec_ctx);
+		std::swap(stream, other.stream);
+		std::swap(packet, other.packet);
+		std::swap(send_frames, other.send_frames);
+		std::swap(native, other.native);
+		std::swap(sws_ctx, other.sws_ctx);
+		std::swap(sws_flags, other.sws_flags);
+		std::swap(frame_count, other.frame_count);
+		std::swap(last_pts, other.last_pts);
+		std::swap(final_delay, other.final_delay);
+	}
+
+	void EncoderState::reset()
+	{
+		release_codec();
+		frame_count = 0;
+		last_pts	= -1;
+		final_delay = -1;
+	}
+
+	void EncoderState::release_codec()
+	{
+		avcodec_free_context(&codec_ctx);
+		if (fmt_ctx)
+		{
+			if (fmt_ctx->pb && !(fmt_ctx->oformat->flags & AVFMT_NOFILE))
+			{
+				avio_closep(&fmt_ctx->pb);
+			}
+			avformat_free_context(fmt_ctx);
+			fmt_ctx = nullptr;
+		}
+		stream = nullptr;
+	}
+
+	std::vector<EncoderState> EncoderPool::acquire(const Key &key, const std::size_t count)
+	{
+		std::vector<EncoderState> states;
+		states.reserve(count);
+		{
+			std::lock_guard lock(mutex_);
+			for (auto it = idle_.begin(); it != idle_.end() && states.size() < count;)
+			{
+				if (it->key == key)
+				{
+					states.push_back(std::move(it->state));
+					it = idle_.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+		states.resize(count);
+		for (auto &state: states)
+		{
+			state.reset();
+		}
+		return states;
+	}
+
+	void EncoderPool::release(const Key &key, std::vector<EncoderState> &&states)
+	{
+		std::lock_guard lock(mutex_);
+		for (auto &state: states)
+		{
+			state.reset();
+			idle_.push_back({key, std::move(state)});
+		}
+		if (idle_.size() > MAX_IDLE)
+		{
+			idle_.erase(idle_.begin(), idle_.begin() + static_cast<std::ptrdiff_t>(idle_.size() - MAX_IDLE));
+		}
+		states.clear();
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,274 @@
+#include "frame_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <new>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace SteamShowcaseGen
+{
+	FrameCacheKey FrameCacheKey::of(const std::filesystem::path &path, const int height, const int sws_flags, const double frame_rate, const int max_frames)
+	{
+		std::error_code ec;
+		const auto		time = std::filesystem::last_write_time(path, ec);
+
+		FrameCacheKey key;
+		key.path	   = path;
+		key.mtime	   = ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+		key.height	   = height;
+		key.sws_flags  = sws_flags;
+		key.frame_rate = frame_rate;
+		key.max_frames = max_frames;
+		return key;
+	}
+
+	/**
+	 * @brief 溢出用的临时文件及其映射，扩容时改变文件长度后重新映射整个文件
+	 */
+	struct FrameCache::SpillFile
+	{
+#ifdef _WIN32
+		HANDLE file	   = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#else
+		int fd = -1;
+#endif
+		uint8_t		*base	  = nullptr;
+		std::size_t capacity = 0; // 当前映射的字节数
+
+		SpillFile() = default;
+		~SpillFile()
+		{
+			unmap();
+#ifdef _WIN32
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file); // FILE_FLAG_DELETE_ON_CLOSE：关闭即删除
+			}
+#else
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+#endif
+		}
+
+		SpillFile(const SpillFile &)			= delete;
+		SpillFile &operator=(const SpillFile &) = delete;
+
+		bool open()
+		{
+			std::error_code ec;
+			const auto		dir = std::filesystem::temp_directory_path(ec);
+			if (ec)
+			{
+				return false;
+			}
+#ifdef _WIN32
+			static std::atomic<unsigned> counter{0};
+			const auto path = dir / std::format("ssg_frames_{}_{}.tmp", GetCurrentProcessId(), counter.fetch_add(1));
+			file			= CreateFileW(path.c_str(),
+								  GENERIC_READ | GENERIC_WRITE,
+								  0,
+								  nullptr,
+								  CREATE_NEW,
+								  FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+								  nullptr);
+			return file != INVALID_HANDLE_VALUE;
+#else
+			// 创建后立即删除目录项，文件随描述符关闭自动回收
+			std::string name = (dir / "ssg_frames_XXXXXX").string();
+			fd				 = mkstemp(name.data());
+			if (fd < 0)
+			{
+				return false;
+			}
+			::unlink(name.c_str());
+			return true;
+#endif
+		}
+
+		void unmap()
+		{
+			if (!base)
+			{
+				return;
+			}
+#ifdef _WIN32
+			UnmapViewOfFile(base);
+			CloseHandle(mapping);
+			mapping = nullptr;
+#else
+			munmap(base, capacity);
+#endif
+			base	 = nullptr;
+			capacity = 0;
+		}
+
+		bool resize(const std::size_t bytes)
+		{
+			unmap();
+#ifdef _WIN32
+			LARGE_INTEGER size;
+			size.QuadPart = static_cast<LONGLONG>(bytes);
+			if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+			{
+				return false;
+			}
+			mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes), nullptr);
+			if (!mapping)
+			{
+				return false;
+			}
+			base = static_cast<uint8_t *>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+			if (!base)
+			{
+				CloseHandle(mapping);
+				mapping = nullptr;
+				return false;
+			}
+#else
+			if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+			{
+				return false;
+			}
+			void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (p == MAP_FAILED)
+			{
+				return false;
+			}
+			base = static_cast<uint8_t *>(p);
+#endif
+			capacity = bytes;
+			return true;
+		}
+	};
+
+	void FrameCache::AlignedDelete::operator()(uint8_t *p) const
+	{
+		::operator delete[](p, std::align_val_t{ALIGNMENT});
+	}
+
+	FrameCache::FrameCache(const std::size_t memory_budget)
+		: memory_budget_(memory_budget)
+	{
+	}
+
+	FrameCache::~FrameCache() = default;
+
+	void FrameCache::reset(const std::size_t frame_bytes, const std::size_t expected_frames)
+	{
+		const std::size_t aligned = (frame_bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		if (aligned != frame_bytes_)
+		{
+			chunks_.clear();
+			memory_capacity_ = 0;
+		}
+		spill_.reset();
+		memory_count_	 = 0;
+		spill_count_	 = 0;
+		frame_bytes_	 = aligned;
+		expected_frames_ = expected_frames;
+
+		// 按预计帧数一次分配，之后的追加不再触及堆
+		if (frame_bytes_ > 0 && expected_frames_ > memory_capacity_)
+		{
+			add_chunk(expected_frames_ - memory_capacity_);
+		}
+	}
+
+	bool FrameCache::add_chunk(const std::size_t frames)
+	{
+		const std::size_t budget_frames = memory_budget_ / frame_bytes_;
+		const std::size_t count			= std::min(frames, budget_frames > memory_capacity_ ? budget_frames - memory_capacity_ : 0);
+		if (count == 0)
+		{
+			return false;
+		}
+
+		auto *p = static_cast<uint8_t *>(::operator new[](count * frame_bytes_, std::align_val_t{ALIGNMENT}, std::nothrow));
+		if (!p)
+		{
+			return false;
+		}
+		chunks_.push_back({std::unique_ptr<uint8_t[], AlignedDelete>(p), count});
+		memory_capacity_ += count;
+		return true;
+	}
+
+	uint8_t *FrameCache::append()
+	{
+		if (frame_bytes_ == 0)
+		{
+			return nullptr;
+		}
+
+		// 1. 预算以内：使用已分配的内存块，用尽时追加一块
+		if (spill_count_ == 0 && (memory_count_ < memory_capacity_ || add_chunk(std::max(MIN_CHUNK_FRAMES, memory_capacity_ / 2))))
+		{
+			return frame(memory_count_++);
+		}
+
+		// 2. 超出预算：写入临时文件映射，容量不足时按预计剩余帧数（至少翻倍）扩容
+		if (!spill_)
+		{
+			spill_ = std::make_unique<SpillFile>();
+			if (!spill_->open())
+			{
+				spill_.reset();
+				return nullptr;
+			}
+		}
+		const std::size_t needed = (spill_count_ + 1) * frame_bytes_;
+		if (needed > spill_->capacity)
+		{
+			const std::size_t remaining = expected_frames_ > size() ? expected_frames_ - size() : 1;
+			const std::size_t capacity	= std::max({needed, spill_->capacity * 2, (spill_count_ + remaining) * frame_bytes_});
+			if (!spill_->resize(capacity))
+			{
+				return nullptr;
+			}
+		}
+		return spill_->base + spill_count_++ * frame_bytes_;
+	}
+
+	void FrameCache::pop_back()
+	{
+		if (spill_count_ > 0)
+		{
+			--spill_count_;
+		}
+		else if (memory_count_ > 0)
+		{
+			--memory_count_;
+		}
+	}
+
+	uint8_t *FrameCache::frame(std::size_t index) const
+	{
+		if (index >= memory_count_)
+		{
+			return spill_->base + (index - memory_count_) * frame_bytes_;
+		}
+		for (const Chunk &chunk: chunks_)
+		{
+			if (index < chunk.frames)
+			{
+				return chunk.data.get() + index * frame_bytes_;
+			}
+			index -= chunk.frames;
+		}
+		return nullptr;
+	}
+} // namespace SteamShowcaseGen
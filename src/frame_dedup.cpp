@@ -0,0 +1,147 @@
+#include "frame_dedup.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSG_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define SSG_HAS_SSE2 0
+#endif
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int PALETTE_ENTRIES = 256;
+
+		// 两段 BGRA 像素的绝对差之和；SSE2 为 x86-64 基线指令集，psadbw 一次处理 4 个像素
+		uint32_t sad_row(const uint8_t *a, const uint8_t *b, const int pixels)
+		{
+			uint32_t sum = 0;
+			int		 x	 = 0;
+#if SSG_HAS_SSE2
+			__m128i acc = _mm_setzero_si128();
+			for (; x + 4 <= pixels; x += 4)
+			{
+				const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + static_cast<std::ptrdiff_t>(x) * 4));
+				const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + static_cast<std::ptrdiff_t>(x) * 4));
+				acc				 = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+			}
+			sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+			for (int i = x * 4; i < pixels * 4; ++i)
+			{
+				sum += static_cast<uint32_t>(std::abs(a[i] - b[i]));
+			}
+			return sum;
+		}
+	} // namespace
+
+	DuplicateDetector::DuplicateDetector(const DedupMode mode, const int threshold)
+		: mode_(mode)
+		, threshold_(std::clamp(threshold, 0, 255))
+	{
+	}
+
+	bool DuplicateDetector::is_duplicate(const uint8_t  *bgra,
+										 const int		 bgra_stride,
+										 const uint8_t  *indices,
+										 const int		 index_stride,
+										 const uint32_t *palette,
+										 const int		 width,
+										 const int		 height)
+	{
+		if (mode_ == DedupMode::Off)
+		{
+			return false;
+		}
+
+		if (valid_ && width == width_ && height == height_)
+		{
+			const bool same = mode_ == DedupMode::Exact ? same_exact(indices, index_stride, palette) : same_perceptual(bgra, bgra_stride);
+			if (same)
+			{
+				++skipped_;
+				return true;
+			}
+		}
+
+		width_	= width;
+		height_ = height;
+		remember(bgra, bgra_stride, indices, index_stride, palette);
+		valid_ = true;
+		return false;
+	}
+
+	bool DuplicateDetector::same_exact(const uint8_t *indices, const int index_stride, const uint32_t *palette) const
+	{
+		if (std::memcmp(palette, palette_.data(), PALETTE_ENTRIES * sizeof(uint32_t)) != 0)
+		{
+			return false;
+		}
+		for (int y = 0; y < height_; ++y)
+		{
+			if (std::memcmp(indices + static_cast<std::ptrdiff_t>(y) * index_stride, reference_.data() + static_cast<std::size_t>(y) * width_, width_) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool DuplicateDetector::same_perceptual(const uint8_t *bgra, const int bgra_stride)
+	{
+		// 逐块比较而非整帧平均：鼠标指针、字幕等局部变化不会被大面积静止画面稀释
+		const int row_bytes = width_ * 4;
+		const int columns	= (width_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		block_sums_.resize(columns);
+		for (int by = 0; by < height_; by += BLOCK_SIZE)
+		{
+			const int rows = std::min(BLOCK_SIZE, height_ - by);
+			std::ranges::fill(block_sums_, 0u);
+			for (int y = by; y < by + rows; ++y)
+			{
+				const uint8_t *cur = bgra + static_cast<std::ptrdiff_t>(y) * bgra_stride;
+				const uint8_t *ref = reference_.data() + static_cast<std::size_t>(y) * row_bytes;
+				for (int bx = 0; bx < columns; ++bx)
+				{
+					const int x0 = bx * BLOCK_SIZE;
+					block_sums_[bx] += sad_row(cur + x0 * 4, ref + x0 * 4, std::min(BLOCK_SIZE, width_ - x0));
+				}
+			}
+			for (int bx = 0; bx < columns; ++bx)
+			{
+				// alpha 恒为不透明，差值只来自三个颜色通道
+				const auto pixels = static_cast<uint32_t>(rows * std::min(BLOCK_SIZE, width_ - bx * BLOCK_SIZE));
+				if (block_sums_[bx] > static_cast<uint32_t>(threshold_) * pixels * 3)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void DuplicateDetector::remember(const uint8_t *bgra, const int bgra_stride, const uint8_t *indices, const int index_stride, const uint32_t *palette)
+	{
+		if (mode_ == DedupMode::Exact)
+		{
+			reference_.resize(static_cast<std::size_t>(width_) * height_);
+			for (int y = 0; y < height_; ++y)
+			{
+				std::memcpy(reference_.data() + static_cast<std::size_t>(y) * width_, indices + static_cast<std::ptrdiff_t>(y) * index_stride, width_);
+			}
+			palette_.assign(palette, palette + PALETTE_ENTRIES);
+			return;
+		}
+
+		const std::size_t row_bytes = static_cast<std::size_t>(width_) * 4;
+		reference_.resize(row_bytes * height_);
+		for (int y = 0; y < height_; ++y)
+		{
+			std::memcpy(reference_.data() + y * row_bytes, bgra + static_cast<std::ptrdiff_t>(y) * bgra_stride, row_bytes);
+		}
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,84 @@
+#include "frame_delta.h"
+#include <algorithm>
+#include "cpu_features.h"
+
+namespace SteamShowcaseGen
+{
+	int DeltaKernels::mark_row_scalar(uint8_t *indices, const int width, const uint32_t *palette, const uint8_t transparent, uint32_t *canvas, int *last)
+	{
+		int first = -1;
+		for (int x = 0; x < width; ++x)
+		{
+			const uint32_t color = palette[indices[x]];
+			if (color == canvas[x])
+			{
+				indices[x] = transparent;
+				continue;
+			}
+			canvas[x] = color;
+			if (first < 0)
+			{
+				first = x;
+			}
+			*last = x;
+		}
+		return first;
+	}
+
+	FrameDelta::FrameDelta()
+		: mark_row_(SSG_ARCH_X86 && cpu_features().avx2 ? DeltaKernels::mark_row_avx2 : DeltaKernels::mark_row_scalar)
+	{
+	}
+
+	void FrameDelta::reset()
+	{
+		valid_ = false;
+	}
+
+	DeltaRect FrameDelta::apply(uint8_t *indices, const int stride, const int width, const int height, const uint32_t *palette, const uint8_t transparent)
+	{
+		// 首帧或尺寸变化：整帧输出，并以其显示颜色初始化画布
+		if (!valid_ || width != width_ || height != height_)
+		{
+			canvas_.resize(static_cast<std::size_t>(width) * height);
+			for (int y = 0; y < height; ++y)
+			{
+				const uint8_t *row = indices + static_cast<std::ptrdiff_t>(y) * stride;
+				uint32_t	  *dst = canvas_.data() + static_cast<std::size_t>(y) * width;
+				for (int x = 0; x < width; ++x)
+				{
+					dst[x] = palette[row[x]];
+				}
+			}
+			width_	= width;
+			height_ = height;
+			valid_	= true;
+			return {0, 0, width, height};
+		}
+
+		int x0 = width, x1 = -1, y0 = height, y1 = -1;
+		for (int y = 0; y < height; ++y)
+		{
+			int		  last	= -1;
+			const int first = mark_row_(indices + static_cast<std::ptrdiff_t>(y) * stride,
+										width,
+										palette,
+										transparent,
+										canvas_.data() + static_cast<std::size_t>(y) * width,
+										&last);
+			if (first >= 0)
+			{
+				x0 = std::min(x0, first);
+				x1 = std::max(x1, last);
+				y0 = std::min(y0, y);
+				y1 = y;
+			}
+		}
+
+		if (x1 < 0)
+		{
+			return {};
+		}
+		return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+	}
+} // namespace SteamShowcaseGen
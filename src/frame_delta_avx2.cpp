@@ -0,0 +1,57 @@
+// 本编译单元以 AVX2 指令集编译，只包含内核声明与 intrinsics 头文件
+#include "cpu_features.h"
+#include "delta_kernels.h"
+
+#if SSG_ARCH_X86
+#include <bit>
+#include <immintrin.h>
+
+namespace SteamShowcaseGen::DeltaKernels
+{
+	int mark_row_avx2(uint8_t *indices, const int width, const uint32_t *palette, const uint8_t transparent, uint32_t *canvas, int *last)
+	{
+		const __m128i trans = _mm_set1_epi8(static_cast<char>(transparent));
+
+		int first = -1;
+		int x	  = 0;
+		for (; x + 8 <= width; x += 8)
+		{
+			// 8 个索引 -> 以 4 字节步长 gather 调色板得到显示颜色，与画布逐像素比较
+			const __m128i idx	= _mm_loadl_epi64(reinterpret_cast<const __m128i *>(indices + x));
+			const __m256i color = _mm256_i32gather_epi32(reinterpret_cast<const int *>(palette), _mm256_cvtepu8_epi32(idx), 4);
+			const __m256i prev	= _mm256_loadu_si256(reinterpret_cast<const __m256i *>(canvas + x));
+			const __m256i same	= _mm256_cmpeq_epi32(color, prev);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(canvas + x), color);
+
+			const auto changed = static_cast<unsigned>(~_mm256_movemask_ps(_mm256_castsi256_ps(same))) & 0xFFu;
+			if (changed != 0xFFu)
+			{
+				// 比较结果收窄为 8 个字节掩码，未变化的像素替换为透明色
+				const __m128i same16 = _mm_packs_epi32(_mm256_castsi256_si128(same), _mm256_extracti128_si256(same, 1));
+				const __m128i same8	 = _mm_packs_epi16(same16, same16);
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(indices + x), _mm_blendv_epi8(idx, trans, same8));
+			}
+			if (changed)
+			{
+				if (first < 0)
+				{
+					first = x + std::countr_zero(changed);
+				}
+				*last = x + 31 - std::countl_zero(changed);
+			}
+		}
+
+		int		  tail_last	 = -1;
+		const int tail_first = mark_row_scalar(indices + x, width - x, palette, transparent, canvas + x, &tail_last);
+		if (tail_first >= 0)
+		{
+			if (first < 0)
+			{
+				first = x + tail_first;
+			}
+			*last = x + tail_last;
+		}
+		return first;
+	}
+} // namespace SteamShowcaseGen::DeltaKernels
+#endif
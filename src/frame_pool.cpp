@@ -0,0 +1,124 @@
+#include "frame_pool.h"
+#include <array>
+#include <new>
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+}
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr std::size_t align_up(const std::size_t value)
+		{
+			return (value + FramePool::ALIGNMENT - 1) / FramePool::ALIGNMENT * FramePool::ALIGNMENT;
+		}
+
+		// 各平面的对齐行距；格式无效时返回 false
+		bool aligned_linesizes(const int width, const int format, std::array<int, 4> &linesizes)
+		{
+			if (av_image_fill_linesizes(linesizes.data(), static_cast<AVPixelFormat>(format), width) < 0)
+			{
+				return false;
+			}
+			for (int &size: linesizes)
+			{
+				size = static_cast<int>(align_up(static_cast<std::size_t>(size)));
+			}
+			return true;
+		}
+
+		void release_nothing(void *, uint8_t *)
+		{
+		}
+	} // namespace
+
+	void FramePool::AlignedDelete::operator()(uint8_t *p) const
+	{
+		::operator delete[](p, std::align_val_t{ALIGNMENT});
+	}
+
+	FramePool::~FramePool() = default;
+
+	std::size_t FramePool::frame_bytes(const int width, const int height, const int format)
+	{
+		std::array<int, 4>		linesizes{};
+		std::array<uint8_t *, 4> planes{};
+		if (!aligned_linesizes(width, format, linesizes))
+		{
+			return 0;
+		}
+		// 基址为空时 av_image_fill_pointers 只计算总大小
+		const int size = av_image_fill_pointers(planes.data(), static_cast<AVPixelFormat>(format), height, nullptr, linesizes.data());
+		return size > 0 ? align_up(static_cast<std::size_t>(size)) : 0;
+	}
+
+	bool FramePool::reserve(const std::size_t bytes)
+	{
+		arena_.reset();
+		capacity_ = 0;
+		used_	  = 0;
+		if (bytes == 0)
+		{
+			return true;
+		}
+
+		arena_.reset(static_cast<uint8_t *>(::operator new[](align_up(bytes), std::align_val_t{ALIGNMENT}, std::nothrow)));
+		if (!arena_)
+		{
+			return false;
+		}
+		capacity_ = align_up(bytes);
+		return true;
+	}
+
+	AVFrame *FramePool::acquire(const int width, const int height, const int format)
+	{
+		const std::size_t bytes = frame_bytes(width, height, format);
+		if (bytes == 0 || used_ + bytes > capacity_)
+		{
+			return nullptr;
+		}
+
+		AVFrame *frame = av_frame_alloc();
+		if (!frame)
+		{
+			return nullptr;
+		}
+		frame->format = format;
+		frame->width  = width;
+		frame->height = height;
+
+		std::array<int, 4>		linesizes{};
+		std::array<uint8_t *, 4> planes{};
+		uint8_t				   *base = arena_.get() + used_;
+		aligned_linesizes(width, format, linesizes);
+		av_image_fill_pointers(planes.data(), static_cast<AVPixelFormat>(format), height, base, linesizes.data());
+		for (std::size_t i = 0; i < planes.size(); ++i)
+		{
+			frame->data[i]	   = planes[i];
+			frame->linesize[i] = linesizes[i];
+		}
+
+		frame->buf[0] = av_buffer_create(base, bytes, release_nothing, nullptr, 0);
+		if (!frame->buf[0])
+		{
+			av_frame_free(&frame);
+			return nullptr;
+		}
+		used_ += bytes;
+		return frame;
+	}
+
+	bool FramePool::wrap_plane(AVFrame *frame, uint8_t *data, const std::size_t bytes, const int stride)
+	{
+		av_buffer_unref(&frame->buf[0]);
+		frame->buf[0]	   = av_buffer_create(data, bytes, release_nothing, nullptr, 0);
+		frame->data[0]	   = data;
+		frame->linesize[0] = stride;
+		return frame->buf[0] != nullptr;
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,57 @@
+#include "frame_resampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SteamShowcaseGen
+{
+	FrameResampler::FrameResampler(const double target_fps, const double duration, const int max_frames)
+		: interval_(target_fps > 0 ? 1.0 / target_fps : 0.0)
+		, max_frames_(max_frames)
+	{
+		// 帧数上限折算为最小采样间隔，让有限的帧均匀覆盖整段素材
+		if (max_frames_ > 0 && duration > 0)
+		{
+			interval_ = std::max(interval_, duration / max_frames_);
+		}
+		interval_ = std::max(interval_, MIN_DELAY_CS / 100.0);
+	}
+
+	int64_t FrameResampler::cell_of(const double t) const
+	{
+		// 微小的容差，避免恰好落在区间边界的时间戳因浮点误差被分到前一个区间
+		return static_cast<int64_t>(std::floor(std::max(t, 0.0) / interval_ + 1e-6));
+	}
+
+	bool FrameResampler::wants(const double t) const
+	{
+		if (max_frames_ > 0 && accepted_ >= max_frames_)
+		{
+			return false;
+		}
+		return cell_of(t) > last_cell_;
+	}
+
+	bool FrameResampler::accept(const double t)
+	{
+		if (!wants(t))
+		{
+			return false;
+		}
+
+		const int64_t cs = std::llround(std::max(t, 0.0) * 100.0);
+		if (last_cs_ >= 0 && cs - last_cs_ < MIN_DELAY_CS)
+		{
+			return false;
+		}
+
+		last_cell_ = cell_of(t);
+		last_cs_   = cs;
+		++accepted_;
+		return true;
+	}
+
+	int FrameResampler::final_delay() const
+	{
+		return std::max(MIN_DELAY_CS, static_cast<int>(std::lround(interval_ * 100.0)));
+	}
+} // namespace SteamShowcaseGen
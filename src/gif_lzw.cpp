@@ -0,0 +1,272 @@
+#include "gif_lzw.h"
+#include <limits>
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int	   MAX_SUB_BLOCK = 255;
+		constexpr uint32_t TABLE_LIMIT	 = (1u << LzwEncoder::MAX_CODE_BITS) - 1; // 达到 4095 时清表，与 giflib 一致
+
+		// 乘法哈希，取高位作为槽位
+		constexpr uint32_t hash_of(const uint32_t key, const int bits)
+		{
+			return (key * 2654435761u) >> (32 - bits);
+		}
+
+		struct Rgb
+		{
+			int r = 0;
+			int g = 0;
+			int b = 0;
+		};
+
+		Rgb rgb_of(const uint32_t argb)
+		{
+			return {static_cast<int>((argb >> 16) & 0xFF), static_cast<int>((argb >> 8) & 0xFF), static_cast<int>(argb & 0xFF)};
+		}
+	} // namespace
+
+	void LzwEncoder::put_code(const uint32_t code, std::vector<uint8_t> &out)
+	{
+		bit_buffer_ |= code << bit_count_;
+		bit_count_ += code_bits_;
+		while (bit_count_ >= 8)
+		{
+			out.push_back(static_cast<uint8_t>(bit_buffer_ & 0xFF));
+			bit_buffer_ >>= 8;
+			bit_count_ -= 8;
+
+			// 子块写满：回填长度，开始下一个子块
+			if (out.size() - block_start_ - 1 == MAX_SUB_BLOCK)
+			{
+				out[block_start_] = MAX_SUB_BLOCK;
+				block_start_	  = out.size();
+				out.push_back(0);
+			}
+		}
+	}
+
+	void LzwEncoder::flush_bits(std::vector<uint8_t> &out)
+	{
+		if (bit_count_ > 0)
+		{
+			code_bits_ = 8 - bit_count_; // 以零位补齐最后一个字节
+			put_code(0, out);
+		}
+
+		const auto length = out.size() - block_start_ - 1;
+		if (length > 0)
+		{
+			out[block_start_] = static_cast<uint8_t>(length);
+			out.push_back(0); // 块终止符
+		}
+		else
+		{
+			out[block_start_] = 0; // 空的子块即块终止符
+		}
+	}
+
+	void LzwEncoder::begin(const int min_code_size, std::vector<uint8_t> &out)
+	{
+		out.push_back(static_cast<uint8_t>(min_code_size));
+		block_start_ = out.size();
+		out.push_back(0);
+		bit_buffer_ = 0;
+		bit_count_	= 0;
+
+		min_bits_	= min_code_size;
+		clear_code_ = 1u << min_code_size;
+		next_code_	= clear_code_ + 2;
+		code_bits_	= min_code_size + 1;
+		put_code(clear_code_, out);
+	}
+
+	void LzwEncoder::emit(const uint32_t code, std::vector<uint8_t> &out)
+	{
+		// 每输出一个码后检查下一个待分配的码值是否超出当前码长（解码器在读入该码后做同样的判断）
+		put_code(code, out);
+		if (next_code_ >= (1u << code_bits_) && code_bits_ < MAX_CODE_BITS)
+		{
+			++code_bits_;
+		}
+	}
+
+	bool LzwEncoder::grow(std::vector<uint8_t> &out)
+	{
+		if (next_code_ >= TABLE_LIMIT)
+		{
+			put_code(clear_code_, out);
+			next_code_ = clear_code_ + 2;
+			code_bits_ = min_bits_ + 1;
+			return false;
+		}
+		++next_code_;
+		return true;
+	}
+
+	void LzwEncoder::end(const uint32_t code, std::vector<uint8_t> &out)
+	{
+		emit(code, out);
+		put_code(clear_code_ + 1, out);
+		flush_bits(out);
+	}
+
+	void LzwEncoder::encode(const uint8_t *pixels, const std::size_t count, const int min_code_size, std::vector<uint8_t> &out)
+	{
+		begin(min_code_size, out);
+		if (count == 0)
+		{
+			put_code(clear_code_ + 1, out);
+			flush_bits(out);
+			return;
+		}
+
+		table_.fill(HASH_EMPTY);
+		uint32_t prefix = pixels[0];
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			const uint32_t pixel = pixels[i];
+			const uint32_t key	 = (prefix << 8) | pixel;
+
+			// 线性探测查找 (前缀, 像素) 对应的码
+			uint32_t slot = hash_of(key, HASH_BITS);
+			bool	 hit  = false;
+			while (table_[slot] != HASH_EMPTY)
+			{
+				if ((table_[slot] >> MAX_CODE_BITS) == key)
+				{
+					prefix = table_[slot] & TABLE_LIMIT;
+					hit	   = true;
+					break;
+				}
+				slot = (slot + 1) & (HASH_SIZE - 1);
+			}
+			if (hit)
+			{
+				continue;
+			}
+
+			emit(prefix, out);
+			const uint32_t code = next_code_;
+			if (grow(out))
+			{
+				table_[slot] = (key << MAX_CODE_BITS) | code;
+			}
+			else
+			{
+				table_.fill(HASH_EMPTY);
+			}
+			prefix = pixel;
+		}
+		end(prefix, out);
+	}
+
+	void LzwEncoder::encode_lossy(const uint8_t		   *pixels,
+								  const std::size_t		count,
+								  const int				min_code_size,
+								  const uint32_t	   *palette,
+								  const int				transparent,
+								  const int				max_error,
+								  std::vector<uint8_t> &out)
+	{
+		if (max_error <= 0)
+		{
+			encode(pixels, count, min_code_size, out);
+			return;
+		}
+
+		begin(min_code_size, out);
+		if (count == 0)
+		{
+			put_code(clear_code_ + 1, out);
+			flush_bits(out);
+			return;
+		}
+
+		first_child_.fill(NO_CHILD);
+		const int	max_distance = max_error * max_error;
+		uint32_t	code		 = pixels[0];
+		Rgb			carry;
+		std::size_t pos = 1;
+		while (true)
+		{
+			// 沿前缀树贪心延长当前串：每一步在与实际颜色相距不超过 max_error 的后继中，选取与目标颜色（实际颜色 + 扩散误差）最接近的一项；
+			// 扩散误差只影响取舍，不会让解码后的像素偏离源颜色超过 max_error
+			while (pos < count)
+			{
+				const int  actual	 = pixels[pos];
+				const bool is_clear	 = actual == transparent;
+				const Rgb  color	 = rgb_of(palette[actual]);
+				const Rgb  target	 = {color.r + carry.r, color.g + carry.g, color.b + carry.b};
+				uint32_t   best		 = NO_CHILD;
+				int		   best_dist = std::numeric_limits<int>::max();
+				Rgb		   best_diff;
+				for (uint32_t child = first_child_[code]; child != NO_CHILD; child = next_sibling_[child])
+				{
+					const int candidate = suffix_[child];
+					if (is_clear || candidate == transparent)
+					{
+						// 透明像素只与自身匹配，且不参与误差扩散
+						if (candidate == actual)
+						{
+							best	  = child;
+							best_diff = {};
+							break;
+						}
+						continue;
+					}
+
+					const Rgb c		= rgb_of(palette[candidate]);
+					const Rgb error = {color.r - c.r, color.g - c.g, color.b - c.b};
+					if (error.r * error.r + error.g * error.g + error.b * error.b > max_distance)
+					{
+						continue;
+					}
+
+					const Rgb diff = {target.r - c.r, target.g - c.g, target.b - c.b};
+					const int dist = diff.r * diff.r + diff.g * diff.g + diff.b * diff.b;
+					if (dist < best_dist)
+					{
+						best	  = child;
+						best_dist = dist;
+						best_diff = diff;
+						if (dist == 0)
+						{
+							break;
+						}
+					}
+				}
+				if (best == NO_CHILD)
+				{
+					break;
+				}
+				code  = best;
+				carry = {best_diff.r * 3 / 4, best_diff.g * 3 / 4, best_diff.b * 3 / 4};
+				++pos;
+			}
+			if (pos == count)
+			{
+				break;
+			}
+
+			// 新字典项以实际像素结尾：下一个串从该像素开始，解码端推出的字典与此一致
+			emit(code, out);
+			const uint32_t entry = next_code_;
+			if (grow(out))
+			{
+				suffix_[entry]		 = pixels[pos];
+				first_child_[entry]	 = NO_CHILD;
+				next_sibling_[entry] = first_child_[code];
+				first_child_[code]	 = static_cast<uint16_t>(entry);
+			}
+			else
+			{
+				first_child_.fill(NO_CHILD);
+			}
+			code  = pixels[pos++];
+			carry = {};
+		}
+		end(code, out);
+	}
+} // namespace SteamShowcaseGen
@@ -0,0 +1,310 @@
+#include "gif_writer.h"
+#include <algorithm>
+#include <thread>
+#include "gif_lzw.h"
+#include "thread_pool.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr uint8_t	  GIF_TRAILER		   = 0x3B;
+		constexpr int		  DISPOSAL_NONE		   = 1; // 保留当前帧，下一帧在其上叠加
+		constexpr int		  MAX_DELAY			   = 0xFFFF;
+		constexpr int		  MIN_LZW_CODE_SIZE	   = 2;
+		constexpr int		  MAX_COLOR_TABLE_BITS = 8;
+		constexpr std::size_t FLUSH_THRESHOLD	   = 64 * 1024; // 文件模式下缓冲超过该值即写出
+		constexpr std::size_t FRAME_HEADER_BYTES   = 18;		// 图形控制扩展与图像描述符
+
+		// 容纳 colors 项所需的颜色表位数（表长为 2^bits）
+		int table_bits_for(const int colors)
+		{
+			int bits = 1;
+			while ((1 << bits) < colors && bits < MAX_COLOR_TABLE_BITS)
+			{
+				++bits;
+			}
+			return bits;
+		}
+	} // namespace
+
+	GifWriter::~GifWriter()
+	{
+		wait_pending();
+		if (file_.is_open())
+		{
+			file_.close();
+		}
+	}
+
+	void GifWriter::compress(PendingFrame &frame) const
+	{
+		// 每个线程复用一份字典；输出缓冲区随任务槽复用，clear 保留容量
+		thread_local LzwEncoder encoder;
+		frame.data.clear();
+		frame.data.reserve(frame.pixels.size() / 2 + 64);
+		encoder.encode_lossy(frame.pixels.data(), frame.pixels.size(), frame.min_code_size, frame.palette.data(), frame.transparent, lossy_error_, frame.data);
+	}
+
+	void GifWriter::await(const PendingFrame &frame) const
+	{
+		// 在调度器的工作线程中等待时代为执行其他任务，避免全部工作线程都阻塞在压缩结果上
+		while (!frame.done.load(std::memory_order_acquire))
+		{
+			if (!pool_ || !pool_->run_pending())
+			{
+				frame.done.wait(false, std::memory_order_acquire);
+			}
+		}
+	}
+
+	void GifWriter::wait_pending()
+	{
+		// 线程池中的任务引用着任务槽，释放或重置之前须等待其全部完成
+		for (std::size_t i = 0; i < pending_count_; ++i)
+		{
+			await(pending_[(pending_head_ + i) % pending_.size()]);
+		}
+		// done 置位后任务仍要调用 notify_one，须等到任务递减 tasks_ 之后才不再访问本对象；
+		// 该间隔只有几条指令，自旋等待即可
+		while (tasks_.load(std::memory_order_acquire) != 0)
+		{
+			if (!pool_ || !pool_->run_pending())
+			{
+				std::this_thread::yield();
+			}
+		}
+		pending_head_  = 0;
+		pending_count_ = 0;
+	}
+
+	bool GifWriter::open(const std::filesystem::path &path, const int width, const int height, ThreadPool *pool, const int lossy_error)
+	{
+		open_memory(width, height, pool, lossy_error);
+		file_.open(path, std::ios::binary | std::ios::trunc);
+		open_ = file_.is_open();
+		bytes_.reserve(FLUSH_THRESHOLD);
+		return open_;
+	}
+
+	void GifWriter::open_memory(const int width, const int height, ThreadPool *pool, const int lossy_error)
+	{
+		if (file_.is_open())
+		{
+			file_.close();
+		}
+		wait_pending();
+		pool_			= pool;
+		width_			= width;
+		height_			= height;
+		lossy_error_	= lossy_error;
+		header_written_ = false;
+		global_bits_	= 0;
+		last_delay_		= 0;
+		flushed_		= 0;
+		open_			= true;
+		bytes_.clear();
+	}
+
+	void GifWriter::add_frame(
+		const uint8_t *indices, const int stride, const DeltaRect &rect, const uint32_t *palette, const int colors, const int transparent, const int64_t pts)
+	{
+		if (!open_)
+		{
+			return;
+		}
+
+		// drain() 保证提交前至少有一个空闲任务槽
+		PendingFrame &frame = pending_[(pending_head_ + pending_count_) % pending_.size()];
+		frame.rect			= rect.empty() ? DeltaRect{0, 0, 1, 1} : rect;
+		frame.pts			= pts;
+		frame.transparent	= transparent;
+		frame.table_bits	= 0;
+		std::copy_n(palette, frame.palette.size(), frame.palette.begin());
+
+		// 首帧调色板作为全局颜色表；之后调色板不同的帧携带局部颜色表
+		const int bits = table_bits_for(colors);
+		if (global_bits_ == 0)
+		{
+			global_bits_ = bits;
+			std::copy_n(palette, global_palette_.size(), global_palette_.begin());
+		}
+		else if (bits > global_bits_ || !std::equal(palette, palette + colors, global_palette_.begin()))
+		{
+			frame.table_bits = bits;
+		}
+		frame.min_code_size = std::max(MIN_LZW_CODE_SIZE, frame.table_bits ? frame.table_bits : global_bits_);
+
+		// 复制子矩形：帧槽在本函数返回后即被复用
+		const DeltaRect &r = frame.rect;
+		frame.pixels.resize(static_cast<std::size_t>(r.width) * r.height);
+		for (int y = 0; y < r.height; ++y)
+		{
+			std::copy_n(
+				indices + static_cast<std::ptrdiff_t>(r.y + y) * stride + r.x, r.width, frame.pixels.begin() + static_cast<std::ptrdiff_t>(y) * r.width);
+		}
+
+		frame.done.store(false, std::memory_order_relaxed);
+		++pending_count_;
+		if (pool_)
+		{
+			tasks_.fetch_add(1, std::memory_order_relaxed);
+			pool_->post(
+				[this, &frame]
+				{
+					compress(frame);
+					frame.done.store(true, std::memory_order_release);
+					frame.done.notify_one();
+					tasks_.fetch_sub(1, std::memory_order_release); // 此后不再访问本对象
+				});
+		}
+		else
+		{
+			compress(frame);
+			frame.done.store(true, std::memory_order_relaxed);
+		}
+
+		drain(false, 0);
+	}
+
+	bool GifWriter::finish(const int final_delay)
+	{
+		if (!open_)
+		{
+			return false;
+		}
+
+		drain(true, final_delay);
+		if (!header_written_)
+		{
+			write_header();
+		}
+		put(GIF_TRAILER);
+		open_ = false;
+		if (!file_.is_open())
+		{
+			return true;
+		}
+
+		flush();
+		file_.close();
+		return !file_.fail();
+	}
+
+	void GifWriter::drain(const bool all, const int final_delay)
+	{
+		// 队首帧的延迟需要下一帧的时间戳；未满时只写出已压缩完成的帧，不阻塞调用方
+		while (pending_count_ > (all ? 0u : 1u))
+		{
+			PendingFrame &front = pending_[pending_head_];
+			if (!all && pending_count_ <= MAX_IN_FLIGHT && !front.done.load(std::memory_order_acquire))
+			{
+				break;
+			}
+
+			const PendingFrame &next  = pending_[(pending_head_ + 1) % pending_.size()];
+			const int64_t		delay = pending_count_ > 1 ? next.pts - front.pts : final_delay >= 0 ? final_delay : last_delay_;
+			last_delay_				  = static_cast<int>(std::clamp<int64_t>(delay, 0, MAX_DELAY));
+			await(front);
+			write_frame(front, last_delay_);
+			pending_head_ = (pending_head_ + 1) % pending_.size();
+			--pending_count_;
+		}
+		if (file_.is_open() && bytes_.size() >= FLUSH_THRESHOLD)
+		{
+			flush();
+		}
+	}
+
+	void GifWriter::put(const uint8_t value)
+	{
+		bytes_.push_back(value);
+	}
+
+	void GifWriter::put_u16(const int value)
+	{
+		bytes_.push_back(static_cast<uint8_t>(value & 0xFF));
+		bytes_.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+	}
+
+	void GifWriter::flush()
+	{
+		file_.write(reinterpret_cast<const char *>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+		flushed_ += bytes_.size();
+		bytes_.clear();
+	}
+
+	void GifWriter::write_header()
+	{
+		if (global_bits_ == 0)
+		{
+			global_bits_ = 1;
+			global_palette_.fill(0xFF000000u);
+		}
+
+		static constexpr uint8_t SIGNATURE[] = {'G', 'I', 'F', '8', '9', 'a'};
+		bytes_.insert(bytes_.end(), std::begin(SIGNATURE), std::end(SIGNATURE));
+
+		// 逻辑屏幕描述符：存在全局颜色表，颜色分辨率 8 位
+		put_u16(width_);
+		put_u16(height_);
+		put(static_cast<uint8_t>(0x80 | 0x70 | (global_bits_ - 1)));
+		put(0); // 背景色索引
+		put(0); // 像素宽高比
+		write_color_table(global_palette_, global_bits_);
+
+		// NETSCAPE2.0 应用扩展：无限循环
+		static constexpr uint8_t NETSCAPE_LOOP[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+		bytes_.insert(bytes_.end(), std::begin(NETSCAPE_LOOP), std::end(NETSCAPE_LOOP));
+		header_written_ = true;
+	}
+
+	void GifWriter::write_frame(PendingFrame &frame, const int delay)
+	{
+		if (!header_written_)
+		{
+			write_header();
+		}
+
+		// 文件模式下缓冲放不下这一帧时先写出：缓冲区只在出现更大的帧时扩容，稳态编码中不再分配
+		const std::size_t frame_bytes = FRAME_HEADER_BYTES + (frame.table_bits ? std::size_t{3} << frame.table_bits : 0) + frame.data.size();
+		if (file_.is_open() && bytes_.size() + frame_bytes > bytes_.capacity())
+		{
+			flush();
+		}
+
+		// 图形控制扩展
+		put(0x21);
+		put(0xF9);
+		put(4);
+		put(static_cast<uint8_t>((DISPOSAL_NONE << 2) | (frame.transparent >= 0 ? 1 : 0)));
+		put_u16(delay);
+		put(static_cast<uint8_t>(frame.transparent >= 0 ? frame.transparent : 0));
+		put(0);
+
+		// 图像描述符
+		put(0x2C);
+		put_u16(frame.rect.x);
+		put_u16(frame.rect.y);
+		put_u16(frame.rect.width);
+		put_u16(frame.rect.height);
+		put(static_cast<uint8_t>(frame.table_bits ? 0x80 | (frame.table_bits - 1) : 0));
+		if (frame.table_bits)
+		{
+			write_color_table(frame.palette, frame.table_bits);
+		}
+
+		bytes_.insert(bytes_.end(), frame.data.begin(), frame.data.end());
+	}
+
+	void GifWriter::write_color_table(const std::array<uint32_t, 256> &palette, const int bits)
+	{
+		for (int i = 0; i < (1 << bits); ++i)
+		{
+			const uint32_t c = palette[i];
+			put(static_cast<uint8_t>((c >> 16) & 0xFF));
+			put(static_cast<uint8_t>((c >> 8) & 0xFF));
+			put(static_cast<uint8_t>(c & 0xFF));
+		}
+	}
+} // namespace SteamShowcaseGen
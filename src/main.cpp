@@ -1,23 +1,27 @@
+#include <charconv>
 #include <filesystem>
-#include <opencv2/core/utils/logger.hpp>
+#include <format>
+#include <optional>
+#include <vector>
 #include "app_text.hpp"
+#include "cli.h"
 #include "ftxui/component/screen_interactive.hpp"
-#include "showcase_processor.h"
+#include "ssg_core.h"
 #include "ui_components.h"
 
-extern "C"
-{
-#include <libavutil/log.h>
-}
-
 using namespace ftxui;
 namespace ssg = SteamShowcaseGen;
 
-int main()
+int main(int argc, char *argv[])
 {
 	// 1. 系统初始化
-	cv::utils::logging::setLogLevel(cv::utils::logging::LOG_LEVEL_SILENT);
-	av_log_set_level(AV_LOG_QUIET);
+	ssg::ShowcaseProcessor::silence_library_logs();
+
+	// 带参数启动时以命令行模式运行，不创建终端界面
+	if (argc > 1)
+	{
+		return ssg::Cli::Run(argc, argv);
+	}
 
 	ssg::Ui::AppState	   app_state;
 	ssg::ShowcaseProcessor processor;
@@ -45,32 +49,95 @@ int main()
 	}
 
 	// 3. 定义核心业务回调
+	auto has_valid_file = [&] { return !app_state.file_list.empty() && !app_state.file_list[0].starts_with('<'); };
+
+	auto make_options = [&]
+	{
+		ssg::TaskOptions options;
+		options.sampling_rate = app_state.sampling_rate;
+		options.quality_mode  = app_state.quality_idx;
+		options.dither		  = static_cast<ssg::DitherMode>(app_state.dither_idx);
+
+		// 体积上限以 KB 输入，无法解析时视为不限制
+		std::size_t target_kb = 0;
+		std::from_chars(app_state.target_kb.data(), app_state.target_kb.data() + app_state.target_kb.size(), target_kb);
+		options.target_bytes = target_kb * 1024;
+		return options;
+	};
+
 	auto start_task_callback = [&]
 	{
-		if (app_state.file_list.empty() || app_state.file_list[0].starts_with('<'))
+		if (!has_valid_file())
 		{
-			app_state.current_log = "错误: 请先扫描目录选择有效文件";
+			app_state.set_log("错误: 请先扫描目录选择有效文件");
 			screen.Post(Event::Custom); // 刷新 UI 显示错误信息
 			return;
 		}
 
-		const auto src_path = std::filesystem::path(app_state.src_dir) / app_state.file_list[app_state.selected_file_idx];
+		// 开始处理时会取消尚未完成的体积预估，其结果不再回调
+		if (app_state.size_estimate == ssg::AppText::ESTIMATE_PENDING)
+		{
+			app_state.size_estimate.clear();
+		}
+
+		const auto options	 = make_options();
+		auto	   on_update = [&](const std::string_view log)
+		{
+			app_state.set_log(log);		// 沿用已有容量，逐帧的进度消息不再重新分配
+			screen.Post(Event::Custom); // 触发 UI 刷新
+		};
+
+		// 批量模式：列表中的全部文件并发处理，各自输出到以文件名命名的子目录
+		if (app_state.batch_mode)
+		{
+			std::vector<std::filesystem::path> sources;
+			for (const auto &file: app_state.file_list)
+			{
+				sources.push_back(std::filesystem::path(app_state.src_dir) / file);
+			}
+			processor.start_batch(sources, app_state.out_dir, options, on_update);
+			return;
+		}
 
-		processor.start_task(src_path,
-							 app_state.out_dir,
-							 app_state.sampling_rate,
-							 app_state.quality_idx,
-							 [&](const std::string_view log)
-							 {
-								 app_state.current_log = std::string(log);
-								 screen.Post(Event::Custom); // 触发 UI 刷新
-							 });
+		const auto src_path = std::filesystem::path(app_state.src_dir) / app_state.file_list[app_state.selected_file_idx];
+		processor.start_task(src_path, app_state.out_dir, options, on_update);
 	};
 
 	auto is_busy_callback = [&] { return processor.is_active(); };
 
+	// 配置变化时在后台抽样预估体积，结果回到 UI 线程显示
+	auto config_change_callback = [&]
+	{
+		if (processor.is_active())
+		{
+			return;
+		}
+		if (!has_valid_file())
+		{
+			processor.cancel_estimate();
+			app_state.size_estimate.clear();
+			return;
+		}
+
+		const auto src_path		= std::filesystem::path(app_state.src_dir) / app_state.file_list[app_state.selected_file_idx];
+		app_state.size_estimate = std::string(ssg::AppText::ESTIMATE_PENDING);
+		processor.request_estimate(src_path,
+								   make_options(),
+								   [&](const std::optional<ssg::ShowcaseProcessor::SizeEstimate> &estimate)
+								   {
+									   std::string result;
+									   if (estimate)
+									   {
+										   const std::size_t largest_kb = (estimate->largest() + 1023) / 1024;
+										   result = std::vformat(ssg::AppText::ESTIMATE_RESULT, std::make_format_args(largest_kb));
+									   }
+									   screen.Post([&, result] { app_state.size_estimate = result; });
+									   screen.Post(Event::Custom);
+								   });
+	};
+
 	// 4. 构建统一 UI
-	const auto main_interface = ssg::Ui::BuildMainInterface(app_state, start_task_callback, is_busy_callback);
+	const auto main_interface = ssg::Ui::BuildMainInterface(app_state, start_task_callback, is_busy_callback, config_change_callback);
 
 	// 5. 启动后台动画线程
 	std::jthread anim_worker(
@@ -92,8 +159,11 @@ int main()
 		});
 
 	// 6. 运行主循环
-	app_state.current_log = std::string(ssg::AppText::LOG_READY);
+	app_state.set_log(ssg::AppText::LOG_READY);
 	screen.Loop(main_interface);
 
+	// 预估线程的回调会访问 screen，须在 screen 析构前结束
+	processor.cancel_estimate(true);
+
 	return 0;
 }
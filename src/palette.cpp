@@ -0,0 +1,161 @@
+#include "palette.h"
+#include <algorithm>
+#include <span>
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		// 15 位颜色键：R5 G5 B5
+		constexpr int key_of(const int r, const int g, const int b)
+		{
+			return ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+		}
+
+		// 取键中某个通道（0 = R, 1 = G, 2 = B）的 5 位分量
+		constexpr int channel_of(const int key, const int axis)
+		{
+			return (key >> (10 - 5 * axis)) & 0x1F;
+		}
+
+		using Bin = ColorHistogram::Bin;
+
+		struct Box
+		{
+			std::size_t begin;
+			std::size_t end;
+			uint64_t	count;
+			int			axis;  // 跨度最大的通道
+			int			range; // 该通道上的跨度
+		};
+
+		Box make_box(const std::vector<Bin> &bins, const std::size_t begin, const std::size_t end)
+		{
+			int		 lo[3] = {31, 31, 31};
+			int		 hi[3] = {0, 0, 0};
+			uint64_t count = 0;
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				for (int a = 0; a < 3; ++a)
+				{
+					const int v = channel_of(bins[i].key, a);
+					lo[a]		= std::min(lo[a], v);
+					hi[a]		= std::max(hi[a], v);
+				}
+				count += bins[i].count;
+			}
+
+			Box box{begin, end, count, 0, hi[0] - lo[0]};
+			for (int a = 1; a < 3; ++a)
+			{
+				if (hi[a] - lo[a] > box.range)
+				{
+					box.axis  = a;
+					box.range = hi[a] - lo[a];
+				}
+			}
+			return box;
+		}
+	} // namespace
+
+	void ColorHistogram::clear()
+	{
+		std::ranges::fill(bins_, 0u);
+	}
+
+	void ColorHistogram::add(const uint8_t *bgra, const int stride, const int width, const int height)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			const uint8_t *p = bgra + static_cast<std::ptrdiff_t>(y) * stride;
+			for (int x = 0; x < width; ++x, p += 4)
+			{
+				++bins_[key_of(p[2], p[1], p[0])];
+			}
+		}
+	}
+
+	Palette ColorHistogram::build_palette(const int max_colors) const
+	{
+		// 逐帧调色板模式下每帧调用一次：非空格子复用本对象按最大容量预留的缓冲区，盒子数不超过 256 放在栈上，首次调用后不再分配内存。
+		// 缓冲区不按线程保存：量化 Strand 在调度器的各线程间迁移，按线程保存的缓冲区在每个线程上都要各自增长一遍
+		std::vector<Bin> &bins = scratch_;
+		if (bins.capacity() < BINS)
+		{
+			bins.reserve(BINS);
+		}
+		bins.clear();
+		for (int key = 0; key < BINS; ++key)
+		{
+			if (bins_[key])
+			{
+				bins.push_back({static_cast<uint16_t>(key), bins_[key]});
+			}
+		}
+
+		// 未使用的表项保持不透明，避免被编码器识别为透明色
+		Palette palette;
+		palette.colors.fill(0xFF000000u);
+		if (bins.empty())
+		{
+			palette.size = 1;
+			return palette;
+		}
+
+		// 中位切分：反复选出“像素数 x 通道跨度”最大的盒子，沿其最长通道在加权中位处一分为二
+		const std::size_t	 limit = static_cast<std::size_t>(std::clamp(max_colors, 1, 256));
+		std::array<Box, 256> boxes{make_box(bins, 0, bins.size())};
+		std::size_t			 box_count = 1;
+		while (box_count < limit)
+		{
+			Box *best = nullptr;
+			for (Box &candidate: std::span(boxes.data(), box_count))
+			{
+				if (candidate.end - candidate.begin > 1 && candidate.range > 0
+					&& (!best || candidate.count * static_cast<uint64_t>(candidate.range) > best->count * static_cast<uint64_t>(best->range)))
+				{
+					best = &candidate;
+				}
+			}
+			if (!best)
+			{
+				break;
+			}
+
+			const Box box  = *best;
+			const int axis = box.axis;
+			std::sort(bins.begin() + static_cast<std::ptrdiff_t>(box.begin),
+					  bins.begin() + static_cast<std::ptrdiff_t>(box.end),
+					  [axis](const Bin &a, const Bin &b) { return channel_of(a.key, axis) < channel_of(b.key, axis); });
+
+			std::size_t split = box.begin + 1;
+			uint64_t	acc	  = bins[box.begin].count;
+			while (split < box.end - 1 && acc * 2 < box.count)
+			{
+				acc += bins[split++].count;
+			}
+
+			*best			   = make_box(bins, box.begin, split);
+			boxes[box_count++] = make_box(bins, split, box.end);
+		}
+
+		// 每个盒子取加权平均色（5 位分量还原到区间中心）
+		for (const auto &box: std::span(boxes.data(), box_count))
+		{
+			uint64_t sum[3] = {0, 0, 0};
+			for (std::size_t i = box.begin; i < box.end; ++i)
+			{
+				for (int a = 0; a < 3; ++a)
+				{
+					sum[a] += static_cast<uint64_t>((channel_of(bins[i].key, a) << 3) | 4) * bins[i].count;
+				}
+			}
+			const auto r = static_cast<uint32_t>(sum[0] / box.count);
+			const auto g = static_cast<uint32_t>(sum[1] / box.count);
+			const auto b = static_cast<uint32_t>(sum[2] / box.count);
+
+			palette.colors[palette.size++] = 0xFF000000u | (r << 16) | (g << 8) | b;
+		}
+		return palette;
+	}
+} // namespace SteamShowcaseGen
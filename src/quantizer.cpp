@@ -0,0 +1,312 @@
+#include "quantizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+#include "cpu_features.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		// 逆色表按 32x32x32 的颜色块分块构建：先为每块筛出可能成为最近色的候选，
+		// 再只在候选中逐格搜索（与 libjpeg jquant2 的 fill_inverse_cmap 思路相同）
+		constexpr int BLOCK_R = 4; // 每块包含的 R 格数（每格 8 级）
+		constexpr int BLOCK_G = 8; // 每块包含的 G 格数（每格 4 级）
+		constexpr int BLOCK_B = 4; // 每块包含的 B 格数（每格 8 级）
+
+		// 有序抖动的偏置幅度（峰峰值）：约为调色板颜色间距的一半，颜色越少幅度越大
+		int dither_spread(const int palette_size)
+		{
+			const double spacing = 256.0 / std::cbrt(std::max(palette_size, 1));
+			return std::clamp(static_cast<int>(std::lround(spacing / 2)), 8, 64);
+		}
+
+		struct Rgb
+		{
+			int r, g, b;
+		};
+
+		// 点到区间 [lo, hi] 的最近与最远距离
+		constexpr int near_axis(const int v, const int lo, const int hi)
+		{
+			return v < lo ? lo - v : (v > hi ? v - hi : 0);
+		}
+
+		constexpr int far_axis(const int v, const int lo, const int hi)
+		{
+			return std::max(v - lo, hi - v);
+		}
+
+		QuantizerKernels::MapRow select_kernel(const Quantizer::Kernel kernel)
+		{
+			switch (kernel)
+			{
+#if SSG_ARCH_X86
+				case Quantizer::Kernel::Avx512:
+					return QuantizerKernels::map_row_avx512;
+				case Quantizer::Kernel::Avx2:
+					return QuantizerKernels::map_row_avx2;
+				case Quantizer::Kernel::Sse41:
+					return QuantizerKernels::map_row_sse41;
+#endif
+				case Quantizer::Kernel::Scalar:
+				default:
+					return QuantizerKernels::map_row_scalar;
+			}
+		}
+	} // namespace
+
+	void QuantizerKernels::map_row_scalar(
+		const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+	{
+		if (!bias_add || !bias_sub)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				uint32_t pixel;
+				std::memcpy(&pixel, bgra + static_cast<std::ptrdiff_t>(x) * 4, sizeof(pixel));
+				dst[x] = lut[lut_index(pixel)];
+			}
+			return;
+		}
+
+		for (int x = 0; x < width; ++x)
+		{
+			const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(x) * 4;
+			uint32_t			 pixel	= 0;
+			for (int c = 0; c < 3; ++c)
+			{
+				const int v = std::clamp(bgra[offset + c] + bias_add[offset + c] - bias_sub[offset + c], 0, 255);
+				pixel |= static_cast<uint32_t>(v) << (c * 8);
+			}
+			dst[x] = lut[lut_index(pixel)];
+		}
+	}
+
+	Quantizer::Kernel Quantizer::best_kernel()
+	{
+		const auto &cpu = cpu_features();
+		if (SSG_ARCH_X86 && cpu.avx512)
+		{
+			return Kernel::Avx512;
+		}
+		if (SSG_ARCH_X86 && cpu.avx2)
+		{
+			return Kernel::Avx2;
+		}
+		if (SSG_ARCH_X86 && cpu.sse41)
+		{
+			return Kernel::Sse41;
+		}
+		return Kernel::Scalar;
+	}
+
+	Quantizer::Quantizer(const Kernel kernel)
+		: kernel_(kernel)
+		, lut_(QuantizerKernels::LUT_SIZE + QuantizerKernels::LUT_PADDING, 0)
+	{
+	}
+
+	void Quantizer::set_palette(const Palette &palette)
+	{
+		if (palette == palette_)
+		{
+			return;
+		}
+		palette_ = palette;
+		build_lut();
+	}
+
+	void Quantizer::set_dither(const DitherMode mode)
+	{
+		if (mode != dither_)
+		{
+			dither_		 = mode;
+			bias_period_ = 0;
+		}
+	}
+
+	void Quantizer::build_lut()
+	{
+		// 逐帧调色板模式下每帧重建一次，颜色与候选列表放在栈上，不分配内存
+		std::array<Rgb, 256>	   storage{};
+		const std::span<const Rgb> colors(storage.data(), static_cast<std::size_t>(std::clamp(palette_.size, 1, 256)));
+		for (std::size_t i = 0; i < colors.size(); ++i)
+		{
+			const uint32_t c = palette_.colors[i];
+			storage[i]		 = {static_cast<int>((c >> 16) & 0xFF), static_cast<int>((c >> 8) & 0xFF), static_cast<int>(c & 0xFF)};
+		}
+
+		std::array<uint8_t, 256> candidate_storage{};
+		std::size_t				 candidate_count = 0;
+
+		for (int rb = 0; rb < 32; rb += BLOCK_R)
+		{
+			for (int gb = 0; gb < 64; gb += BLOCK_G)
+			{
+				for (int bb = 0; bb < 32; bb += BLOCK_B)
+				{
+					// 块内各格中心所覆盖的颜色范围
+					const int r_lo = rb * 8 + 4, r_hi = (rb + BLOCK_R - 1) * 8 + 4;
+					const int g_lo = gb * 4 + 2, g_hi = (gb + BLOCK_G - 1) * 4 + 2;
+					const int b_lo = bb * 8 + 4, b_hi = (bb + BLOCK_B - 1) * 8 + 4;
+
+					// 任何格子的最近色距离都不会超过 min(各色到块的最远距离)，据此剔除不可能的颜色
+					int min_far = std::numeric_limits<int>::max();
+					for (const auto &c: colors)
+					{
+						const int fr = far_axis(c.r, r_lo, r_hi), fg = far_axis(c.g, g_lo, g_hi), fb = far_axis(c.b, b_lo, b_hi);
+						min_far		 = std::min(min_far, fr * fr + fg * fg + fb * fb);
+					}
+
+					candidate_count = 0;
+					for (std::size_t i = 0; i < colors.size(); ++i)
+					{
+						const auto &c  = colors[i];
+						const int	nr = near_axis(c.r, r_lo, r_hi), ng = near_axis(c.g, g_lo, g_hi), nb = near_axis(c.b, b_lo, b_hi);
+						if (nr * nr + ng * ng + nb * nb <= min_far)
+						{
+							candidate_storage[candidate_count++] = static_cast<uint8_t>(i);
+						}
+					}
+
+					const std::span<const uint8_t> candidates(candidate_storage.data(), candidate_count);
+					for (int r5 = rb; r5 < rb + BLOCK_R; ++r5)
+					{
+						for (int g6 = gb; g6 < gb + BLOCK_G; ++g6)
+						{
+							for (int b5 = bb; b5 < bb + BLOCK_B; ++b5)
+							{
+								const int r = r5 * 8 + 4, g = g6 * 4 + 2, b = b5 * 8 + 4;
+
+								// 候选按索引升序排列，距离相同时取较小索引
+								uint8_t best	  = candidates.front();
+								int		best_dist = std::numeric_limits<int>::max();
+								for (const uint8_t i: candidates)
+								{
+									const int dr = colors[i].r - r, dg = colors[i].g - g, db = colors[i].b - b;
+									const int d	 = dr * dr + dg * dg + db * db;
+									if (d < best_dist)
+									{
+										best	  = i;
+										best_dist = d;
+									}
+								}
+								lut_[(r5 << 11) | (g6 << 5) | b5] = best;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void Quantizer::prepare_bias(const int width)
+	{
+		const ThresholdMatrix &matrix = dither_ == DitherMode::BlueNoise ? blue_noise_matrix() : bayer_matrix();
+		const int			   spread = dither_spread(palette_.size);
+		if (bias_period_ == matrix.size && bias_width_ >= width && bias_spread_ == spread)
+		{
+			return;
+		}
+
+		// 阈值排名映射为以 0 为中心的有符号偏置，三个颜色通道相同，alpha 不变；
+		// 每行按像素展开，映射时直接与像素逐字节对应
+		const int	n	  = matrix.size;
+		const auto	cells = static_cast<std::size_t>(n) * n;
+		const auto	row	  = static_cast<std::size_t>(width) * 4;
+		bias_add_.assign(row * n, 0);
+		bias_sub_.assign(row * n, 0);
+		for (int y = 0; y < n; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				const double t	  = (matrix.ranks[y * n + x % n] + 0.5) / static_cast<double>(cells) - 0.5;
+				const int	 bias = static_cast<int>(std::lround(t * spread));
+				const auto	 at	  = y * row + static_cast<std::size_t>(x) * 4;
+				for (int c = 0; c < 3; ++c)
+				{
+					bias_add_[at + c] = static_cast<uint8_t>(std::max(bias, 0));
+					bias_sub_[at + c] = static_cast<uint8_t>(std::max(-bias, 0));
+				}
+			}
+		}
+		bias_period_ = n;
+		bias_width_	 = width;
+		bias_spread_ = spread;
+	}
+
+	void Quantizer::map_diffused(const uint8_t *bgra, const int src_stride, const int width, const int height, uint8_t *dst, const int dst_stride)
+	{
+		// 误差以 16 倍定点数累积；两行缓冲左右各留一格，免去边界判断
+		const std::size_t row_len = static_cast<std::size_t>(width + 2) * 3;
+		diffusion_.assign(row_len * 2, 0);
+
+		for (int y = 0; y < height; ++y)
+		{
+			int *cur  = diffusion_.data() + (y & 1) * row_len;
+			int *next = diffusion_.data() + ((y + 1) & 1) * row_len;
+			std::fill_n(next, row_len, 0);
+
+			const uint8_t *src = bgra + static_cast<std::ptrdiff_t>(y) * src_stride;
+			uint8_t		  *out = dst + static_cast<std::ptrdiff_t>(y) * dst_stride;
+
+			// 蛇形扫描，避免误差始终朝同一方向堆积
+			const int dir	= (y & 1) ? -1 : 1;
+			const int begin = (y & 1) ? width - 1 : 0;
+			for (int i = 0, x = begin; i < width; ++i, x += dir)
+			{
+				const uint8_t *p = src + static_cast<std::ptrdiff_t>(x) * 4;
+				const int	   e = (x + 1) * 3;
+
+				int c[3]; // R G B
+				for (int k = 0; k < 3; ++k)
+				{
+					c[k] = std::clamp(p[2 - k] + ((cur[e + k] + 8) >> 4), 0, 255);
+				}
+
+				const uint32_t pixel = (static_cast<uint32_t>(c[0]) << 16) | (static_cast<uint32_t>(c[1]) << 8) | static_cast<uint32_t>(c[2]);
+				const uint8_t  index = lut_[QuantizerKernels::lut_index(pixel)];
+				const uint32_t q	 = palette_.colors[index];
+				out[x]				 = index;
+
+				const int q_rgb[3] = {static_cast<int>((q >> 16) & 0xFF), static_cast<int>((q >> 8) & 0xFF), static_cast<int>(q & 0xFF)};
+				for (int k = 0; k < 3; ++k)
+				{
+					const int err = c[k] - q_rgb[k];
+					cur[e + dir * 3 + k] += err * 7;
+					next[e - dir * 3 + k] += err * 3;
+					next[e + k] += err * 5;
+					next[e + dir * 3 + k] += err;
+				}
+			}
+		}
+	}
+
+	void Quantizer::map(const uint8_t *bgra, const int src_stride, const int width, const int height, uint8_t *dst, const int dst_stride)
+	{
+		if (dither_ == DitherMode::FloydSteinberg)
+		{
+			map_diffused(bgra, src_stride, width, height, dst, dst_stride);
+			return;
+		}
+
+		const bool ordered = dither_ == DitherMode::Bayer || dither_ == DitherMode::BlueNoise;
+		if (ordered)
+		{
+			prepare_bias(width);
+		}
+
+		const QuantizerKernels::MapRow map_row = select_kernel(kernel_);
+		const auto					   row	   = static_cast<std::size_t>(bias_width_) * 4;
+		for (int y = 0; y < height; ++y)
+		{
+			const uint8_t *bias_add = ordered ? bias_add_.data() + (y % bias_period_) * row : nullptr;
+			const uint8_t *bias_sub = ordered ? bias_sub_.data() + (y % bias_period_) * row : nullptr;
+			map_row(bgra + static_cast<std::ptrdiff_t>(y) * src_stride, width, lut_.data(), bias_add, bias_sub, dst + static_cast<std::ptrdiff_t>(y) * dst_stride);
+		}
+	}
+} // namespace SteamShowcaseGen
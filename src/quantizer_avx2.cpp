@@ -0,0 +1,71 @@
+// 本编译单元以 AVX2 指令集编译，只包含内核声明与 intrinsics 头文件
+#include "cpu_features.h"
+#include "quantizer_kernels.h"
+
+#if SSG_ARCH_X86
+#include <immintrin.h>
+
+namespace SteamShowcaseGen::QuantizerKernels
+{
+	namespace
+	{
+		template <bool Biased>
+		__m256i gather_indices(const uint8_t *bgra, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub)
+		{
+			__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bgra));
+			if constexpr (Biased)
+			{
+				px = _mm256_adds_epu8(px, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bias_add)));
+				px = _mm256_subs_epu8(px, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bias_sub)));
+			}
+			const __m256i r	  = _mm256_and_si256(_mm256_srli_epi32(px, 8), _mm256_set1_epi32(0xF800));
+			const __m256i g	  = _mm256_and_si256(_mm256_srli_epi32(px, 5), _mm256_set1_epi32(0x07E0));
+			const __m256i b	  = _mm256_and_si256(_mm256_srli_epi32(px, 3), _mm256_set1_epi32(0x001F));
+			const __m256i idx = _mm256_or_si256(_mm256_or_si256(r, g), b);
+
+			// 以字节步长 gather 32 位，低 8 位即为调色板索引（逆色表末尾有填充，越界读取安全）
+			const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(lut), idx, 1);
+			return _mm256_and_si256(v, _mm256_set1_epi32(0xFF));
+		}
+
+		template <bool Biased>
+		int map_row_impl(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+		{
+			const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+			int x = 0;
+			for (; x + 16 <= width; x += 16)
+			{
+				const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(x) * 4;
+
+				__m256i lo, hi;
+				if constexpr (Biased)
+				{
+					lo = gather_indices<true>(bgra + offset, lut, bias_add + offset, bias_sub + offset);
+					hi = gather_indices<true>(bgra + offset + 32, lut, bias_add + offset + 32, bias_sub + offset + 32);
+				}
+				else
+				{
+					lo = gather_indices<false>(bgra + offset, lut, nullptr, nullptr);
+					hi = gather_indices<false>(bgra + offset + 32, lut, nullptr, nullptr);
+				}
+
+				// 32 -> 16 -> 8 位收窄；packus 按 128 位通道交错，最后用置换恢复像素顺序
+				const __m256i w16 = _mm256_packus_epi32(lo, hi);
+				const __m256i w8  = _mm256_packus_epi16(w16, w16);
+				const __m256i out = _mm256_permutevar8x32_epi32(w8, order);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm256_castsi256_si128(out));
+			}
+			return x;
+		}
+	} // namespace
+
+	void map_row_avx2(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+	{
+		const bool			 biased = bias_add && bias_sub;
+		const int			 done	= biased ? map_row_impl<true>(bgra, width, lut, bias_add, bias_sub, dst) : map_row_impl<false>(bgra, width, lut, nullptr, nullptr, dst);
+		const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(done) * 4;
+		map_row_scalar(bgra + offset, width - done, lut, biased ? bias_add + offset : nullptr, biased ? bias_sub + offset : nullptr, dst + done);
+	}
+} // namespace SteamShowcaseGen::QuantizerKernels
+#endif
@@ -0,0 +1,51 @@
+// 本编译单元以 AVX-512 F/BW 指令集编译，只包含内核声明与 intrinsics 头文件
+#include "cpu_features.h"
+#include "quantizer_kernels.h"
+
+#if SSG_ARCH_X86
+#include <immintrin.h>
+
+namespace SteamShowcaseGen::QuantizerKernels
+{
+	namespace
+	{
+		template <bool Biased>
+		int map_row_impl(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+		{
+			const __m512i mask_r = _mm512_set1_epi32(0xF800);
+			const __m512i mask_g = _mm512_set1_epi32(0x07E0);
+			const __m512i mask_b = _mm512_set1_epi32(0x001F);
+
+			int x = 0;
+			for (; x + 16 <= width; x += 16)
+			{
+				const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(x) * 4;
+
+				__m512i px = _mm512_loadu_si512(bgra + offset);
+				if constexpr (Biased)
+				{
+					px = _mm512_adds_epu8(px, _mm512_loadu_si512(bias_add + offset));
+					px = _mm512_subs_epu8(px, _mm512_loadu_si512(bias_sub + offset));
+				}
+				const __m512i r	  = _mm512_and_si512(_mm512_srli_epi32(px, 8), mask_r);
+				const __m512i g	  = _mm512_and_si512(_mm512_srli_epi32(px, 5), mask_g);
+				const __m512i b	  = _mm512_and_si512(_mm512_srli_epi32(px, 3), mask_b);
+				const __m512i idx = _mm512_or_si512(_mm512_or_si512(r, g), b);
+
+				// 以字节步长 gather 32 位后截断为 8 位（逆色表末尾有填充，越界读取安全）
+				const __m512i v = _mm512_i32gather_epi32(idx, lut, 1);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm512_cvtepi32_epi8(v));
+			}
+			return x;
+		}
+	} // namespace
+
+	void map_row_avx512(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+	{
+		const bool			 biased = bias_add && bias_sub;
+		const int			 done	= biased ? map_row_impl<true>(bgra, width, lut, bias_add, bias_sub, dst) : map_row_impl<false>(bgra, width, lut, nullptr, nullptr, dst);
+		const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(done) * 4;
+		map_row_scalar(bgra + offset, width - done, lut, biased ? bias_add + offset : nullptr, biased ? bias_sub + offset : nullptr, dst + done);
+	}
+} // namespace SteamShowcaseGen::QuantizerKernels
+#endif
@@ -0,0 +1,53 @@
+// 本编译单元以 SSE4.1 指令集编译，只包含内核声明与 intrinsics 头文件
+#include "cpu_features.h"
+#include "quantizer_kernels.h"
+
+#if SSG_ARCH_X86
+#include <immintrin.h>
+
+namespace SteamShowcaseGen::QuantizerKernels
+{
+	namespace
+	{
+		template <bool Biased>
+		int map_row_impl(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+		{
+			const __m128i mask_r = _mm_set1_epi32(0xF800);
+			const __m128i mask_g = _mm_set1_epi32(0x07E0);
+			const __m128i mask_b = _mm_set1_epi32(0x001F);
+
+			// SSE 没有 gather：向量化计算 4 个像素的表索引，再逐个提取查表
+			int x = 0;
+			for (; x + 4 <= width; x += 4)
+			{
+				const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(x) * 4;
+
+				__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bgra + offset));
+				if constexpr (Biased)
+				{
+					px = _mm_adds_epu8(px, _mm_loadu_si128(reinterpret_cast<const __m128i *>(bias_add + offset)));
+					px = _mm_subs_epu8(px, _mm_loadu_si128(reinterpret_cast<const __m128i *>(bias_sub + offset)));
+				}
+				const __m128i r	  = _mm_and_si128(_mm_srli_epi32(px, 8), mask_r);
+				const __m128i g	  = _mm_and_si128(_mm_srli_epi32(px, 5), mask_g);
+				const __m128i b	  = _mm_and_si128(_mm_srli_epi32(px, 3), mask_b);
+				const __m128i idx = _mm_or_si128(_mm_or_si128(r, g), b);
+
+				dst[x + 0] = lut[_mm_extract_epi32(idx, 0)];
+				dst[x + 1] = lut[_mm_extract_epi32(idx, 1)];
+				dst[x + 2] = lut[_mm_extract_epi32(idx, 2)];
+				dst[x + 3] = lut[_mm_extract_epi32(idx, 3)];
+			}
+			return x;
+		}
+	} // namespace
+
+	void map_row_sse41(const uint8_t *bgra, const int width, const uint8_t *lut, const uint8_t *bias_add, const uint8_t *bias_sub, uint8_t *dst)
+	{
+		const bool			 biased = bias_add && bias_sub;
+		const int			 done	= biased ? map_row_impl<true>(bgra, width, lut, bias_add, bias_sub, dst) : map_row_impl<false>(bgra, width, lut, nullptr, nullptr, dst);
+		const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(done) * 4;
+		map_row_scalar(bgra + offset, width - done, lut, biased ? bias_add + offset : nullptr, biased ? bias_sub + offset : nullptr, dst + done);
+	}
+} // namespace SteamShowcaseGen::QuantizerKernels
+#endif
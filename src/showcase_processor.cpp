@@ -1,17 +1,41 @@
 #include "showcase_processor.h"
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <opencv2/core/utils/logger.hpp>
 #include <opencv2/opencv.hpp>
 #include <ranges>
 #include "app_text.hpp"
+#include "encode_stage.h"
+#include "encoder_pool.h"
+#include "frame_cache.h"
+#include "frame_dedup.h"
+#include "frame_delta.h"
+#include "frame_pool.h"
+#include "frame_resampler.h"
+#include "gif_writer.h"
+#include "palette.h"
+#include "quantizer.h"
+#include "slice_scaler.h"
+#include "slice_view.h"
+#include "thread_pool.h"
+#include "video_decoder.h"
 
 extern "C"
 {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/log.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
@@ -21,9 +45,13 @@ namespace SteamShowcaseGen
 	static const std::string LOG_DIR  = "log";
 	static const std::string LOG_FILE = LOG_DIR + "/debug.log";
 
+	// 批量任务并发写日志，各条消息之间须互斥
+	static std::mutex log_mutex;
+
 	// 辅助函数：写日志到文件
 	static void log_init(const std::string &msg)
 	{
+		std::lock_guard lock(log_mutex);
 		if (!std::filesystem::exists(LOG_DIR))
 		{
 			if (!std::filesystem::create_directories(LOG_DIR))
@@ -38,38 +66,413 @@ namespace SteamShowcaseGen
 		}
 	}
 
-	ShowcaseProcessor::ShowcaseProcessor() = default;
-	ShowcaseProcessor::~ShowcaseProcessor()
+	// 每次启动任务（批量任务整批一次）时清空日志
+	static void log_reset()
 	{
-		stop_task();
+		std::lock_guard lock(log_mutex);
+		if (std::ofstream log_file(LOG_FILE, std::ios::trunc); log_file.is_open())
+		{
+			log_file << "=== Steam Showcase Gen Debug Log ===" << std::endl;
+		}
 	}
 
-	// 初始化 GIF 编码器
-	bool
-	ShowcaseProcessor::init_encoder(EncoderState &state, const std::string &filename, const int width, const int height, const int fps, const int quality_mode)
+	// 进度文本写入调用方的固定缓冲区，避免逐帧分配字符串；超长时截断
+	static std::string_view format_progress(std::array<char, 128> &buffer, const std::size_t frames)
+	{
+		const auto result = std::format_to_n(buffer.data(), buffer.size(), "{}{}", AppText::LOG_ENCODING, frames);
+		return {buffer.data(), static_cast<std::size_t>(result.out - buffer.data())};
+	}
+
+	/**
+	 * @struct ShowcaseProcessor::Impl
+	 * @brief 处理器的实现：任务调度、帧缓存、体积预估与各处理阶段的组合
+	 */
+	struct ShowcaseProcessor::Impl
 	{
-		int			sws_flags;
-		std::string sws_name;
+		Impl() = default;
+		~Impl();
+
+		// 公共接口的实现，说明见 showcase_processor.h
+		JobHandle submit(const std::filesystem::path &source_path,
+						 const std::filesystem::path &output_dir,
+						 const TaskOptions			 &options,
+						 const UpdateCallback		 &on_update);
+		JobHandle submit_batch(const std::vector<std::filesystem::path> &sources,
+							   const std::filesystem::path				&output_dir,
+							   const TaskOptions						&options,
+							   const UpdateCallback						&on_update,
+							   unsigned									 thread_budget);
+		void start_task(const std::filesystem::path &source_path,
+						const std::filesystem::path &output_dir,
+						const TaskOptions			&options,
+						const UpdateCallback		&on_update);
+		void start_batch(const std::vector<std::filesystem::path> &sources,
+						 const std::filesystem::path			  &output_dir,
+						 const TaskOptions						  &options,
+						 const UpdateCallback					  &on_update,
+						 unsigned								   thread_budget);
+		void stop_task();
+
+		std::optional<SizeEstimate> estimate_size(const std::stop_token &st, const std::filesystem::path &source_path, const TaskOptions &options);
+		void request_estimate(const std::filesystem::path &source_path, const TaskOptions &options, const EstimateCallback &on_done);
+		void cancel_estimate(bool wait);
+
+		// 常量定义，切片布局取自 slice_scaler.h
+		static constexpr int STEAM_SHOWCASE_WIDTH = SliceScaler::SHOWCASE_WIDTH;
+		static constexpr int SLICE_WIDTH		  = SliceScaler::SLICE_WIDTH;
+		static constexpr int GAP_WIDTH			  = SliceScaler::GAP_WIDTH;
+		static constexpr int SLICE_COUNT		  = SliceScaler::SLICE_COUNT;
+		static constexpr int GIF_TIME_BASE		  = 100;						// GIF 帧延迟以厘秒为单位
+		static constexpr int QUALITY_LOSSY		  = SliceScaler::QUALITY_LOSSY; // 有损压缩档位
+		static constexpr int MAX_RATE_PASSES	  = 16;							// 体积上限模式的最多编码轮数
+
+		// 批量模式下每个同时处理的文件对应的线程数（含解码线程）
+		static constexpr unsigned BATCH_JOB_THREADS = 4;
 
-		switch (quality_mode)
+		// 全局调色板与体积预估的抽样帧数
+		static constexpr int GLOBAL_PALETTE_SAMPLES = 8;
+		static constexpr int ESTIMATE_SAMPLES		= 8;
+
+		using SliceFrames = EncodeStage::SliceFrames;
+		struct FrameStore;
+		struct RatePlan;
+
+		using JobBody = std::move_only_function<bool(const std::stop_token &, ThreadPool &, JobProgress &)>;
+
+		/**
+		 * @struct ThreadBudget
+		 * @brief 线程预算的划分：每个同时处理的文件占一个解码线程（解码线程数大于 1 时由 FFmpeg 的解码线程代替），
+		 *        其余全部归调度器，缩放、量化、编码与 LZW 压缩都在调度器上执行
+		 */
+		struct ThreadBudget
 		{
-			case 0:
-				sws_flags = SWS_POINT;
-				sws_name  = "SWS_POINT (像素化, 最快)";
-				break;
-			case 3:
-				sws_flags = SWS_LANCZOS;
-				sws_name  = "SWS_LANCZOS (高质量, 最慢)";
-				break;
-			case 1:
-			case 2:
+			unsigned scheduler		 = 1; // 调度器线程数
+			unsigned jobs			 = 1; // 同时处理的文件数
+			int		 decoder_threads = 1; // 每个文件的解码线程数
+		};
+
+		/** @brief 将 budget 个线程（0 表示 CPU 核心数）划分给 files 个文件；decoder_threads 大于 0 时沿用调用方指定的解码线程数 */
+		static ThreadBudget split_threads(unsigned budget, std::size_t files, int decoder_threads);
+
+		/** @brief 处理线程及其任务状态 */
+		struct Job
+		{
+			std::shared_ptr<JobHandle::State> state;
+			std::jthread					  thread;
+		};
+
+		/** @brief 内部执行主循环，成功写出全部切片时返回 true；可在多个线程中并发调用 */
+		bool run_internal(const std::stop_token		  &st,
+						  ThreadPool				  &pool,
+						  const std::filesystem::path &source_path,
+						  const std::filesystem::path &output_dir,
+						  const TaskOptions			  &options,
+						  const UpdateCallback		  &on_update,
+						  JobProgress				  &counters);
+
+		/** @brief 批量模式主循环：jobs 个线程（含调用线程）依次领取源文件并调用 run_internal，全部文件成功时返回 true */
+		bool run_batch(const std::stop_token					&st,
+					   ThreadPool								&pool,
+					   const std::vector<std::filesystem::path> &sources,
+					   const std::filesystem::path				&output_dir,
+					   const TaskOptions						&options,
+					   const UpdateCallback						&on_update,
+					   JobProgress								&counters,
+					   unsigned									 jobs);
+
+		/** @brief 在新的处理线程中执行 body，调度器按 threads 取得 */
+		JobHandle launch(unsigned threads, JobBody body);
+
+		/** @brief 回收已结束的处理线程，调用方须持有 jobs_mutex_ */
+		void reap_jobs();
+
+		/**
+		 * @brief 取得 threads 个线程的共享调度器（0 表示 CPU 核心数），没有任务运行且线程数变化时重建；调用方须持有 jobs_mutex_
+		 *
+		 * 使用方持有返回的引用计数，重建后旧调度器在最后一个使用方结束时释放。
+		 */
+		std::shared_ptr<ThreadPool> scheduler(unsigned threads);
+
+		/** @brief 后台预估线程的主循环：依次执行最新的预估请求 */
+		void estimate_loop(const std::stop_token &st);
+
+		/** @brief 取出与 key 匹配的帧缓存；不匹配时丢弃旧缓存并返回空 */
+		std::unique_ptr<FrameStore> take_cached(const FrameCacheKey &key);
+		void						put_cached(std::unique_ptr<FrameStore> store);
+
+		/** @brief 各源文件的输出子目录 */
+		static std::vector<std::filesystem::path> batch_output_dirs(const std::vector<std::filesystem::path> &sources,
+																	const std::filesystem::path				 &output_dir);
+
+		/** @brief 顺序解码全部选中的帧，缩放后存入 store 并统计全局调色板直方图；被取消或失败时返回 false */
+		static bool fill_store(const std::stop_token &st,
+							   ThreadPool			 &pool,
+							   VideoDecoder			 &decoder,
+							   FrameResampler		 &resampler,
+							   FrameStore			 &store,
+							   const TaskOptions	 &options,
+							   const UpdateCallback	 &on_update,
+							   JobProgress			 &counters);
+
+		/** @brief 体积上限模式：在缓存帧上搜索编码参数，成功写出全部切片时返回 true */
+		static bool run_rate_control(const std::stop_token					  &st,
+									 ThreadPool								  &pool,
+									 const FrameStore						  &store,
+									 const std::vector<std::filesystem::path> &out_paths,
+									 const TaskOptions						  &options,
+									 const UpdateCallback					  &on_update,
+									 int									  &merged_frames,
+									 bool									  &fits);
+
+		/** @brief 将内存中编码好的切片写出到文件 */
+		static bool write_slices(const std::array<std::vector<uint8_t>, SLICE_COUNT> &slices, const std::vector<std::filesystem::path> &out_paths);
+
+		/** @brief 以给定参数在内存中编码缓存的第 [first, last) 帧，返回各切片的完整 GIF 数据 */
+		static std::array<std::vector<uint8_t>, SLICE_COUNT> encode_store(const std::stop_token	&st,
+																		  const FrameStore		&store,
+																		  const RatePlan		&plan,
+																		  const TaskOptions		&options,
+																		  ThreadPool			&pool,
+																		  std::size_t			 first,
+																		  std::size_t			 last,
+																		  int					&merged_frames);
+
+		/** @brief 图片输入按单帧处理，由 OpenCV 直接写出 */
+		static bool is_image(const std::filesystem::path &path);
+
+		// FFmpeg 静态辅助方法；切片的源区域映射与缩放见 slice_scaler.h
+		static bool
+		init_encoder(EncoderState &state, const std::string &filename, int width, int height, const TaskOptions &options, ThreadPool *lzw_pool);
+		static bool scale_slice(EncoderState &state, const SliceView &src, AVFrame *dst);
+		static bool finish_encoder(EncoderState &state);
+
+		static std::optional<Palette> build_global_palette(VideoDecoder &decoder, std::vector<EncoderState> &encoders, int height, int max_colors);
+
+		/** @brief 等待后台预估线程执行的请求 */
+		struct EstimateRequest
+		{
+			std::filesystem::path source_path;
+			TaskOptions			  options;
+			EstimateCallback	  on_done;
+		};
+
+		std::mutex					   estimate_mutex_;
+		std::condition_variable_any	   estimate_cv_;
+		std::optional<EstimateRequest> estimate_pending_; // 尚未开始的最新请求，由 estimate_mutex_ 保护
+		std::stop_source			   estimate_stop_;	  // 正在进行的预估，由 estimate_mutex_ 保护
+		bool						   estimate_busy_ = false;
+		std::jthread				   estimate_thread_;
+		EncoderPool					   encoder_pool_;	  // 任务结束后保留的切片编码状态，供下一个同尺寸任务复用
+		std::mutex					   cache_mutex_;
+		std::unique_ptr<FrameStore>	   frame_cache_;	  // 最近一次完整解码的缩放结果，由 cache_mutex_ 保护
+		std::mutex					   jobs_mutex_;
+		std::shared_ptr<ThreadPool>	   scheduler_;		  // 全部任务共享的工作窃取调度器，由 jobs_mutex_ 保护
+		std::vector<Job>			   jobs_;			  // 由 jobs_mutex_ 保护
+		std::atomic<int>			   active_jobs_{0};
+		JobHandle					   current_job_;	  // start_task/start_batch 启动的任务
+	};
+
+	/**
+	 * @brief 缩放后帧的缓存：解码与缩放只做一次，BGRA 切片供各轮编码反复读取
+	 *
+	 * 每帧在 FrameCache 中依次存放五个切片，切片行距按缓存对齐取整。
+	 * 完整解码得到的缓存在任务结束后保留，源文件与缩放参数不变的后续任务直接复用。
+	 */
+	struct ShowcaseProcessor::Impl::FrameStore
+	{
+		static constexpr int STRIDE = static_cast<int>((SLICE_WIDTH * 4 + FrameCache::ALIGNMENT - 1) / FrameCache::ALIGNMENT * FrameCache::ALIGNMENT);
+
+		FrameCacheKey		 key;
+		FrameCache			 frames;
+		std::vector<int64_t> pts;			   // 输出时间戳（厘秒）
+		ColorHistogram		 histogram;		   // 全局调色板的抽样直方图
+		double				 frame_rate = 0.0; // 缓存帧的采样帧率
+		double				 duration	= 0.0;
+		int					 height		= 0;
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return pts.size();
+		}
+
+		[[nodiscard]] std::size_t slice_bytes() const
+		{
+			return static_cast<std::size_t>(STRIDE) * height;
+		}
+
+		/** @brief 清空并按当前高度、采样帧率与时长准备存放帧，预计帧数决定溢出文件的初始容量 */
+		void reset(const int max_frames)
+		{
+			std::size_t expected = duration > 0 ? static_cast<std::size_t>(std::ceil(duration * frame_rate)) : 0;
+			if (max_frames > 0)
+			{
+				expected = std::min(expected, static_cast<std::size_t>(max_frames));
+			}
+			frames.reset(SLICE_COUNT * slice_bytes(), expected);
+			pts.clear();
+			pts.reserve(expected);
+		}
+
+		/** @brief 分配五个不拥有内存的 BGRA 切片视图，由 bind / append 指向缓存中的帧 */
+		[[nodiscard]] SliceFrames make_views() const
+		{
+			SliceFrames views{};
+			for (auto &view: views)
+			{
+				view = av_frame_alloc();
+				if (view)
+				{
+					view->format = AV_PIX_FMT_BGRA;
+					view->width	 = SLICE_WIDTH;
+					view->height = height;
+				}
+			}
+			return views;
+		}
+
+		static void free_views(SliceFrames &views)
+		{
+			for (auto &view: views)
+			{
+				av_frame_free(&view);
+			}
+		}
+
+		/** @brief 将视图指向第 k 帧的五个切片 */
+		bool bind(const std::size_t k, const SliceFrames &views) const
+		{
+			uint8_t *base = frames.frame(k);
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				if (!views[i] || !FramePool::wrap_plane(views[i], base + i * slice_bytes(), slice_bytes(), STRIDE))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/** @brief 追加一帧并将视图指向其存储，供缩放直接写入；失败时不留下半帧 */
+		bool append(const int64_t timestamp, const SliceFrames &views)
+		{
+			if (!frames.append())
+			{
+				return false;
+			}
+			pts.push_back(timestamp);
+			if (!bind(size() - 1, views))
+			{
+				pop_back();
+				return false;
+			}
+			return true;
+		}
+
+		/** @brief 追加一帧，复制已缩放好的切片 */
+		bool append_copy(const int64_t timestamp, const SliceFrames &scaled)
+		{
+			uint8_t *base = frames.append();
+			if (!base)
+			{
+				return false;
+			}
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				av_image_copy_plane(base + i * slice_bytes(), STRIDE, scaled[i]->data[0], scaled[i]->linesize[0], SLICE_WIDTH * 4, height);
+			}
+			pts.push_back(timestamp);
+			return true;
+		}
+
+		void pop_back()
+		{
+			frames.pop_back();
+			pts.pop_back();
+		}
+
+		/** @brief 均匀抽取 GLOBAL_PALETTE_SAMPLES 帧统计全局调色板的直方图 */
+		void sample_histogram()
+		{
+			histogram.clear();
+			const std::size_t samples = std::min<std::size_t>(GLOBAL_PALETTE_SAMPLES, size());
+			for (std::size_t k = 0; k < samples; ++k)
+			{
+				const uint8_t *base = frames.frame((2 * k + 1) * size() / (2 * samples));
+				for (int i = 0; i < SLICE_COUNT; ++i)
+				{
+					histogram.add(base + i * slice_bytes(), STRIDE, SLICE_WIDTH, height);
+				}
+			}
+		}
+	};
+
+	// 帧缓存的类型在此处才完整，析构须定义在其后
+	ShowcaseProcessor::Impl::~Impl()
+	{
+		cancel_estimate(false);
+		estimate_thread_ = {}; // 请求停止并等待预估线程退出
+
+		// 取消全部尚未结束的任务并等待其线程退出，此后才能释放各任务共用的成员
+		std::lock_guard lock(jobs_mutex_);
+		for (const auto &job: jobs_)
+		{
+			job.state->stop.request_stop();
+		}
+		jobs_.clear();
+	}
+
+	/**
+	 * @brief 码率控制的一组编码参数
+	 */
+	struct ShowcaseProcessor::Impl::RatePlan
+	{
+		int divisor = 1;   // 在缓存帧率基础上的降帧倍数
+		int colors	= 256; // 调色板颜色数
+		int lossy	= 0;   // 有损 LZW 误差预算
+	};
+
+	// 缩放算法的日志名称
+	static std::string_view sws_flags_name(const int sws_flags)
+	{
+		switch (sws_flags)
+		{
+			case SWS_POINT:
+				return "SWS_POINT (像素化, 最快)";
+			case SWS_BILINEAR:
+				return "SWS_BILINEAR (均衡)";
+			case SWS_LANCZOS:
+				return "SWS_LANCZOS (高质量, 最慢)";
 			default:
-				sws_flags = SWS_BICUBIC;
-				sws_name  = "SWS_BICUBIC (平衡)";
-				break;
+				return "SWS_BICUBIC (质量)";
 		}
+	}
 
-		log_init(std::format("[Init] Video encoder - SWS flags: {}", sws_name));
+	// 初始化 GIF 编码器
+	bool ShowcaseProcessor::Impl::init_encoder(
+		EncoderState &state, const std::string &filename, const int width, const int height, const TaskOptions &options, ThreadPool *lzw_pool)
+	{
+		// 缩放上下文依赖源帧尺寸，在首次 scale_slice 时按需创建；池中取回的状态直接沿用
+		state.reset();
+		state.sws_flags = SliceScaler::select_sws_flags(options.quality_mode);
+
+		const bool lossy = options.quality_mode == QUALITY_LOSSY && options.lossy_error > 0;
+		if (options.encoder == EncoderBackend::Native)
+		{
+			if (!state.native)
+			{
+				state.native = std::make_unique<GifWriter>();
+			}
+			if (!state.native->open(filename, width, height, lzw_pool, lossy ? options.lossy_error : 0))
+			{
+				log_init("[Init] ERROR: cannot open output file");
+				return false;
+			}
+			return true;
+		}
+		if (lossy)
+		{
+			log_init("[Init] WARNING: lossy LZW requires the native encoder, falling back to lossless");
+		}
 
 		if (avformat_alloc_output_context2(&state.fmt_ctx, nullptr, "gif", filename.c_str()) < 0 || !state.fmt_ctx)
 		{
@@ -92,199 +495,899 @@ namespace SteamShowcaseGen
 		if (!state.codec_ctx)
 			return false;
 
-		state.codec_ctx->width	   = width;
-		state.codec_ctx->height	   = height;
-		state.codec_ctx->time_base = {1, fps};
-		state.codec_ctx->pix_fmt   = AV_PIX_FMT_RGB8;
+		state.codec_ctx->width	   = width;
+		state.codec_ctx->height	   = height;
+		state.codec_ctx->time_base = {1, GIF_TIME_BASE}; // 时间戳直接以厘秒表示，帧延迟即相邻时间戳之差
+		state.codec_ctx->pix_fmt   = AV_PIX_FMT_PAL8;
+
+		// 帧间增量已在编码前完成（未变化像素标记为透明），编码器只需裁掉四周的透明边框，
+		// 关闭其自带的 transdiff，避免重复逐像素比较
+		if (options.delta_frames)
+		{
+			av_opt_set(state.codec_ctx->priv_data, "gifflags", "offsetting", 0);
+		}
+
+		if (avcodec_open2(state.codec_ctx, codec, nullptr) < 0)
+			return false;
+
+		avcodec_parameters_from_context(state.stream->codecpar, state.codec_ctx);
+
+		if (!(state.fmt_ctx->oformat->flags & AVFMT_NOFILE))
+		{
+			if (avio_open(&state.fmt_ctx->pb, filename.c_str(), AVIO_FLAG_WRITE) < 0)
+			{
+				return false;
+			}
+		}
+
+		return avformat_write_header(state.fmt_ctx, nullptr) >= 0;
+	}
+
+	bool ShowcaseProcessor::Impl::scale_slice(EncoderState &state, const SliceView &src, AVFrame *dst)
+	{
+		return SliceScaler::scale(state.sws_ctx, state.sws_flags, src, dst);
+	}
+
+	std::optional<Palette>
+	ShowcaseProcessor::Impl::build_global_palette(VideoDecoder &decoder, std::vector<EncoderState> &encoders, const int height, const int max_colors)
+	{
+		AVFrame	   *frame = av_frame_alloc();
+		SliceFrames scaled{};
+		bool		ready = frame != nullptr;
+		for (auto &f: scaled)
+		{
+			f	  = SliceScaler::alloc_frame(SLICE_WIDTH, height, AV_PIX_FMT_BGRA);
+			ready = ready && f;
+		}
+
+		// 在全片均匀抽取若干帧，五个切片合并统计直方图
+		ColorHistogram histogram;
+		int			   sampled = 0;
+		for (int k = 0; ready && k < GLOBAL_PALETTE_SAMPLES; ++k)
+		{
+			const double t = decoder.duration() * (k + 0.5) / GLOBAL_PALETTE_SAMPLES;
+			if (!decoder.decode_at(t, frame))
+			{
+				continue;
+			}
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				if (scale_slice(encoders[i], SliceScaler::map_source(*frame, i), scaled[i]))
+				{
+					histogram.add(scaled[i]->data[0], scaled[i]->linesize[0], scaled[i]->width, scaled[i]->height);
+				}
+			}
+			++sampled;
+		}
+
+		av_frame_free(&frame);
+		for (auto &f: scaled)
+		{
+			av_frame_free(&f);
+		}
+
+		if (sampled == 0)
+		{
+			return std::nullopt;
+		}
+		return histogram.build_palette(max_colors);
+	}
+
+	bool ShowcaseProcessor::Impl::finish_encoder(EncoderState &state)
+	{
+		// 缩放上下文、编码输出包与写出器保留在状态中，由 EncoderPool 复用或随状态析构释放
+		// 返回值反映尾部与剩余数据是否完整写出（磁盘已满等 I/O 错误会截断文件）
+		bool written = true;
+		if (state.uses_native())
+		{
+			written = state.native->finish(state.final_delay);
+		}
+		if (!state.fmt_ctx)
+		{
+			return written;
+		}
+
+		if (state.codec_ctx)
+		{
+			EncodeStage::encode_raw_frame(state, nullptr);
+		}
+
+		// GIF 封装器在写尾时才输出最后一帧，其延迟无法由下一帧的时间戳推出
+		if (state.final_delay >= 0)
+		{
+			av_opt_set_int(state.fmt_ctx->priv_data, "final_delay", state.final_delay, 0);
+		}
+		written = av_write_trailer(state.fmt_ctx) >= 0 && written;
+
+		// GIF 编码器不支持冲刷后继续编码（无 AV_CODEC_CAP_ENCODER_FLUSH），编码器与封装上下文每个任务重建
+		state.release_codec();
+		return written;
+	}
+
+	std::array<std::vector<uint8_t>, ShowcaseProcessor::Impl::SLICE_COUNT> ShowcaseProcessor::Impl::encode_store(const std::stop_token &st,
+																												 const FrameStore	   &store,
+																												 const RatePlan		   &plan,
+																												 const TaskOptions	   &options,
+																												 ThreadPool			   &pool,
+																												 const std::size_t		first,
+																												 const std::size_t		last,
+																												 int				   &merged_frames)
+	{
+		std::array<std::vector<uint8_t>, SLICE_COUNT> output;
+
+		// 在缓存帧上再做一次时域重采样，得到降帧后的帧序列与延迟
+		FrameResampler resampler(store.frame_rate / plan.divisor, store.duration, options.max_frames);
+
+		const int palette_colors = options.delta_frames ? std::min(plan.colors, 255) : plan.colors;
+		Quantizer quantizer;
+		quantizer.set_dither(options.dither);
+		if (options.palette_mode == PaletteMode::Global)
+		{
+			quantizer.set_palette(store.histogram.build_palette(palette_colors));
+		}
+		const PaletteMode palette_mode = quantizer.palette().size > 0 ? options.palette_mode : PaletteMode::PerFrame;
+
+		SliceFrames views = store.make_views();
+		SliceFrames quantized{};
+		bool		ready = true;
+		for (auto &f: quantized)
+		{
+			f	  = SliceScaler::alloc_frame(SLICE_WIDTH, store.height, AV_PIX_FMT_PAL8);
+			ready = ready && f;
+		}
+
+		std::vector<EncoderState>	   coders(SLICE_COUNT);
+		std::vector<FrameDelta>		   deltas(SLICE_COUNT);
+		std::vector<DuplicateDetector> dedups(SLICE_COUNT, DuplicateDetector(options.dedup, options.dedup_threshold));
+		for (auto &c: coders)
+		{
+			c.native = std::make_unique<GifWriter>();
+			c.native->open_memory(SLICE_WIDTH, store.height, &pool, plan.lossy);
+		}
+
+		ColorHistogram histogram;
+		for (std::size_t k = first; ready && k < last && !st.stop_requested(); ++k)
+		{
+			if (!resampler.accept(static_cast<double>(store.pts[k]) / GIF_TIME_BASE))
+			{
+				continue;
+			}
+			if (!store.bind(k, views))
+			{
+				break;
+			}
+			const int transparent = EncodeStage::quantize_slices(views, quantized, palette_mode, palette_colors, options.delta_frames, histogram, quantizer);
+			const int colors	  = quantizer.palette().size + (transparent >= 0 ? 1 : 0);
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				EncodeStage::encode_slice_frame(coders[i], deltas[i], dedups[i], views[i], quantized[i], store.pts[k], colors, transparent);
+			}
+		}
+
+		merged_frames = 0;
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			EncoderState &c	   = coders[i];
+			const int64_t tail = c.last_pts >= 0 ? resampler.last_timestamp() - c.last_pts : 0;
+			c.native->finish(resampler.final_delay() + static_cast<int>(tail));
+			output[i] = c.native->bytes();
+			merged_frames += dedups[i].skipped();
+		}
+
+		for (auto &f: quantized)
+		{
+			av_frame_free(&f);
+		}
+		FrameStore::free_views(views);
+		return output;
+	}
+
+	bool ShowcaseProcessor::Impl::fill_store(const std::stop_token &st,
+											 ThreadPool			   &pool,
+											 VideoDecoder		   &decoder,
+											 FrameResampler		   &resampler,
+											 FrameStore			   &store,
+											 const TaskOptions	   &options,
+											 const UpdateCallback  &on_update,
+											 JobProgress		   &counters)
+	{
+		namespace text = SteamShowcaseGen::AppText;
+
+		store.reset(options.max_frames);
+
+		// 五个切片在线程池中并行缩放，直接写入缓存
+		std::vector<EncoderState> scalers(SLICE_COUNT);
+		const int				  sws_flags = SliceScaler::select_sws_flags(options.quality_mode);
+		for (auto &s: scalers)
+		{
+			s.sws_flags = sws_flags;
+		}
+
+		SliceFrames			  views = store.make_views();
+		AVFrame				 *frame = av_frame_alloc();
+		std::string_view	  error = frame ? std::string_view() : text::ERR_CACHE_FAILED;
+		std::array<char, 128> progress;
+
+		// 一帧的五个缩放任务共享的状态：任务只捕获它的地址与切片序号，post 逐帧提交不产生堆分配
+		struct ScaleBatch
+		{
+			std::vector<EncoderState> &scalers;
+			const SliceFrames		  &views;
+			const AVFrame			  *frame;
+			std::atomic<int>		   pending{0};
+			std::atomic<bool>		   failed{false};
+			std::atomic<int>		   tasks{0}; // 尚未返回的缩放任务数：任务在 notify 之后才递减，离开本函数前等待其归零
+		};
+		ScaleBatch batch{scalers, views, frame};
+
+		decoder.set_frame_selector(&resampler);
+		while (error.empty() && !st.stop_requested() && decoder.decode_next(frame))
+		{
+			// 追加失败说明缓存内存不足，或溢出文件无法创建、扩展（临时目录空间不足）
+			if (!store.append(resampler.last_timestamp(), views))
+			{
+				error = text::ERR_CACHE_FAILED;
+				break;
+			}
+
+			batch.pending.store(SLICE_COUNT);
+			batch.tasks.fetch_add(SLICE_COUNT, std::memory_order_relaxed);
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				pool.post(
+					[&batch, i]
+					{
+						if (!scale_slice(batch.scalers[i], SliceScaler::map_source(*batch.frame, i), batch.views[i]))
+						{
+							batch.failed.store(true);
+						}
+						if (batch.pending.fetch_sub(1) == 1)
+						{
+							batch.pending.notify_one();
+						}
+						batch.tasks.fetch_sub(1, std::memory_order_release); // 此后不再访问 batch
+					});
+			}
+			for (int left; (left = batch.pending.load()) != 0;)
+			{
+				batch.pending.wait(left);
+			}
+			if (batch.failed.load())
+			{
+				error = text::ERR_SCALE_FAILED;
+				break;
+			}
+
+			++counters.frames;
+			if (store.size() % 10 == 0 && on_update)
+			{
+				on_update(format_progress(progress, store.size()));
+			}
+		}
+		// pending 归零后最后一个任务仍要调用 notify_one，batch 与缩放状态须等任务全部返回后才能释放
+		while (batch.tasks.load(std::memory_order_acquire) != 0)
+		{
+			if (!pool.run_pending())
+			{
+				std::this_thread::yield();
+			}
+		}
+		av_frame_free(&frame);
+		FrameStore::free_views(views);
+		decoder.set_frame_selector(nullptr);
+		if (st.stop_requested())
+		{
+			return false;
+		}
+		if (error.empty() && store.size() == 0)
+		{
+			error = text::ERR_NO_FRAMES;
+		}
+		if (!error.empty())
+		{
+			log_init(std::format("[Cache] ERROR: caching stopped after {} frames", store.size()));
+			if (on_update)
+			{
+				on_update(error);
+			}
+			return false;
+		}
+
+		// 全局调色板的抽样直方图只统计一次，各轮编码按颜色数重新切分
+		store.sample_histogram();
+		log_init(std::format("[Cache] {} frames cached{}", store.size(), store.frames.spilled() ? " (spilled to temp file)" : ""));
+		return true;
+	}
+
+	bool ShowcaseProcessor::Impl::run_rate_control(const std::stop_token					&st,
+												   ThreadPool								&pool,
+												   const FrameStore							&store,
+												   const std::vector<std::filesystem::path>	&out_paths,
+												   const TaskOptions						&options,
+												   const UpdateCallback						&on_update,
+												   int										&merged_frames,
+												   bool										&fits)
+	{
+		namespace text = SteamShowcaseGen::AppText;
+
+		// 1. 搜索：先在前 MILD_LEVELS 档内逐级加大有损程度、减少颜色，仍放不下再按体积比例降帧，
+		//    降帧一旦放得下，在上一次放不下的倍数与当前倍数之间二分，尽量保留帧率
+		constexpr std::size_t MILD_LEVELS = 4;
+		const int			  colors	  = options.palette_colors;
+		const int			  lossy		  = options.quality_mode == QUALITY_LOSSY ? options.lossy_error : 0;
+
+		const std::array<RatePlan, 6> levels = {RatePlan{1, colors, lossy},
+												RatePlan{1, colors, std::max(lossy, 24)},
+												RatePlan{1, colors, std::max(lossy, 48)},
+												RatePlan{1, std::min(colors, 128), std::max(lossy, 48)},
+												RatePlan{1, std::min(colors, 128), std::max(lossy, 80)},
+												RatePlan{1, std::min(colors, 64), std::max(lossy, 80)}};
+
+		const std::size_t target	   = options.target_bytes;
+		const int		  max_divisor  = static_cast<int>(store.size());
+		std::size_t		  level		   = 0;
+		int				  divisor	   = 1;
+		int				  fail_divisor = 0; // 已知放不下的最大降帧倍数
+		int				  fit_divisor  = 0; // 已知放得下的最小降帧倍数
+
+		std::array<std::vector<uint8_t>, SLICE_COUNT> output;
+		fits = false;
+
+		for (int pass = 1; pass <= MAX_RATE_PASSES && !st.stop_requested(); ++pass)
+		{
+			RatePlan plan = levels[level];
+			plan.divisor  = divisor;
+
+			int		   merged = 0;
+			auto	   result = encode_store(st, store, plan, options, pool, 0, store.size(), merged);
+			const auto largest =
+				std::ranges::max(result | std::views::transform([](const std::vector<uint8_t> &bytes) { return bytes.size(); }));
+
+			log_init(std::format("[Rate] pass {}: divisor {} colors {} lossy {} -> largest slice {} bytes", pass, divisor, plan.colors, plan.lossy, largest));
+			if (on_update)
+			{
+				const std::size_t largest_kb = largest / 1024;
+				on_update(std::vformat(text::LOG_RATE_PASS, std::make_format_args(pass, largest_kb, divisor, plan.colors, plan.lossy)));
+			}
+
+			if (largest <= target)
+			{
+				fits		  = true;
+				fit_divisor	  = divisor;
+				output		  = std::move(result);
+				merged_frames = merged;
+			}
+			else if (fits)
+			{
+				fail_divisor = divisor;
+			}
+			else
+			{
+				// 尚未找到可行解：最后一次结果作为兜底输出
+				output		  = std::move(result);
+				merged_frames = merged;
+				if (level + 1 < MILD_LEVELS)
+				{
+					++level;
+					continue;
+				}
+				if (divisor < max_divisor)
+				{
+					const double ratio = static_cast<double>(largest) / static_cast<double>(target);
+					fail_divisor	   = divisor;
+					divisor			   = std::clamp(static_cast<int>(std::ceil(divisor * ratio * 1.05)), divisor + 1, max_divisor);
+					continue;
+				}
+				if (level + 1 < levels.size())
+				{
+					// 只剩一帧仍放不下：进一步降质，之后重新在全范围内二分帧率
+					++level;
+					fail_divisor = 0;
+					continue;
+				}
+				break;
+			}
+
+			// 已有可行解：二分收紧降帧倍数
+			if (fit_divisor - fail_divisor <= 1)
+			{
+				break;
+			}
+			divisor = (fit_divisor + fail_divisor) / 2;
+		}
+		if (st.stop_requested())
+		{
+			return false;
+		}
+
+		// 2. 写出选定的结果
+		return write_slices(output, out_paths);
+	}
+
+	bool ShowcaseProcessor::Impl::write_slices(const std::array<std::vector<uint8_t>, SLICE_COUNT> &slices, const std::vector<std::filesystem::path> &out_paths)
+	{
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			std::ofstream file(out_paths[i], std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char *>(slices[i].data()), static_cast<std::streamsize>(slices[i].size()));
+			if (!file)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ShowcaseProcessor::apply_steam_hex_hack(const std::filesystem::path &file_path)
+	{
+		std::fstream file(file_path, std::ios::binary | std::ios::in | std::ios::out);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file.seekg(-1, std::ios::end);
+		char last = 0;
+		if (file.read(&last, 1) && static_cast<unsigned char>(last) == 0x3B)
+		{
+			file.seekp(-1, std::ios::end);
+			// 修改 0x3B 为 0x21 以欺骗 Steam 长度检测
+			constexpr char next = 0x21;
+			file.write(&next, 1);
+			file.close();
+			return true;
+		}
+		file.close();
+		return false;
+	}
+
+	bool ShowcaseProcessor::is_supported(const std::filesystem::path &path)
+	{
+		static constexpr std::array supported = {".mp4", ".avi", ".mov", ".mkv", ".png", ".jpg", ".jpeg", ".bmp", ".webp", ".tif", ".tiff"};
+		std::string					ext		  = path.extension().string();
+		std::ranges::transform(ext, ext.begin(), ::tolower);
+		return std::ranges::any_of(supported, [&](const auto s) { return s == ext; });
+	}
+
+	void ShowcaseProcessor::silence_library_logs()
+	{
+		cv::utils::logging::setLogLevel(cv::utils::logging::LOG_LEVEL_SILENT);
+		av_log_set_level(AV_LOG_QUIET);
+	}
+
+	bool ShowcaseProcessor::Impl::is_image(const std::filesystem::path &path)
+	{
+		std::string ext = path.extension().string();
+		std::ranges::transform(ext, ext.begin(), ::tolower);
+		return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".webp" || ext == ".tif" || ext == ".tiff";
+	}
+
+	std::optional<ShowcaseProcessor::SizeEstimate>
+	ShowcaseProcessor::Impl::estimate_size(const std::stop_token &st, const std::filesystem::path &source_path, const TaskOptions &options)
+	{
+		if (is_image(source_path))
+		{
+			return std::nullopt;
+		}
+
+		VideoDecoder decoder;
+		if (!decoder.open(source_path, options.decoder) || decoder.width() <= 0 || decoder.height() <= 0 || decoder.duration() <= 0)
+		{
+			return std::nullopt;
+		}
+
+		// 与 run_internal 相同的采样参数：delay 为一个输出采样间隔（厘秒）
+		const double		 fps	  = decoder.frame_rate() > 0 ? decoder.frame_rate() : 30;
+		const int			 height	  = static_cast<int>(STEAM_SHOWCASE_WIDTH * (static_cast<double>(decoder.height()) / decoder.width()));
+		const FrameResampler sampling(fps / (11 - options.sampling_rate), decoder.duration(), options.max_frames);
+		const int			 delay	  = sampling.final_delay();
+		const double		 interval = static_cast<double>(delay) / GIF_TIME_BASE;
 
-		if (quality_mode >= 2)
+		SizeEstimate estimate;
+		estimate.frames = static_cast<int>(std::ceil(decoder.duration() / interval - 1e-6));
+		if (options.max_frames > 0)
 		{
-			av_opt_set(state.codec_ctx->priv_data, "diff", "1", 0);
+			estimate.frames = std::min(estimate.frames, options.max_frames);
 		}
+		estimate.frames = std::max(estimate.frames, 1);
 
-		if (avcodec_open2(state.codec_ctx, codec, nullptr) < 0)
-			return false;
+		// 1. 抽样：每组两帧存入缓存，第二帧的时间戳恰好落在下一个采样区间
+		FrameStore store;
+		store.frame_rate = static_cast<double>(GIF_TIME_BASE) / delay;
+		store.height	 = height;
+		store.reset(options.max_frames);
 
-		avcodec_parameters_from_context(state.stream->codecpar, state.codec_ctx);
+		std::vector<EncoderState> scalers(SLICE_COUNT);
+		const int				  sws_flags = SliceScaler::select_sws_flags(options.quality_mode);
+		for (auto &s: scalers)
+		{
+			s.sws_flags = sws_flags;
+		}
 
-		if (!(state.fmt_ctx->oformat->flags & AVFMT_NOFILE))
+		SliceFrames views		= store.make_views();
+		auto		cache_frame = [&](const AVFrame &frame, const int64_t pts)
 		{
-			if (avio_open(&state.fmt_ctx->pb, filename.c_str(), AVIO_FLAG_WRITE) < 0)
+			if (!store.append(pts, views))
 			{
 				return false;
 			}
+			bool ready = true;
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				ready = ready && scale_slice(scalers[i], SliceScaler::map_source(frame, i), views[i]);
+			}
+			if (!ready)
+			{
+				store.pop_back();
+			}
+			return ready;
+		};
+
+		AVFrame *frame = av_frame_alloc();
+		for (int k = 0; frame && k < ESTIMATE_SAMPLES && !st.stop_requested(); ++k)
+		{
+			const double t = decoder.duration() * (2 * k + 1) / (2 * ESTIMATE_SAMPLES);
+			if (!decoder.decode_at(t, frame, st))
+			{
+				continue;
+			}
+			if (!cache_frame(*frame, 0))
+			{
+				continue;
+			}
+
+			const double next  = decoder.frame_time(*frame) + interval;
+			bool		 found = false;
+			while (!st.stop_requested() && decoder.decode_next(frame))
+			{
+				if (decoder.frame_time(*frame) >= next - 1e-3)
+				{
+					found = true;
+					break;
+				}
+			}
+			if (!found || !cache_frame(*frame, delay))
+			{
+				// 素材末尾凑不齐一组时丢弃这一组的首帧
+				store.pop_back();
+			}
 		}
+		av_frame_free(&frame);
+		FrameStore::free_views(views);
+		const std::size_t groups = store.size() / 2;
+		if (st.stop_requested() || groups == 0)
+		{
+			return std::nullopt;
+		}
+		store.sample_histogram();
 
-		if (avformat_write_header(state.fmt_ctx, nullptr) < 0)
+		// 2. 每组分别编码首帧和两帧，差值即一个增量帧的体积
+		// LZW 压缩交给共享调度器，预估不另行创建线程；调度器按同样配置的单任务划分线程预算，随后开始处理时无需重建
+		std::shared_ptr<ThreadPool> pool;
 		{
-			return false;
+			std::lock_guard lock(jobs_mutex_);
+			pool = scheduler(split_threads(options.threads, 1, options.decoder.thread_count).scheduler);
 		}
+		const RatePlan plan{1, options.palette_colors, options.quality_mode == QUALITY_LOSSY ? options.lossy_error : 0};
 
-		state.frame = av_frame_alloc();
-		if (!state.frame)
+		std::array<std::size_t, SLICE_COUNT> first_bytes{};
+		std::array<std::size_t, SLICE_COUNT> delta_bytes{};
+		for (std::size_t g = 0; g < groups && !st.stop_requested(); ++g)
 		{
-			return false;
+			int		   merged = 0;
+			const auto single = encode_store(st, store, plan, options, *pool, 2 * g, 2 * g + 1, merged);
+			const auto pair	  = encode_store(st, store, plan, options, *pool, 2 * g, 2 * g + 2, merged);
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				first_bytes[i] += single[i].size();
+				delta_bytes[i] += pair[i].size() - std::min(pair[i].size(), single[i].size());
+			}
 		}
-		state.frame->format = state.codec_ctx->pix_fmt;
-		state.frame->width	= width;
-		state.frame->height = height;
-		if (av_frame_get_buffer(state.frame, 32) < 0)
+		if (st.stop_requested())
 		{
-			return false;
+			return std::nullopt;
 		}
 
-		state.sws_ctx = sws_getContext(width, height, AV_PIX_FMT_BGR24, width, height, AV_PIX_FMT_RGB8, sws_flags, nullptr, nullptr, nullptr);
-
-		state.frame_count = 0;
-		return true;
-	}
-
-	// 核心改进：修复了重复分支与性能问题的编码函数
-	void ShowcaseProcessor::encode_raw_frame(const EncoderState &state, const AVFrame *raw_frame)
-	{
-		if (!state.codec_ctx)
+		for (int i = 0; i < SLICE_COUNT; ++i)
 		{
-			return;
+			estimate.slice_bytes.push_back((first_bytes[i] + delta_bytes[i] * static_cast<std::size_t>(estimate.frames - 1)) / groups);
 		}
+		log_init(std::format("[Estimate] {} groups, {} frames -> largest slice {} bytes", groups, estimate.frames, estimate.largest()));
+		return estimate;
+	}
 
-		// 1. 发送帧
-		if (const int ret = avcodec_send_frame(state.codec_ctx, raw_frame); ret < 0)
+	void ShowcaseProcessor::Impl::request_estimate(const std::filesystem::path &source_path, const TaskOptions &options, const EstimateCallback &on_done)
+	{
+		std::lock_guard lock(estimate_mutex_);
+		estimate_stop_.request_stop();
+		estimate_pending_ = EstimateRequest{source_path, options, on_done};
+		if (!estimate_thread_.joinable())
 		{
-			return;
+			estimate_thread_ = std::jthread([this](const std::stop_token &st) { estimate_loop(st); });
 		}
+		estimate_cv_.notify_all();
+	}
 
-		// 2. 预先分配一次 Packet，用于在循环中复用
-		AVPacket *pkt = av_packet_alloc();
-		if (!pkt)
+	void ShowcaseProcessor::Impl::cancel_estimate(const bool wait)
+	{
+		std::unique_lock lock(estimate_mutex_);
+		estimate_stop_.request_stop();
+		estimate_pending_.reset();
+		if (wait)
 		{
-			return;
+			estimate_cv_.wait(lock, [this] { return !estimate_busy_; });
 		}
+	}
 
-		// 3. 循环接收所有编码好的包。只要返回 0 说明有新数据
-		while (avcodec_receive_packet(state.codec_ctx, pkt) == 0)
+	void ShowcaseProcessor::Impl::estimate_loop(const std::stop_token &st)
+	{
+		std::unique_lock lock(estimate_mutex_);
+		while (estimate_cv_.wait(lock, st, [this] { return estimate_pending_.has_value(); }))
 		{
-			// 时间戳转换
-			av_packet_rescale_ts(pkt, state.codec_ctx->time_base, state.stream->time_base);
-			pkt->stream_index = state.stream->index;
+			// 只执行最新的请求：执行期间到达的请求会取消本次预估并替换待执行的请求
+			EstimateRequest request = std::move(*estimate_pending_);
+			estimate_pending_.reset();
+			estimate_stop_				= std::stop_source();
+			const std::stop_token token = estimate_stop_.get_token();
+			estimate_busy_				= true;
+			lock.unlock();
 
-			// 写入封装层
-			av_interleaved_write_frame(state.fmt_ctx, pkt);
+			const auto estimate = estimate_size(token, request.source_path, request.options);
+			if (!token.stop_requested() && request.on_done)
+			{
+				request.on_done(estimate);
+			}
 
-			// 重要：清除 packet 的 buffer 引用，以便下一次循环复用结构体
-			av_packet_unref(pkt);
+			lock.lock();
+			estimate_busy_ = false;
+			estimate_cv_.notify_all();
 		}
+	}
 
-		// 4. 处理完毕，彻底释放
-		av_packet_free(&pkt);
+	JobHandle ShowcaseProcessor::Impl::submit(const std::filesystem::path &source_path,
+											  const std::filesystem::path &output_dir,
+											  const TaskOptions			  &options,
+											  const UpdateCallback		  &on_update)
+	{
+		const ThreadBudget budget		 = split_threads(options.threads, 1, options.decoder.thread_count);
+		TaskOptions		   job_options	 = options;
+		job_options.decoder.thread_count = budget.decoder_threads;
+		return launch(budget.scheduler,
+					  [this, source_path, output_dir, job_options, on_update](const std::stop_token &st, ThreadPool &pool, JobProgress &counters)
+					  {
+						  const bool ok = run_internal(st, pool, source_path, output_dir, job_options, on_update, counters);
+						  counters.failures.store(ok ? 0 : 1);
+						  counters.files_done.store(1);
+						  return ok;
+					  });
 	}
 
-	void ShowcaseProcessor::push_frame(EncoderState &state, const cv::Mat &cv_frame, const int height)
+	JobHandle ShowcaseProcessor::Impl::submit_batch(const std::vector<std::filesystem::path> &sources,
+													const std::filesystem::path				 &output_dir,
+													const TaskOptions						 &options,
+													const UpdateCallback					 &on_update,
+													const unsigned							  thread_budget)
 	{
-		if (!state.codec_ctx || !state.sws_ctx || !state.frame)
-		{
-			return;
-		}
+		// 批量任务由同时处理的文件数提供解码并行度，各文件的解码线程数总是按预算划分
+		const ThreadBudget budget		 = split_threads(thread_budget, sources.size(), 0);
+		TaskOptions		   job_options	 = options;
+		job_options.decoder.thread_count = budget.decoder_threads;
+		job_options.frame_cache			 = false; // 帧缓存只保留最近一份，批量任务之间无从复用
+		log_init(std::format("[Batch] {} files, {} concurrent jobs, {} scheduler threads, {} decoder threads per job",
+							 sources.size(),
+							 budget.jobs,
+							 budget.scheduler,
+							 budget.decoder_threads));
+		return launch(budget.scheduler,
+					  [this, sources, output_dir, job_options, on_update, jobs = budget.jobs](
+						  const std::stop_token &st, ThreadPool &pool, JobProgress &counters)
+					  { return run_batch(st, pool, sources, output_dir, job_options, on_update, counters, jobs); });
+	}
+
+	void ShowcaseProcessor::Impl::start_task(const std::filesystem::path &source_path,
+											 const std::filesystem::path &output_dir,
+											 const TaskOptions			 &options,
+											 const UpdateCallback		 &on_update)
+	{
+		// 预估不计入运行中的任务，须先结束，其持有的调度器才不会与按新线程数重建的调度器同时运行
+		cancel_estimate(true);
+		stop_task();
+		log_reset();
+		current_job_ = submit(source_path, output_dir, options, on_update);
+	}
 
-		const uint8_t *src_slice[]	= {cv_frame.data};
-		const int	   src_stride[] = {static_cast<int>(cv_frame.step)};
+	void ShowcaseProcessor::Impl::start_batch(const std::vector<std::filesystem::path> &sources,
+											  const std::filesystem::path			   &output_dir,
+											  const TaskOptions						   &options,
+											  const UpdateCallback					   &on_update,
+											  const unsigned							thread_budget)
+	{
+		cancel_estimate(true);
+		stop_task();
+		log_reset();
+		current_job_ = submit_batch(sources, output_dir, options, on_update, thread_budget);
+	}
 
-		if (av_frame_make_writable(state.frame) < 0)
+	void ShowcaseProcessor::Impl::stop_task()
+	{
+		if (current_job_.valid())
 		{
-			return;
+			current_job_.cancel();
+			current_job_.result().wait();
+			current_job_ = JobHandle();
 		}
+	}
+
+	ShowcaseProcessor::Impl::ThreadBudget ShowcaseProcessor::Impl::split_threads(const unsigned budget, const std::size_t files, const int decoder_threads)
+	{
+		// 每个文件的处理线程本身负责解复用与解码（解码线程数为 1 时不另开线程），其余线程只在调度器上执行任务，
+		// 因此线程总数约等于预算；处理线程在解码线程数大于 1 时只等待 FFmpeg 的解码线程，不计入预算
+		const unsigned total = budget ? budget : std::max(1u, std::thread::hardware_concurrency());
 
-		sws_scale(state.sws_ctx, src_slice, src_stride, 0, height, state.frame->data, state.frame->linesize);
+		ThreadBudget split;
+		split.jobs			  = static_cast<unsigned>(std::clamp<std::size_t>(total / BATCH_JOB_THREADS, 1, std::max<std::size_t>(files, 1)));
+		split.decoder_threads = decoder_threads > 0 ? decoder_threads : static_cast<int>(std::max(1u, total / (split.jobs * BATCH_JOB_THREADS)));
 
-		state.frame->pts = state.frame_count++;
-		encode_raw_frame(state, state.frame);
+		const unsigned reserved = split.jobs * static_cast<unsigned>(split.decoder_threads);
+		split.scheduler			= total > reserved ? total - reserved : 1;
+		return split;
 	}
 
-	void ShowcaseProcessor::finish_encoder(EncoderState &state)
+	JobHandle ShowcaseProcessor::Impl::launch(const unsigned threads, JobBody body)
 	{
-		if (!state.fmt_ctx)
-		{
-			return;
-		}
+		auto			   state = std::make_shared<JobHandle::State>();
+		std::promise<bool> promise;
+		state->result = promise.get_future().share();
 
-		if (state.codec_ctx)
-		{
-			encode_raw_frame(state, nullptr);
-		}
+		std::lock_guard lock(jobs_mutex_);
+		reap_jobs();
+		auto pool = scheduler(threads);
+		active_jobs_.fetch_add(1);
+		jobs_.push_back({state,
+						 std::jthread(
+							 [this, state, pool, body = std::move(body), promise = std::move(promise)]() mutable
+							 {
+								 const bool ok = body(state->stop.get_token(), *pool, state->progress);
+								 // 先减少计数再发布结果：等待结果返回后 is_active() 已反映该任务结束
+								 active_jobs_.fetch_sub(1);
+								 promise.set_value(ok);
+							 })});
+		return JobHandle(state);
+	}
 
-		av_write_trailer(state.fmt_ctx);
+	void ShowcaseProcessor::Impl::reap_jobs()
+	{
+		// 结果已发布的线程只剩退出，join 不会阻塞
+		std::erase_if(jobs_, [](const Job &job) { return job.state->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+	}
 
-		if (!(state.fmt_ctx->oformat->flags & AVFMT_NOFILE))
+	std::shared_ptr<ThreadPool> ShowcaseProcessor::Impl::scheduler(const unsigned threads)
+	{
+		// 只在没有任务运行时按新的线程数重建，同时进行的任务始终共用一个调度器
+		const unsigned count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+		if (!scheduler_ || (active_jobs_.load() == 0 && scheduler_->size() != count))
 		{
-			avio_closep(&state.fmt_ctx->pb);
+			scheduler_ = std::make_shared<ThreadPool>(count);
 		}
+		return scheduler_;
+	}
 
-		if (state.codec_ctx)
-		{
-			avcodec_free_context(&state.codec_ctx);
-			state.codec_ctx = nullptr;
-		}
-		if (state.frame)
-		{
-			av_frame_free(&state.frame);
-			state.frame = nullptr;
-		}
-		if (state.sws_ctx)
+	std::unique_ptr<ShowcaseProcessor::Impl::FrameStore> ShowcaseProcessor::Impl::take_cached(const FrameCacheKey &key)
+	{
+		std::lock_guard lock(cache_mutex_);
+		if (frame_cache_ && frame_cache_->key == key)
 		{
-			sws_freeContext(state.sws_ctx);
-			state.sws_ctx = nullptr;
+			return std::move(frame_cache_);
 		}
+		frame_cache_.reset(); // 源文件或缩放参数已变化，旧缓存不再可用，尽早释放内存
+		return nullptr;
+	}
 
-		avformat_free_context(state.fmt_ctx);
-		state.fmt_ctx = nullptr;
+	void ShowcaseProcessor::Impl::put_cached(std::unique_ptr<FrameStore> store)
+	{
+		std::lock_guard lock(cache_mutex_);
+		frame_cache_ = std::move(store);
 	}
 
-	bool ShowcaseProcessor::apply_steam_hex_hack(const std::filesystem::path &file_path)
+	std::vector<std::filesystem::path> ShowcaseProcessor::Impl::batch_output_dirs(const std::vector<std::filesystem::path> &sources,
+																				  const std::filesystem::path			   &output_dir)
 	{
-		std::fstream file(file_path, std::ios::binary | std::ios::in | std::ios::out);
-		if (!file.is_open())
+		// 通常以主文件名命名；主文件名相同的源文件（如 a.mp4 与 a.gif）改用带扩展名的名称区分
+		std::vector<std::filesystem::path> dirs;
+		dirs.reserve(sources.size());
+		for (const auto &source: sources)
 		{
-			return false;
+			const auto stem		 = source.stem();
+			const bool ambiguous = std::ranges::count_if(sources, [&](const auto &other) { return other.stem() == stem; }) > 1;
+			if (!ambiguous)
+			{
+				dirs.push_back(output_dir / stem);
+				continue;
+			}
+			std::string extension = source.extension().string();
+			std::ranges::replace(extension, '.', '_');
+			dirs.push_back(output_dir / (stem.string() + extension));
 		}
-		file.seekg(-1, std::ios::end);
-		char last = 0;
-		if (file.read(&last, 1) && static_cast<unsigned char>(last) == 0x3B)
+		return dirs;
+	}
+
+	bool ShowcaseProcessor::Impl::run_batch(const std::stop_token					 &st,
+											ThreadPool								 &pool,
+											const std::vector<std::filesystem::path> &sources,
+											const std::filesystem::path				 &output_dir,
+											const TaskOptions						 &options,
+											const UpdateCallback					 &on_update,
+											JobProgress								 &counters,
+											const unsigned							  jobs)
+	{
+		namespace text = SteamShowcaseGen::AppText;
+		counters.files_total.store(sources.size());
+		if (sources.empty())
 		{
-			file.seekp(-1, std::ios::end);
-			// 修改 0x3B 为 0x21 以欺骗 Steam 长度检测
-			constexpr char next = 0x21;
-			file.write(&next, 1);
-			file.close();
 			return true;
 		}
-		file.close();
-		return false;
-	}
 
-	void ShowcaseProcessor::start_task(
-		const std::filesystem::path &source_path, const std::filesystem::path &output_dir, int sampling_rate, int quality_mode, const UpdateCallback &on_update)
-	{
-		stop_task();
-		worker_thread_ = std::jthread([this, source_path, output_dir, sampling_rate, quality_mode, on_update](const std::stop_token &st)
-									  { this->run_internal(st, source_path, output_dir, sampling_rate, quality_mode, on_update); });
-	}
+		// 同时进行的任务数只决定有多少条流水线可供调度器的空闲线程窃取；每个任务的处理线程只负责解码，
+		// 调用线程本身也领取文件，不额外占用线程
+		const auto				 out_dirs = batch_output_dirs(sources, output_dir);
+		std::atomic<std::size_t> next{0};
+		auto					 work = [&]
+		{
+			for (std::size_t k = next++; k < sources.size() && !st.stop_requested(); k = next++)
+			{
+				// 各任务的进度消息带上序号与文件名，便于在同一行日志中区分
+				const std::string prefix = std::format("[{}/{}] {}: ", k + 1, sources.size(), sources[k].filename().string());
+				UpdateCallback	  job_update;
+				if (on_update)
+				{
+					// 逐帧的进度消息在栈上拼接，超出缓冲区时才分配
+					job_update = [&](const std::string_view msg)
+					{
+						std::array<char, 512> buffer;
+						const auto			  result = std::format_to_n(buffer.data(), buffer.size(), "{}{}", prefix, msg);
+						if (result.size > static_cast<std::ptrdiff_t>(buffer.size()))
+						{
+							on_update(std::format("{}{}", prefix, msg));
+							return;
+						}
+						on_update({buffer.data(), static_cast<std::size_t>(result.size)});
+					};
+				}
+				if (!run_internal(st, pool, sources[k], out_dirs[k], options, job_update, counters))
+				{
+					++counters.failures;
+				}
+				++counters.files_done;
+			}
+		};
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(jobs - 1);
+			for (unsigned w = 1; w < jobs; ++w)
+			{
+				workers.emplace_back(work);
+			}
+			work();
+		}
 
-	void ShowcaseProcessor::stop_task()
-	{
-		if (worker_thread_.joinable())
+		const std::size_t failures = counters.failures.load();
+		if (on_update && !st.stop_requested())
 		{
-			worker_thread_.request_stop();
-			worker_thread_.join();
+			const std::size_t successes = sources.size() - failures;
+			on_update(std::format("{}{}", std::vformat(text::LOG_BATCH_FINISHED, std::make_format_args(successes, failures)), output_dir.string()));
 		}
+		return !st.stop_requested() && failures == 0;
 	}
 
-	void ShowcaseProcessor::run_internal(const std::stop_token		 &st,
-										 const std::filesystem::path &source_path,
-										 const std::filesystem::path &output_dir,
-										 const int					  sampling_rate,
-										 const int					  quality_mode,
-										 const UpdateCallback		 &on_update)
+	bool ShowcaseProcessor::Impl::run_internal(const std::stop_token	   &st,
+											   ThreadPool				   &pool,
+											   const std::filesystem::path &source_path,
+											   const std::filesystem::path &output_dir,
+											   const TaskOptions		   &options,
+											   const UpdateCallback		   &on_update,
+											   JobProgress				   &counters)
 	{
-		is_processing_.store(true);
+		const int sampling_rate = options.sampling_rate;
+		const int quality_mode	= options.quality_mode;
 		namespace text = SteamShowcaseGen::AppText;
 
 		if (!std::filesystem::exists(output_dir))
@@ -292,20 +1395,13 @@ namespace SteamShowcaseGen
 			std::filesystem::create_directories(output_dir);
 		}
 
-		std::ofstream log_clear(LOG_FILE, std::ios::trunc);
-		log_clear << "=== Steam Showcase Gen Debug Log ===" << std::endl;
-		log_clear.close();
-
 		if (on_update)
 		{
 			on_update(text::LOG_STARTING);
 		}
 
-		std::string ext = source_path.extension().string();
-		std::ranges::transform(ext, ext.begin(), ::tolower);
-
 		// 处理图片
-		if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".webp" || ext == ".tif" || ext == ".tiff")
+		if (is_image(source_path))
 		{
 			cv::Mat img = cv::imread(source_path.string(), cv::IMREAD_COLOR);
 			if (img.empty())
@@ -314,8 +1410,7 @@ namespace SteamShowcaseGen
 				{
 					on_update(text::ERR_OPEN_FAILED);
 				}
-				is_processing_.store(false);
-				return;
+				return false;
 			}
 
 			double aspect_ratio = static_cast<double>(img.rows) / img.cols;
@@ -341,87 +1436,343 @@ namespace SteamShowcaseGen
 			{
 				on_update(std::format("{}{}", text::LOG_FINISHED, output_dir.string()));
 			}
-			is_processing_.store(false);
-			return;
+			++counters.frames;
+			return true;
 		}
 
 		// 处理视频
-		cv::VideoCapture cap(source_path.string());
-		if (!cap.isOpened())
+		VideoDecoder decoder;
+		if (!decoder.open(source_path, options.decoder) || decoder.width() <= 0 || decoder.height() <= 0)
 		{
 			if (on_update)
 			{
 				on_update(text::ERR_OPEN_FAILED);
 			}
-			is_processing_.store(false);
-			return;
+			return false;
 		}
 
-		const double fps		= cap.get(cv::CAP_PROP_FPS);
-		const int	 divisor	= 11 - sampling_rate;
-		const int	 target_fps = std::max(1, static_cast<int>((fps > 0 ? fps : 30) / divisor));
-		const int	 target_h	= static_cast<int>(STEAM_SHOWCASE_WIDTH * (cap.get(cv::CAP_PROP_FRAME_HEIGHT) / cap.get(cv::CAP_PROP_FRAME_WIDTH)));
+		// 采样率换算为目标输出帧率，按展示时间戳重采样（可变帧率素材同样适用）
+		const double   fps		= decoder.frame_rate() > 0 ? decoder.frame_rate() : 30;
+		const int	   divisor	= 11 - sampling_rate;
+		const int	   target_h = static_cast<int>(STEAM_SHOWCASE_WIDTH * (static_cast<double>(decoder.height()) / decoder.width()));
+		FrameResampler resampler(fps / divisor, decoder.duration(), options.max_frames);
 
-		std::vector<EncoderState>		   encoders(SLICE_COUNT);
 		std::vector<std::filesystem::path> out_paths;
-
 		for (int i = 0; i < SLICE_COUNT; ++i)
 		{
-			auto p = output_dir / std::format("slice_{}.gif", i + 1);
-			out_paths.push_back(p);
-			if (!init_encoder(encoders[i], p.string(), SLICE_WIDTH, target_h, target_fps, quality_mode))
+			out_paths.push_back(output_dir / std::format("slice_{}.gif", i + 1));
+		}
+
+		// 切片全部写出后应用 Hex Hack 并报告结果
+		auto report_finished = [&](const int merged, const std::string_view note)
+		{
+			for (const auto &p: out_paths)
 			{
-				for (int j = 0; j <= i; ++j)
+				apply_steam_hex_hack(p);
+			}
+			log_init(std::format("[Dedup] merged {} duplicate slice frames", merged));
+			if (on_update)
+			{
+				const std::string suffix = merged > 0 ? std::vformat(text::LOG_MERGED, std::make_format_args(merged)) : std::string();
+				on_update(std::format("{}{}{}{}", text::LOG_FINISHED, output_dir.string(), suffix, note));
+			}
+		};
+
+		// 帧缓存：键涵盖源文件及全部影响解码、缩放结果的参数，其余参数（调色板、抖动、有损程度等）变化时可直接复用
+		const int			sws_flags = SliceScaler::select_sws_flags(quality_mode);
+		const FrameCacheKey cache_key = FrameCacheKey::of(source_path, target_h, sws_flags, fps / divisor, options.max_frames);
+		log_init(std::format("[Init] Video encoder - SWS flags: {}", sws_flags_name(cache_key.sws_flags)));
+		// 使用期间缓存从处理器中取出，同时进行的其他任务看到的是未命中
+		auto	   cached	 = options.frame_cache ? take_cached(cache_key) : nullptr;
+		const bool cache_hit = cached != nullptr;
+
+		// 体积上限模式与缓存命中：在缓存帧上直接量化、编码，输出由内存一次写出
+		if (options.target_bytes > 0 || (cache_hit && options.encoder == EncoderBackend::Native))
+		{
+			auto store = std::move(cached);
+			if (store)
+			{
+				log_init(std::format("[Cache] reusing {} cached frames", store->size()));
+				counters.frames += store->size();
+			}
+			else
+			{
+				store			  = std::make_unique<FrameStore>();
+				store->key		  = cache_key;
+				store->frame_rate = fps / divisor;
+				store->duration	  = decoder.duration();
+				store->height	  = target_h;
+				if (!fill_store(st, pool, decoder, resampler, *store, options, on_update, counters))
 				{
-					finish_encoder(encoders[j]);
+					return false;
 				}
-				is_processing_.store(false);
-				return;
 			}
+
+			int	 merged = 0;
+			bool fits	= true;
+			bool written;
+			if (options.target_bytes > 0)
+			{
+				written = run_rate_control(st, pool, *store, out_paths, options, on_update, merged, fits);
+			}
+			else
+			{
+				const RatePlan plan{1, options.palette_colors, quality_mode == QUALITY_LOSSY ? options.lossy_error : 0};
+				written = write_slices(encode_store(st, *store, plan, options, pool, 0, store->size(), merged), out_paths) && !st.stop_requested();
+			}
+			if (written)
+			{
+				report_finished(merged, fits ? std::string_view() : text::LOG_RATE_OVER);
+			}
+			else if (!st.stop_requested() && on_update)
+			{
+				on_update(std::format("{}{}", text::ERR_WRITE_FAILED, output_dir.string()));
+			}
+			if (options.frame_cache)
+			{
+				put_cached(std::move(store));
+			}
+			return written;
+		}
+
+		// 缓存命中但需要 libavcodec 后端逐帧编码：缓存原样放回，本次仍走解码流水线
+		if (cached)
+		{
+			put_cached(std::move(cached));
 		}
 
-		cv::Mat frame, resized;
-		int		frame_idx = 0, processed_cnt = 0;
-		int		inter_flag = (quality_mode >= 2) ? cv::INTER_AREA : cv::INTER_LINEAR;
+		// 自研后端：各帧的 LZW 压缩同样交给共享调度器
+		ThreadPool *const lzw_pool = options.encoder == EncoderBackend::Native ? &pool : nullptr;
+
+		// 编码状态取自预热池：同尺寸、同缩放算法的上一个任务留下的缩放上下文与缓冲区直接复用
+		const EncoderPool::Key	  encoder_key{SLICE_WIDTH, target_h, cache_key.sws_flags};
+		std::vector<EncoderState> encoders = encoder_pool_.acquire(encoder_key, SLICE_COUNT);
+
+		// 帧间增量需要在调色板中预留一个透明色
+		const int palette_colors = options.delta_frames ? std::min(options.palette_colors, 255) : options.palette_colors;
 
-		while (cap.read(frame))
+		// 全局调色板：正式处理前抽样生成一次，之后所有帧、所有切片共用
+		// 抽样在打开输出文件之前进行，输入无法回到起点时不留下空的输出文件
+		Quantizer quantizer;
+		quantizer.set_dither(options.dither);
+		if (options.palette_mode == PaletteMode::Global)
 		{
-			if (st.stop_requested())
+			for (auto &e: encoders)
 			{
-				break;
+				e.sws_flags = cache_key.sws_flags; // 抽样缩放沿用编码状态的缩放上下文
 			}
-			if (frame.empty() || frame_idx++ % divisor != 0)
+			if (auto palette = build_global_palette(decoder, encoders, target_h, palette_colors))
 			{
-				continue;
+				quantizer.set_palette(*palette);
+			}
+			// 不可定位的输入无法回到起点时重新打开
+			if (!decoder.rewind() && !decoder.open(source_path, options.decoder))
+			{
+				log_init("[Init] ERROR: cannot reopen the input after palette sampling");
+				encoder_pool_.release(encoder_key, std::move(encoders));
+				if (on_update)
+				{
+					on_update(text::ERR_OPEN_FAILED);
+				}
+				return false;
 			}
+		}
+		const PaletteMode palette_mode = quantizer.palette().size > 0 ? options.palette_mode : PaletteMode::PerFrame;
 
-			cv::resize(frame, resized, cv::Size(STEAM_SHOWCASE_WIDTH, target_h), 0, 0, inter_flag);
-			for (int i = 0; i < SLICE_COUNT; ++i)
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			if (!init_encoder(encoders[i], out_paths[i].string(), SLICE_WIDTH, target_h, options, lzw_pool))
+			{
+				for (int j = 0; j <= i; ++j)
+				{
+					finish_encoder(encoders[j]);
+				}
+				encoder_pool_.release(encoder_key, std::move(encoders));
+				return false;
+			}
+		}
+
+		// 缓存未命中：流水线在缩放阶段顺带把缩放结果复制进新的帧缓存（仅自研后端可复用）
+		std::unique_ptr<FrameStore> fill;
+		if (options.frame_cache && options.encoder == EncoderBackend::Native)
+		{
+			fill			 = std::make_unique<FrameStore>();
+			fill->key		 = cache_key;
+			fill->frame_rate = fps / divisor;
+			fill->duration	 = decoder.duration();
+			fill->height	 = target_h;
+			fill->reset(options.max_frames);
+		}
+
+		// 流水线：解码 -> 切片缩放（裁剪+缩放+转 BGRA 一次完成） -> 调色板量化 -> 编码/封装（每切片一个 Strand）
+		// 解码在当前线程执行，其余阶段都作为任务交给共享调度器，与同时进行的其他任务一起由空闲线程窃取执行，
+		// 任务本身不另开线程。各帧的缩放并行执行，每个帧槽使用自己的缩放上下文；量化与编码由 EncodeStage 按解码顺序逐帧执行，
+		// 帧槽随 stage 在写尾之前释放
+		int	 processed_cnt = 0;
+		int	 merged_frames = 0;
+		bool scale_failed  = false;
+		{
+			EncodeStage stage(pool,
+							  encoders,
+							  target_h,
+							  options,
+							  quantizer,
+							  palette_mode,
+							  palette_colors,
+							  st,
+							  [&fill](const EncodeStage::FrameSlot &s)
+							  {
+								  if (fill && !fill->append_copy(s.pts, s.scaled))
+								  {
+									  fill.reset(); // 缓存写入失败（如临时目录空间不足）只放弃缓存，不影响本次输出
+								  }
+							  });
+
+			// 未被重采样器选中的帧由解码器尽量跳过解码
+			decoder.set_frame_selector(&resampler);
+
+			// 帧槽在全部切片编码完成后归还，空闲帧槽耗尽时解码阻塞，在途帧数不超过 EncodeStage::FRAME_SLOT_COUNT
+			std::array<char, 128> progress;
+			while (stage.ready() && !stage.failed() && !st.stop_requested())
 			{
-				if (int x = i * (SLICE_WIDTH + GAP_WIDTH); x + SLICE_WIDTH <= resized.cols)
+				EncodeStage::FrameSlot *slot = stage.acquire();
+				if (!slot || st.stop_requested())
 				{
-					push_frame(encoders[i], resized(cv::Rect(x, 0, SLICE_WIDTH, target_h)).clone(), target_h);
+					break;
+				}
+
+				EncodeStage::FrameSlot &s = *slot;
+				if (!decoder.decode_next(s.frame))
+				{
+					break;
 				}
+				s.pts = resampler.last_timestamp();
+				stage.scale(s);
+				stage.submit(s);
+
+				++counters.frames;
+				if (++processed_cnt % 10 == 0 && on_update)
+					on_update(format_progress(progress, processed_cnt));
 			}
-			if (++processed_cnt % 10 == 0 && on_update)
-				on_update(std::format("{}{}", text::LOG_ENCODING, processed_cnt));
+
+			// 各切片因重复而未编码的帧数之和
+			stage.wait_idle();
+			merged_frames = stage.merged_frames();
+			scale_failed  = stage.failed();
 		}
 
+		// 末尾的重复帧同样并入最后一次输出的帧
+		bool written = true;
 		for (auto &e: encoders)
 		{
-			finish_encoder(e);
+			const int64_t tail = e.last_pts >= 0 ? resampler.last_timestamp() - e.last_pts : 0;
+			e.final_delay	   = resampler.final_delay() + static_cast<int>(tail);
+			written			   = finish_encoder(e) && written;
+		}
+		encoder_pool_.release(encoder_key, std::move(encoders));
+		if (scale_failed && !st.stop_requested())
+		{
+			// 缩放失败之后的帧均未编码，已写出的切片不完整
+			log_init("[Scale] ERROR: scaling a slice failed");
+			if (on_update)
+			{
+				on_update(text::ERR_SCALE_FAILED);
+			}
+			return false;
+		}
+		if (!written && !st.stop_requested())
+		{
+			// 切片文件被截断时不做 Hex Hack，也不报告完成
+			log_init("[Encode] ERROR: writing a slice file failed");
+			if (on_update)
+			{
+				on_update(std::format("{}{}", text::ERR_WRITE_FAILED, output_dir.string()));
+			}
+			return false;
 		}
 		if (!st.stop_requested() && processed_cnt > 0)
 		{
-			for (const auto &p: out_paths)
+			report_finished(merged_frames, {});
+			if (fill && fill->size() > 0)
 			{
-				apply_steam_hex_hack(p);
+				fill->sample_histogram();
+				put_cached(std::move(fill));
 			}
+		}
+		else if (!st.stop_requested())
+		{
+			log_init("[Decode] ERROR: no frames were decoded");
 			if (on_update)
 			{
-				on_update(std::format("{}{}", text::LOG_FINISHED, output_dir.string()));
+				on_update(text::ERR_NO_FRAMES);
 			}
 		}
-		is_processing_.store(false);
+		return !st.stop_requested() && processed_cnt > 0;
+	}
+
+	ShowcaseProcessor::ShowcaseProcessor() : impl_(std::make_unique<Impl>())
+	{
+	}
+
+	ShowcaseProcessor::~ShowcaseProcessor() = default;
+
+	JobHandle ShowcaseProcessor::submit(const std::filesystem::path &source_path,
+										const std::filesystem::path &output_dir,
+										const TaskOptions			&options,
+										const UpdateCallback		&on_update)
+	{
+		return impl_->submit(source_path, output_dir, options, on_update);
+	}
+
+	JobHandle ShowcaseProcessor::submit_batch(const std::vector<std::filesystem::path> &sources,
+											  const std::filesystem::path			   &output_dir,
+											  const TaskOptions						   &options,
+											  const UpdateCallback					   &on_update,
+											  const unsigned							thread_budget)
+	{
+		return impl_->submit_batch(sources, output_dir, options, on_update, thread_budget);
+	}
+
+	void ShowcaseProcessor::start_task(const std::filesystem::path &source_path,
+									   const std::filesystem::path &output_dir,
+									   const TaskOptions		   &options,
+									   const UpdateCallback		   &on_update)
+	{
+		impl_->start_task(source_path, output_dir, options, on_update);
+	}
+
+	void ShowcaseProcessor::start_batch(const std::vector<std::filesystem::path> &sources,
+										const std::filesystem::path				 &output_dir,
+										const TaskOptions						 &options,
+										const UpdateCallback					 &on_update,
+										const unsigned							  thread_budget)
+	{
+		impl_->start_batch(sources, output_dir, options, on_update, thread_budget);
+	}
+
+	void ShowcaseProcessor::stop_task()
+	{
+		impl_->stop_task();
+	}
+
+	bool ShowcaseProcessor::is_active() const
+	{
+		return impl_->active_jobs_.load() > 0;
+	}
+
+	std::optional<ShowcaseProcessor::SizeEstimate>
+	ShowcaseProcessor::estimate_size(const std::stop_token &st, const std::filesystem::path &source_path, const TaskOptions &options)
+	{
+		return impl_->estimate_size(st, source_path, options);
+	}
+
+	void ShowcaseProcessor::request_estimate(const std::filesystem::path &source_path, const TaskOptions &options, const EstimateCallback &on_done)
+	{
+		impl_->request_estimate(source_path, options, on_done);
+	}
+
+	void ShowcaseProcessor::cancel_estimate(const bool wait)
+	{
+		impl_->cancel_estimate(wait);
 	}
 } // namespace SteamShowcaseGen
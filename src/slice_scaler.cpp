@@ -0,0 +1,122 @@
+#include "slice_scaler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace SteamShowcaseGen::SliceScaler
+{
+	int select_sws_flags(const int quality_mode)
+	{
+		switch (quality_mode)
+		{
+			case 0:
+				return SWS_POINT;
+			case 1:
+				return SWS_BILINEAR;
+			case 3:
+				return SWS_LANCZOS;
+			case QUALITY_LOSSY:
+			case 2:
+			default:
+				return SWS_BICUBIC;
+		}
+	}
+
+	AVFrame *alloc_frame(const int width, const int height, const int format)
+	{
+		AVFrame *frame = av_frame_alloc();
+		if (!frame)
+		{
+			return nullptr;
+		}
+		frame->format = format;
+		frame->width  = width;
+		frame->height = height;
+		if (av_frame_get_buffer(frame, 32) < 0)
+		{
+			av_frame_free(&frame);
+			return nullptr;
+		}
+		return frame;
+	}
+
+	SliceView map_source(const AVFrame &frame, const int index)
+	{
+		const auto *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame.format));
+		if (!desc || (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) || !frame.data[0])
+		{
+			return {};
+		}
+
+		// 将展柜坐标系中的切片区间映射回原始帧，间隙部分不参与缩放
+		// 左边界对齐到色度采样粒度，保证各平面的偏移落在完整像素上
+		const double scale	   = static_cast<double>(frame.width) / SHOWCASE_WIDTH;
+		const int	 alignment = 1 << desc->log2_chroma_w;
+		const int	 left	   = static_cast<int>(std::lround(index * (SLICE_WIDTH + GAP_WIDTH) * scale)) / alignment * alignment;
+		const int	 right	   = std::min(frame.width, static_cast<int>(std::lround((index * (SLICE_WIDTH + GAP_WIDTH) + SLICE_WIDTH) * scale)));
+
+		if (right <= left)
+		{
+			return {};
+		}
+
+		int max_step[4];
+		av_image_fill_max_pixsteps(max_step, nullptr, desc);
+
+		SliceView view;
+		for (int p = 0; p < 4 && frame.data[p]; ++p)
+		{
+			// 调色板格式的第二个平面是调色板本身，不做偏移
+			const bool is_palette = (desc->flags & AV_PIX_FMT_FLAG_PAL) && p == 1;
+			const int  shift_x	  = (p == 1 || p == 2) ? desc->log2_chroma_w : 0;
+			view.data[p]		  = frame.data[p] + (is_palette ? 0 : static_cast<std::ptrdiff_t>(left >> shift_x) * max_step[p]);
+			view.stride[p]		  = frame.linesize[p];
+		}
+		view.width	= right - left;
+		view.height = frame.height;
+		view.format = frame.format;
+		return view;
+	}
+
+	bool scale(SwsContext *&context, const int sws_flags, const SliceView &src, AVFrame *dst)
+	{
+		if (!dst || src.empty())
+		{
+			return false;
+		}
+
+		// 一次 sws_scale 同时完成裁剪、缩放与解码格式 -> BGRA 转换
+		context = sws_getCachedContext(context,
+									   src.width,
+									   src.height,
+									   static_cast<AVPixelFormat>(src.format),
+									   dst->width,
+									   dst->height,
+									   static_cast<AVPixelFormat>(dst->format),
+									   sws_flags,
+									   nullptr,
+									   nullptr,
+									   nullptr);
+		if (!context)
+		{
+			return false;
+		}
+
+		// 编码器可能仍持有上一轮的帧引用，写入前确保缓冲区独占
+		if (av_frame_make_writable(dst) < 0)
+		{
+			return false;
+		}
+
+		sws_scale(context, src.data.data(), src.stride.data(), 0, src.height, dst->data, dst->linesize);
+		return true;
+	}
+} // namespace SteamShowcaseGen::SliceScaler
@@ -0,0 +1,209 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace SteamShowcaseGen
+{
+	thread_local ThreadPool *ThreadPool::current_pool_	= nullptr;
+	thread_local std::size_t ThreadPool::current_index_ = 0;
+
+	TaskQueue::TaskQueue()
+	{
+		tasks_.resize(INITIAL_CAPACITY);
+	}
+
+	void TaskQueue::push_back(Task task)
+	{
+		if (count_ == tasks_.size())
+		{
+			grow();
+		}
+		tasks_[(head_ + count_) % tasks_.size()] = std::move(task);
+		++count_;
+	}
+
+	Task TaskQueue::pop_front()
+	{
+		Task task = std::move(tasks_[head_]);
+		head_	  = (head_ + 1) % tasks_.size();
+		--count_;
+		return task;
+	}
+
+	Task TaskQueue::pop_back()
+	{
+		--count_;
+		return std::move(tasks_[(head_ + count_) % tasks_.size()]);
+	}
+
+	// 容量翻倍，积压的任务按先后顺序移到新缓冲区的开头
+	void TaskQueue::grow()
+	{
+		std::vector<Task> larger(tasks_.size() * 2);
+		for (std::size_t i = 0; i < count_; ++i)
+		{
+			larger[i] = std::move(tasks_[(head_ + i) % tasks_.size()]);
+		}
+		tasks_ = std::move(larger);
+		head_  = 0;
+	}
+
+	ThreadPool::ThreadPool(const unsigned threads)
+	{
+		const unsigned count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+		locals_.reserve(count);
+		for (unsigned i = 0; i < count; ++i)
+		{
+			locals_.push_back(std::make_unique<LocalQueue>());
+		}
+		workers_.reserve(count);
+		for (unsigned i = 0; i < count; ++i)
+		{
+			workers_.emplace_back([this, i] { worker_loop(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(sleep_mutex_);
+			stopping_ = true;
+		}
+		sleep_cv_.notify_all();
+	}
+
+	void ThreadPool::post(Task task)
+	{
+		if (current_pool_ == this)
+		{
+			LocalQueue		&local = *locals_[current_index_];
+			std::lock_guard lock(local.mutex);
+			local.tasks.push_back(std::move(task));
+		}
+		else
+		{
+			std::lock_guard lock(global_mutex_);
+			global_.push_back(std::move(task));
+		}
+
+		// 计数在入队之后增加，休眠的线程在 sleep_mutex_ 下检查计数，经过该锁再通知不会丢失唤醒
+		queued_.fetch_add(1, std::memory_order_release);
+		{
+			std::lock_guard lock(sleep_mutex_);
+		}
+		sleep_cv_.notify_one();
+	}
+
+	bool ThreadPool::run_pending()
+	{
+		if (current_pool_ != this)
+		{
+			return false;
+		}
+		Task task = take(current_index_);
+		if (!task)
+		{
+			return false;
+		}
+		task();
+		return true;
+	}
+
+	Task ThreadPool::take(const std::size_t self)
+	{
+		Task task;
+		{
+			LocalQueue		&local = *locals_[self];
+			std::lock_guard lock(local.mutex);
+			if (!local.tasks.empty())
+			{
+				task = local.tasks.pop_back();
+			}
+		}
+		if (!task)
+		{
+			std::lock_guard lock(global_mutex_);
+			if (!global_.empty())
+			{
+				task = global_.pop_front();
+			}
+		}
+		for (std::size_t i = 1; !task && i < locals_.size(); ++i)
+		{
+			LocalQueue		&victim = *locals_[(self + i) % locals_.size()];
+			std::lock_guard lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = victim.tasks.pop_front();
+			}
+		}
+		if (task)
+		{
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+		}
+		return task;
+	}
+
+	void ThreadPool::worker_loop(const std::size_t index)
+	{
+		current_pool_  = this;
+		current_index_ = index;
+		while (true)
+		{
+			if (Task task = take(index))
+			{
+				task();
+				continue;
+			}
+
+			std::unique_lock lock(sleep_mutex_);
+			sleep_cv_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+			if (stopping_ && queued_.load(std::memory_order_acquire) == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	void Strand::post(Task task)
+	{
+		bool schedule = false;
+		{
+			std::lock_guard lock(mutex_);
+			tasks_.push_back(std::move(task));
+			if (!running_)
+			{
+				running_ = true;
+				schedule = true;
+			}
+		}
+		if (schedule)
+		{
+			pool_.post([this] { run(); });
+		}
+	}
+
+	void Strand::wait_idle()
+	{
+		std::unique_lock lock(mutex_);
+		idle_cv_.wait(lock, [this] { return !running_; });
+	}
+
+	void Strand::run()
+	{
+		while (true)
+		{
+			Task task;
+			{
+				std::lock_guard lock(mutex_);
+				if (tasks_.empty())
+				{
+					running_ = false;
+					idle_cv_.notify_all();
+					return;
+				}
+				task = tasks_.pop_front();
+			}
+			task();
+		}
+	}
+} // namespace SteamShowcaseGen
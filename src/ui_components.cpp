@@ -2,10 +2,12 @@
 #include <algorithm>
 #include <filesystem>
 #include <format>
+#include <memory>
 #include <ranges>
 #include "app_text.hpp"
 #include "ftxui/dom/elements.hpp"
 #include "platform_utils.h"
+#include "ssg_core.h"
 
 namespace SteamShowcaseGen::Ui
 {
@@ -14,17 +16,20 @@ namespace SteamShowcaseGen::Ui
 	namespace fs  = std::filesystem;
 
 	// --- 内部辅助函数声明 ---
-	static Component MakeHomeTab(AppState &state);
+	static Component MakeHomeTab(AppState &state, const std::function<void()> &on_config_change);
 	static Component MakeAboutTab();
 	static Component MakeStartButton(const std::function<void()> &on_start, const std::function<bool()> &is_busy);
 	static Element	 RenderHeader(const Component &tab_toggle);
 	static Element	 RenderStatusBar(const AppState &state, bool is_busy, const Component &btn_start);
 
 	// --- 核心入口 ---
-	Component BuildMainInterface(AppState &state, const std::function<void()> &on_start, const std::function<bool()> &is_busy)
+	Component BuildMainInterface(AppState						  &state,
+								 const std::function<void()> &on_start,
+								 const std::function<bool()> &is_busy,
+								 const std::function<void()> &on_config_change)
 	{
 		// 1. 构建各子页面
-		auto home_page	= MakeHomeTab(state);
+		auto home_page	= MakeHomeTab(state, on_config_change);
 		auto about_page = MakeAboutTab();
 		auto btn_start	= MakeStartButton(on_start, is_busy);
 
@@ -87,51 +92,45 @@ namespace SteamShowcaseGen::Ui
 
 	// --- 内部实现细节 ---
 
-	static Component MakeHomeTab(AppState &state)
+	static Component MakeHomeTab(AppState &state, const std::function<void()> &on_config_change)
 	{
 		// 扫描动作
 		auto scan_action = [&state]
 		{
 			state.file_list.clear();
 			state.selected_file_idx = 0;
-			state.current_log		= std::string(txt::LOG_SCANNING);
+			state.set_log(txt::LOG_SCANNING);
 			try
 			{
 				if (const fs::path dir_path(state.src_dir); fs::exists(dir_path) && fs::is_directory(dir_path))
 				{
-					static constexpr std::array supported = {".mp4", ".avi", ".mov", ".mkv", ".png", ".jpg", ".jpeg", ".bmp", ".webp", ".tif", ".tiff"};
 					for (const auto &entry: fs::directory_iterator(dir_path))
 					{
-						if (entry.is_regular_file())
+						if (entry.is_regular_file() && ShowcaseProcessor::is_supported(entry.path()))
 						{
-							std::string ext = entry.path().extension().string();
-							std::ranges::transform(ext, ext.begin(), ::tolower);
-							if (std::ranges::any_of(supported, [&](auto s) { return s == ext; }))
-							{
-								state.file_list.push_back(entry.path().filename().string());
-							}
+							state.file_list.push_back(entry.path().filename().string());
 						}
 					}
 					if (state.file_list.empty())
 					{
 						state.file_list.emplace_back(txt::TAG_NO_FILE);
-						state.current_log = std::string(txt::ERR_NO_FILE);
+						state.set_log(txt::ERR_NO_FILE);
 					}
 					else
 					{
 						const size_t count = state.file_list.size();
-						state.current_log  = std::vformat(txt::LOG_SCAN_DONE, std::make_format_args(count));
+						state.set_log(std::vformat(txt::LOG_SCAN_DONE, std::make_format_args(count)));
 					}
 				}
 				else
 				{
 					state.file_list.emplace_back(txt::TAG_INVALID_DIR);
-					state.current_log = std::string(txt::ERR_DIR_INVALID);
+					state.set_log(txt::ERR_DIR_INVALID);
 				}
 			}
 			catch (const std::exception &e)
 			{
-				state.current_log = e.what();
+				state.set_log(e.what());
 			}
 		};
 
@@ -144,17 +143,26 @@ namespace SteamShowcaseGen::Ui
 		auto btn_open_src = Button(std::string(txt::BTN_OPEN), [&] { Platform::OpenDirectory(state.src_dir); }, ButtonOption::Ascii());
 
 		auto menu_file	  = Menu(&state.file_list, &state.selected_file_idx);
+		auto check_batch  = Checkbox(std::string(txt::BATCH_ALL), &state.batch_mode);
 		auto input_out	  = Input(&state.out_dir, std::string(txt::PLACEHOLDER_OUT), input_opt);
 		auto btn_open_out = Button(std::string(txt::BTN_OPEN), [&] { Platform::OpenDirectory(state.out_dir); }, ButtonOption::Ascii());
 
-		auto slider_samp = Slider("", &state.sampling_rate, 1, 10, 1);
+		auto slider_samp  = Slider("", &state.sampling_rate, 1, 10, 1);
+		auto input_target = Input(&state.target_kb, std::string(txt::PLACEHOLDER_TARGET), input_opt);
 
-		static std::vector q_labels = {
-			std::string(txt::QUALITY_FAST), std::string(txt::QUALITY_MEDIUM), std::string(txt::QUALITY_HIGH), std::string(txt::QUALITY_BEST)};
+		static std::vector q_labels = {std::string(txt::QUALITY_FAST),
+									   std::string(txt::QUALITY_MEDIUM),
+									   std::string(txt::QUALITY_HIGH),
+									   std::string(txt::QUALITY_BEST),
+									   std::string(txt::QUALITY_LOSSY)};
 		MenuOption quality_opt;
 		quality_opt.entries_option.transform = [](const EntryState &s)
 		{
-			const Color c	   = (s.index == 0) ? Color::RedLight : (s.index == 1) ? Color::Yellow : (s.index == 2) ? Color::Green : Color::Blue;
+			const Color c	   = (s.index == 0)	  ? Color::RedLight
+								 : (s.index == 1) ? Color::Yellow
+								 : (s.index == 2) ? Color::Green
+								 : (s.index == 3) ? Color::Blue
+												  : Color::Magenta;
 			auto		prefix = text(s.active ? "◉ " : "○ ") | color(Color::GrayLight);
 			auto		label  = text(s.label) | color(c);
 			if (s.active)
@@ -170,11 +178,34 @@ namespace SteamShowcaseGen::Ui
 		};
 		auto menu_quality = Menu(&q_labels, &state.quality_idx, quality_opt);
 
+		static std::vector d_labels = {
+			std::string(txt::DITHER_NONE), std::string(txt::DITHER_BAYER), std::string(txt::DITHER_DIFFUSION), std::string(txt::DITHER_BLUE_NOISE)};
+		MenuOption dither_opt;
+		dither_opt.entries_option.transform = [](const EntryState &s)
+		{
+			auto prefix = text(s.active ? "◉ " : "○ ") | color(Color::GrayLight);
+			auto label	= text(s.label);
+			if (s.active)
+			{
+				label |= bold;
+			}
+			auto res = hbox({prefix, label});
+			if (s.focused)
+			{
+				res |= inverted;
+			}
+			return res;
+		};
+		auto menu_dither = Menu(&d_labels, &state.dither_idx, dither_opt);
+
 		// 布局容器
-		auto	   left_col	 = Container::Vertical({input_src, btn_scan, btn_open_src, menu_file});
-		auto	   right_col = Container::Vertical({input_out, btn_open_out, slider_samp, menu_quality});
+		auto	   left_col	 = Container::Vertical({input_src, btn_scan, btn_open_src, menu_file, check_batch});
+		auto	   right_col = Container::Vertical({input_out, btn_open_out, slider_samp, input_target, menu_quality, menu_dither});
 		const auto container = Container::Horizontal({left_col, right_col});
 
+		// 影响输出体积的配置变化时通知调用方重新预估
+		auto last_config = std::make_shared<std::string>();
+
 		// 渲染逻辑
 		return Renderer(container,
 						[=, &state]
@@ -183,6 +214,18 @@ namespace SteamShowcaseGen::Ui
 							int				  div		  = 11 - state.sampling_rate;
 							const std::string display_str = (state.sampling_rate == 10) ? "N/A" : std::format("1/{}", div);
 
+							const std::string file	 = state.file_list.empty() ? std::string() : state.file_list[state.selected_file_idx];
+							std::string		  config =
+								std::format("{}|{}|{}|{}|{}", state.src_dir, file, state.sampling_rate, state.quality_idx, state.dither_idx);
+							if (config != *last_config)
+							{
+								*last_config = std::move(config);
+								if (on_config_change)
+								{
+									on_config_change();
+								}
+							}
+
 							auto resource_view = vbox({hbox({text(std::string(txt::LABEL_DIR_SRC)) | vcenter | size(WIDTH, EQUAL, STD_W),
 															 separator(),
 															 input_src->Render() | size(WIDTH, EQUAL, 24),
@@ -196,7 +239,12 @@ namespace SteamShowcaseGen::Ui
 													   vbox({text(std::string(txt::LABEL_FILE_LIST)) | bold,
 															 separator(),
 															 hbox({text(" "), menu_file->Render() | vscroll_indicator | frame | size(WIDTH, EQUAL, 50)})})
-														   | flex})
+														   | flex,
+													   separator(),
+													   hbox({text(std::string(txt::LABEL_BATCH)) | vcenter | size(WIDTH, EQUAL, STD_W),
+															 separator(),
+															 check_batch->Render() | flex})
+														   | size(HEIGHT, EQUAL, 1)})
 								| border | flex;
 
 							auto config_view = vbox({hbox({text(std::string(txt::LABEL_DIR_OUT)) | vcenter | size(WIDTH, EQUAL, STD_W),
@@ -212,12 +260,23 @@ namespace SteamShowcaseGen::Ui
 														   separator(),
 														   slider_samp->Render() | flex,
 														   separator(),
-														   text(display_str) | dim | center | size(WIDTH, EQUAL, STD_W)})
+														   text(display_str) | dim | center | size(WIDTH, EQUAL, STD_W),
+														   separator(),
+														   text(state.size_estimate) | dim | center | size(WIDTH, EQUAL, 2 * STD_W)})
+														 | size(HEIGHT, EQUAL, 1),
+													 separator(),
+													 hbox({text(std::string(txt::LABEL_TARGET)) | vcenter | size(WIDTH, EQUAL, STD_W),
+														   separator(),
+														   input_target->Render() | flex})
 														 | size(HEIGHT, EQUAL, 1),
 													 separator(),
 													 text(std::string(txt::LABEL_QUALITY)) | bold,
 													 separator(),
-													 hbox({text(" "), menu_quality->Render() | flex}) | flex})
+													 hbox({text(" "), menu_quality->Render() | flex}) | flex,
+													 separator(),
+													 text(std::string(txt::LABEL_DITHER)) | bold,
+													 separator(),
+													 hbox({text(" "), menu_dither->Render() | flex}) | flex})
 								| border | flex;
 
 							return hbox({resource_view, text(" "), config_view});
@@ -325,6 +384,9 @@ namespace SteamShowcaseGen::Ui
 
 	static Element RenderStatusBar(const AppState &state, const bool is_busy, const Component &btn_start)
 	{
+		// 处理线程可能正在写入 current_log
+		std::lock_guard lock(state.log_mutex);
+
 		Element spinner_elem;
 		if (is_busy)
 		{
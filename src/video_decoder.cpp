@@ -0,0 +1,265 @@
+#include "video_decoder.h"
+#include <cerrno>
+#include <utility>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace SteamShowcaseGen
+{
+	VideoDecoder::~VideoDecoder()
+	{
+		close();
+	}
+
+	bool VideoDecoder::open(const std::filesystem::path &path, const DecoderOptions &options)
+	{
+		close();
+
+		if (avformat_open_input(&fmt_ctx_, path.string().c_str(), nullptr, nullptr) < 0)
+		{
+			return false;
+		}
+		if (avformat_find_stream_info(fmt_ctx_, nullptr) < 0)
+		{
+			close();
+			return false;
+		}
+
+		const AVCodec *codec = nullptr;
+		stream_index_		 = av_find_best_stream(fmt_ctx_, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+		if (stream_index_ < 0 || !codec)
+		{
+			close();
+			return false;
+		}
+
+		// 其余流（音频、字幕等）在解复用层直接丢弃
+		for (unsigned i = 0; i < fmt_ctx_->nb_streams; ++i)
+		{
+			if (static_cast<int>(i) != stream_index_)
+			{
+				fmt_ctx_->streams[i]->discard = AVDISCARD_ALL;
+			}
+		}
+
+		AVStream *stream = fmt_ctx_->streams[stream_index_];
+		codec_ctx_		 = avcodec_alloc_context3(codec);
+		if (!codec_ctx_ || avcodec_parameters_to_context(codec_ctx_, stream->codecpar) < 0)
+		{
+			close();
+			return false;
+		}
+
+		codec_ctx_->pkt_timebase = stream->time_base;
+		codec_ctx_->thread_count = options.thread_count;
+		codec_ctx_->thread_type	 = static_cast<int>(options.thread_type);
+
+		if (avcodec_open2(codec_ctx_, codec, nullptr) < 0)
+		{
+			close();
+			return false;
+		}
+
+		packet_ = av_packet_alloc();
+		if (!packet_)
+		{
+			close();
+			return false;
+		}
+
+		const AVRational rate = av_guess_frame_rate(fmt_ctx_, stream, nullptr);
+		frame_rate_			  = (rate.num > 0 && rate.den > 0) ? av_q2d(rate) : 0.0;
+		time_base_			  = av_q2d(stream->time_base);
+		start_pts_			  = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+		if (stream->duration != AV_NOPTS_VALUE && stream->duration > 0)
+		{
+			duration_ = static_cast<double>(stream->duration) * time_base_;
+		}
+		else if (fmt_ctx_->duration != AV_NOPTS_VALUE && fmt_ctx_->duration > 0)
+		{
+			duration_ = static_cast<double>(fmt_ctx_->duration) / AV_TIME_BASE;
+		}
+		output_count_		  = 0;
+		draining_			  = false;
+		return true;
+	}
+
+	void VideoDecoder::close()
+	{
+		if (packet_)
+		{
+			av_packet_free(&packet_);
+		}
+		if (codec_ctx_)
+		{
+			avcodec_free_context(&codec_ctx_);
+		}
+		if (fmt_ctx_)
+		{
+			avformat_close_input(&fmt_ctx_);
+		}
+		stream_index_ = -1;
+		frame_rate_	  = 0.0;
+		duration_	  = 0.0;
+		time_base_	  = 0.0;
+		start_pts_	  = 0;
+		output_count_ = 0;
+		draining_	  = false;
+	}
+
+	void VideoDecoder::set_frame_selector(FrameSelector *selector)
+	{
+		selector_ = selector;
+	}
+
+	bool VideoDecoder::seek(const double t)
+	{
+		if (!codec_ctx_ || time_base_ <= 0)
+		{
+			return false;
+		}
+
+		const auto ts = start_pts_ + static_cast<int64_t>(t / time_base_);
+		if (av_seek_frame(fmt_ctx_, stream_index_, ts, AVSEEK_FLAG_BACKWARD) < 0)
+		{
+			return false;
+		}
+		avcodec_flush_buffers(codec_ctx_);
+		draining_ = false;
+		return true;
+	}
+
+	bool VideoDecoder::decode_at(const double t, AVFrame *dst, const std::stop_token &st)
+	{
+		if (!seek(t))
+		{
+			return false;
+		}
+
+		// 从 t 之前最近的关键帧开始解码，直到到达目标时间
+		FrameSelector *selector = std::exchange(selector_, nullptr);
+		bool		   found	= false;
+		while (!st.stop_requested() && decode_next(dst))
+		{
+			if (frame_time(*dst) >= t - 1e-3)
+			{
+				found = true;
+				break;
+			}
+		}
+		selector_ = selector;
+		return found;
+	}
+
+	bool VideoDecoder::rewind()
+	{
+		output_count_ = 0;
+		return seek(0.0);
+	}
+
+	double VideoDecoder::frame_time(const AVFrame &frame) const
+	{
+		if (frame.best_effort_timestamp != AV_NOPTS_VALUE)
+		{
+			return static_cast<double>(frame.best_effort_timestamp - start_pts_) * time_base_;
+		}
+		return frame_rate_ > 0 ? static_cast<double>(output_count_) / frame_rate_ : 0.0;
+	}
+
+	bool VideoDecoder::wants_packet(const AVPacket &packet) const
+	{
+		// 没有时间戳的包无法判断，按需要处理
+		if (!selector_ || packet.pts == AV_NOPTS_VALUE)
+		{
+			return true;
+		}
+		return selector_->wants(static_cast<double>(packet.pts - start_pts_) * time_base_);
+	}
+
+	bool VideoDecoder::decode_next(AVFrame *dst)
+	{
+		if (!codec_ctx_ || !dst)
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			// 1. 优先取出解码器中已就绪的帧（帧级多线程下会有若干帧积压）
+			const int ret = avcodec_receive_frame(codec_ctx_, dst);
+			if (ret == 0)
+			{
+				// 为了解码后续帧而必须解码的参考帧，在此直接丢弃，不交给调用方
+				const bool selected = !selector_ || selector_->accept(frame_time(*dst));
+				++output_count_;
+				if (selected)
+				{
+					return true;
+				}
+				av_frame_unref(dst);
+				continue;
+			}
+			if (ret != AVERROR(EAGAIN))
+			{
+				return false; // AVERROR_EOF 或解码错误
+			}
+
+			// 2. 解码器需要更多输入：读取下一个属于目标视频流的包
+			if (draining_)
+			{
+				return false;
+			}
+
+			int read_ret;
+			while ((read_ret = av_read_frame(fmt_ctx_, packet_)) >= 0 && packet_->stream_index != stream_index_)
+			{
+				av_packet_unref(packet_);
+			}
+
+			if (read_ret < 0)
+			{
+				// 文件结束：发送空包冲刷解码器，取出剩余帧
+				draining_ = true;
+				avcodec_send_packet(codec_ctx_, nullptr);
+				continue;
+			}
+
+			// 不需要的帧：可丢弃的包（不被其它帧参考）连解码都不做，其余包只跳过非参考帧
+			const bool wanted = wants_packet(*packet_);
+			if (!wanted && (packet_->flags & AV_PKT_FLAG_DISPOSABLE))
+			{
+				av_packet_unref(packet_);
+				continue;
+			}
+			codec_ctx_->skip_frame = wanted ? AVDISCARD_DEFAULT : AVDISCARD_NONREF;
+
+			// 单个损坏的包不应中止整个任务，忽略其错误继续解码
+			avcodec_send_packet(codec_ctx_, packet_);
+			av_packet_unref(packet_);
+		}
+	}
+
+	int VideoDecoder::width() const
+	{
+		return codec_ctx_ ? codec_ctx_->width : 0;
+	}
+
+	int VideoDecoder::height() const
+	{
+		return codec_ctx_ ? codec_ctx_->height : 0;
+	}
+
+	double VideoDecoder::frame_rate() const
+	{
+		return frame_rate_;
+	}
+
+	double VideoDecoder::duration() const
+	{
+		return duration_;
+	}
+} // namespace SteamShowcaseGen
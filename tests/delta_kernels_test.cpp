@@ -0,0 +1,316 @@
+/**
+ * @file delta_kernels_test.cpp
+ * @brief SIMD 帧间增量内核与标量参考实现的比对
+ *
+ * 只测试当前 CPU 支持的内核。随机行覆盖 1-67 像素的全部宽度（包含不是 8 的整数倍的剩余像素）与切片宽度，
+ * 变化像素的比例从全部不变到全部变化，调色板中有颜色重复的项（索引不同而显示颜色相同的像素不算变化）；
+ * 逐行比对改写后的索引、画布、返回的首个变化位置与 *last。
+ * 再以逐像素比较的参考实现核对 FrameDelta 在一串帧上求出的变化矩形与透明化后的索引。
+ * 任一结果不一致时输出首个差异并返回非 0。
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "cpu_features.h"
+#include "delta_kernels.h"
+#include "frame_delta.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		namespace dk = DeltaKernels;
+
+		constexpr uint8_t TRANSPARENT	= 255; // 与编码阶段一致，透明色不出现在输入索引中
+		constexpr int	  LAST_SENTINEL = -7;  // 整行无变化时 *last 应保持不变
+
+		struct KernelCase
+		{
+			std::string_view name;
+			dk::MarkRow		 mark_row;
+		};
+
+		std::vector<KernelCase> supported_kernels()
+		{
+			std::vector<KernelCase> kernels;
+#if SSG_ARCH_X86
+			if (cpu_features().avx2)
+			{
+				kernels.push_back({"avx2", dk::mark_row_avx2});
+			}
+#endif
+			return kernels;
+		}
+
+		// 前 64 项两两同色：索引 2k 与 2k+1 显示颜色相同
+		std::array<uint32_t, 256> random_palette(std::mt19937 &rng)
+		{
+			std::uniform_int_distribution<uint32_t> color(0, 0xFFFFFF);
+			std::array<uint32_t, 256>				palette{};
+			for (std::size_t i = 0; i < palette.size(); ++i)
+			{
+				palette[i] = i < 64 && i % 2 ? palette[i - 1] : 0xFF000000u | color(rng);
+			}
+			return palette;
+		}
+
+		/**
+		 * @brief 按上一帧画布生成一行索引：约 changed_percent% 的像素取随机索引，其余取与画布同色的索引
+		 *
+		 * 同色像素在重复项之间随机选择，内核须按显示颜色而非索引判断。
+		 */
+		std::vector<uint8_t> next_row(std::mt19937 &rng, const std::vector<uint8_t> &previous, const int changed_percent)
+		{
+			std::uniform_int_distribution<int> percent(0, 99);
+			std::uniform_int_distribution<int> index(0, TRANSPARENT - 1);
+			std::vector<uint8_t>			   row(previous.size());
+			for (std::size_t x = 0; x < row.size(); ++x)
+			{
+				if (percent(rng) < changed_percent)
+				{
+					row[x] = static_cast<uint8_t>(index(rng));
+				}
+				else
+				{
+					row[x] = previous[x] < 64 ? static_cast<uint8_t>((previous[x] & ~1) | (percent(rng) & 1)) : previous[x];
+				}
+			}
+			return row;
+		}
+
+		std::vector<uint32_t> colors_of(const std::vector<uint8_t> &indices, const std::array<uint32_t, 256> &palette)
+		{
+			std::vector<uint32_t> colors(indices.size());
+			std::transform(indices.begin(), indices.end(), colors.begin(), [&](const uint8_t i) { return palette[i]; });
+			return colors;
+		}
+
+		bool same_rect(const DeltaRect &a, const DeltaRect &b)
+		{
+			return a.empty() ? b.empty() : a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+		}
+
+		// 返回首个差异的位置，一致时返回 -1
+		template<typename T>
+		int first_mismatch(const std::vector<T> &expected, const std::vector<T> &actual)
+		{
+			for (std::size_t i = 0; i < expected.size(); ++i)
+			{
+				if (expected[i] != actual[i])
+				{
+					return static_cast<int>(i);
+				}
+			}
+			return -1;
+		}
+
+		/** @brief 直接调用各内核，与 mark_row_scalar 逐行比对 */
+		int check_rows(std::mt19937 &rng, const std::vector<KernelCase> &kernels)
+		{
+			const auto palette = random_palette(rng);
+
+			std::vector<int> widths;
+			for (int w = 1; w <= 67; ++w)
+			{
+				widths.push_back(w);
+			}
+			widths.insert(widths.end(), {150, 766});
+
+			std::uniform_int_distribution<int> index(0, TRANSPARENT - 1);
+			int								   failures = 0;
+			for (const int width: widths)
+			{
+				std::vector<uint8_t> previous(width);
+				std::generate(previous.begin(), previous.end(), [&] { return static_cast<uint8_t>(index(rng)); });
+				const std::vector<uint32_t> canvas = colors_of(previous, palette);
+
+				for (const int changed_percent: {0, 3, 50, 100})
+				{
+					const std::vector<uint8_t> row = next_row(rng, previous, changed_percent);
+
+					std::vector<uint8_t>  expected_indices = row;
+					std::vector<uint32_t> expected_canvas  = canvas;
+					int					  expected_last	   = LAST_SENTINEL;
+					const int			  expected_first   = dk::mark_row_scalar(expected_indices.data(),
+																				 width,
+																				 palette.data(),
+																				 TRANSPARENT,
+																				 expected_canvas.data(),
+																				 &expected_last);
+
+					for (const auto &kernel: kernels)
+					{
+						std::vector<uint8_t>  indices = row;
+						std::vector<uint32_t> actual  = canvas;
+						int					  last	  = LAST_SENTINEL;
+						const int			  first	  = kernel.mark_row(indices.data(), width, palette.data(), TRANSPARENT, actual.data(), &last);
+
+						const int index_mismatch  = first_mismatch(expected_indices, indices);
+						const int canvas_mismatch = first_mismatch(expected_canvas, actual);
+						if (first != expected_first || last != expected_last || index_mismatch >= 0 || canvas_mismatch >= 0)
+						{
+							std::cerr << std::format("mark_row_{} width={} changed={}%: first {} (expected {}), last {} (expected {}), "
+													 "first index mismatch {}, first canvas mismatch {}\n",
+													 kernel.name,
+													 width,
+													 changed_percent,
+													 first,
+													 expected_first,
+													 last,
+													 expected_last,
+													 index_mismatch,
+													 canvas_mismatch);
+							++failures;
+						}
+					}
+				}
+			}
+			return failures;
+		}
+
+		/**
+		 * @brief FrameDelta 在一串帧上的输出与逐像素参考实现比对
+		 *
+		 * 每帧在随机矩形内改写像素（部分帧不改写），矩形外的像素在同色索引间随机替换；
+		 * 参考实现维护自己的画布，求出变化像素的包围矩形与透明化后的索引。
+		 */
+		int check_frame_delta(std::mt19937 &rng)
+		{
+			constexpr int FRAMES = 60;
+
+			const auto palette = random_palette(rng);
+			int		   failures = 0;
+			for (const auto [width, height]: {std::array<int, 2>{1, 1}, {7, 5}, {67, 23}, {150, 64}})
+			{
+				const int stride = width + 13; // 行间留有间隙，确认不依赖连续存储
+
+				std::uniform_int_distribution<int> index(0, TRANSPARENT - 1);
+				std::uniform_int_distribution<int> coord_x(0, width - 1);
+				std::uniform_int_distribution<int> coord_y(0, height - 1);
+				std::vector<uint8_t>			   display(static_cast<std::size_t>(width) * height);
+				std::generate(display.begin(), display.end(), [&] { return static_cast<uint8_t>(index(rng)); });
+
+				FrameDelta delta;
+				for (int f = 0; f < FRAMES; ++f)
+				{
+					// f == 0 与 f == FRAMES / 2（reset 之后）为关键帧，应输出整帧
+					const bool key_frame = f == 0 || f == FRAMES / 2;
+					if (f == FRAMES / 2)
+					{
+						delta.reset();
+					}
+
+					std::vector<uint8_t> next = next_row(rng, display, 0);
+					if (f % 4 != 3)
+					{
+						const int x0 = coord_x(rng), x1 = coord_x(rng);
+						const int y0 = coord_y(rng), y1 = coord_y(rng);
+						for (int y = std::min(y0, y1); y <= std::max(y0, y1); ++y)
+						{
+							for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x)
+							{
+								next[static_cast<std::size_t>(y) * width + x] = static_cast<uint8_t>(index(rng));
+							}
+						}
+					}
+
+					// 参考实现：显示颜色变化的像素保留，其余改写为透明色
+					std::vector<uint8_t> expected = next;
+					DeltaRect			 expected_rect{0, 0, width, height};
+					if (!key_frame)
+					{
+						int rx0 = width, rx1 = -1, ry0 = height, ry1 = -1;
+						for (int y = 0; y < height; ++y)
+						{
+							for (int x = 0; x < width; ++x)
+							{
+								const std::size_t i = static_cast<std::size_t>(y) * width + x;
+								if (palette[next[i]] == palette[display[i]])
+								{
+									expected[i] = TRANSPARENT;
+									continue;
+								}
+								rx0 = std::min(rx0, x);
+								rx1 = std::max(rx1, x);
+								ry0 = std::min(ry0, y);
+								ry1 = y;
+							}
+						}
+						expected_rect = rx1 < 0 ? DeltaRect{} : DeltaRect{rx0, ry0, rx1 - rx0 + 1, ry1 - ry0 + 1};
+					}
+
+					std::vector<uint8_t> plane(static_cast<std::size_t>(stride) * height, 0xCD);
+					for (int y = 0; y < height; ++y)
+					{
+						std::copy_n(next.begin() + static_cast<std::ptrdiff_t>(y) * width, width, plane.begin() + static_cast<std::ptrdiff_t>(y) * stride);
+					}
+					const DeltaRect rect = delta.apply(plane.data(), stride, width, height, palette.data(), TRANSPARENT);
+
+					std::vector<uint8_t> actual(expected.size());
+					bool				 gaps_intact = true;
+					for (int y = 0; y < height; ++y)
+					{
+						const auto row = plane.begin() + static_cast<std::ptrdiff_t>(y) * stride;
+						std::copy_n(row, width, actual.begin() + static_cast<std::ptrdiff_t>(y) * width);
+						gaps_intact = gaps_intact && std::all_of(row + width, row + stride, [](const uint8_t b) { return b == 0xCD; });
+					}
+
+					if (!same_rect(rect, expected_rect) || actual != expected || !gaps_intact)
+					{
+						std::cerr << std::format("FrameDelta {}x{} frame {}: rect {},{} {}x{} (expected {},{} {}x{}), indices {}, stride gap {}\n",
+												 width,
+												 height,
+												 f,
+												 rect.x,
+												 rect.y,
+												 rect.width,
+												 rect.height,
+												 expected_rect.x,
+												 expected_rect.y,
+												 expected_rect.width,
+												 expected_rect.height,
+												 actual == expected ? "match" : "differ",
+												 gaps_intact ? "intact" : "overwritten");
+						++failures;
+					}
+					display = std::move(next);
+				}
+			}
+			return failures;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	std::mt19937 rng(20240613); // 固定种子，失败可复现
+	const auto	 kernels  = supported_kernels();
+	const int	 failures = check_rows(rng, kernels) + check_frame_delta(rng);
+
+	if (failures)
+	{
+		std::cerr << std::format("{} mismatches\n", failures);
+		return EXIT_FAILURE;
+	}
+	if (kernels.empty())
+	{
+		std::cout << "no SIMD delta kernels supported on this CPU; FrameDelta matches the reference\n";
+		return EXIT_SUCCESS;
+	}
+	for (const auto &kernel: kernels)
+	{
+		std::cout << std::format("{}: matches scalar\n", kernel.name);
+	}
+	std::cout << "FrameDelta rects match the reference\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file frame_dedup_test.cpp
+ * @brief 重复帧检测器的合并判定校验
+ *
+ * 以合成的切片帧序列（宽高都不是 16 的整数倍，行间留有间隙）逐帧调用 DuplicateDetector::is_duplicate，
+ * 核对每一帧是否被合并以及最终的 skipped() 计数：
+ * 精确模式只在索引与调色板完全一致时合并，不看 BGRA 画面；
+ * 感知模式在每个 16x16 块（含右侧与底部不完整的块）的平均通道差不超过阈值时合并，
+ * 局部的大幅变化不会被整帧平均稀释，缓慢渐变以上一次输出的帧为参照、累计超过阈值后输出新帧；
+ * 另外检查阈值为 0、尺寸变化与关闭检测时的行为。任一判定不符时输出原因并返回非 0。
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "frame_dedup.h"
+#include "task_options.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int WIDTH			= 37; // 两个完整块加宽 5 像素的不完整块，也不是 4 像素的整数倍
+		constexpr int HEIGHT		= 21;
+		constexpr int BGRA_PADDING	= 8;  // 行间间隙，间隙内的字节不参与比较
+		constexpr int INDEX_PADDING	= 3;
+		constexpr int THRESHOLD		= 8;
+
+		/**
+		 * @struct Frame
+		 * @brief 一帧切片：缩放后的 BGRA 画面与量化结果
+		 */
+		struct Frame
+		{
+			int						  width	 = WIDTH;
+			int						  height = HEIGHT;
+			std::vector<uint8_t>	  bgra;
+			std::vector<uint8_t>	  indices;
+			std::array<uint32_t, 256> palette{};
+
+			[[nodiscard]] int bgra_stride() const
+			{
+				return width * 4 + BGRA_PADDING;
+			}
+
+			[[nodiscard]] int index_stride() const
+			{
+				return width + INDEX_PADDING;
+			}
+
+			uint8_t &channel(const int x, const int y, const int c)
+			{
+				return bgra[static_cast<std::size_t>(y) * bgra_stride() + x * 4 + c];
+			}
+
+			uint8_t &index(const int x, const int y)
+			{
+				return indices[static_cast<std::size_t>(y) * index_stride() + x];
+			}
+		};
+
+		// 颜色通道取 40-215，加减扰动不会饱和；alpha 恒为 255；间隙字节随机
+		Frame random_frame(std::mt19937 &rng, const int width = WIDTH)
+		{
+			std::uniform_int_distribution<int> byte(0, 255);
+			std::uniform_int_distribution<int> color(40, 215);
+			Frame							   frame;
+			frame.width = width;
+			frame.bgra.resize(static_cast<std::size_t>(frame.bgra_stride()) * HEIGHT);
+			frame.indices.resize(static_cast<std::size_t>(frame.index_stride()) * HEIGHT);
+			std::ranges::generate(frame.bgra, [&] { return static_cast<uint8_t>(byte(rng)); });
+			std::ranges::generate(frame.indices, [&] { return static_cast<uint8_t>(byte(rng)); });
+			for (int y = 0; y < HEIGHT; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					for (int c = 0; c < 3; ++c)
+					{
+						frame.channel(x, y, c) = static_cast<uint8_t>(color(rng));
+					}
+					frame.channel(x, y, 3) = 255;
+				}
+			}
+			std::ranges::generate(frame.palette, [&] { return 0xFF000000u | static_cast<uint32_t>(byte(rng)) << 16 | static_cast<uint32_t>(byte(rng)); });
+			return frame;
+		}
+
+		// 矩形区域内的颜色通道统一加上 delta（可为负）
+		Frame shifted(Frame frame, const int x0, const int y0, const int width, const int height, const int delta)
+		{
+			for (int y = y0; y < y0 + height; ++y)
+			{
+				for (int x = x0; x < x0 + width; ++x)
+				{
+					for (int c = 0; c < 3; ++c)
+					{
+						frame.channel(x, y, c) = static_cast<uint8_t>(frame.channel(x, y, c) + delta);
+					}
+				}
+			}
+			return frame;
+		}
+
+		// 矩形区域内的颜色通道翻转最高位，每个通道的差恰为 128
+		Frame inverted(Frame frame, const int x0, const int y0, const int width, const int height)
+		{
+			for (int y = y0; y < y0 + height; ++y)
+			{
+				for (int x = x0; x < x0 + width; ++x)
+				{
+					for (int c = 0; c < 3; ++c)
+					{
+						frame.channel(x, y, c) ^= 0x80;
+					}
+				}
+			}
+			return frame;
+		}
+
+		// 每个颜色通道加上 ±amplitude 以内的随机扰动，并改写间隙字节
+		Frame noisy(std::mt19937 &rng, Frame frame, const int amplitude)
+		{
+			std::uniform_int_distribution<int> noise(-amplitude, amplitude);
+			for (int y = 0; y < HEIGHT; ++y)
+			{
+				for (int x = 0; x < frame.width; ++x)
+				{
+					for (int c = 0; c < 3; ++c)
+					{
+						frame.channel(x, y, c) = static_cast<uint8_t>(frame.channel(x, y, c) + noise(rng));
+					}
+				}
+				std::fill_n(frame.bgra.begin() + static_cast<std::ptrdiff_t>(y) * frame.bgra_stride() + frame.width * 4, BGRA_PADDING, 0xEE);
+			}
+			return frame;
+		}
+
+		/**
+		 * @struct Step
+		 * @brief 序列中的一帧及其预期判定
+		 */
+		struct Step
+		{
+			std::string_view name;
+			Frame			 frame;
+			bool			 duplicate;
+		};
+
+		/** @brief 按顺序送入检测器，核对每一帧的判定与最终的 skipped() */
+		int run(const std::string_view mode_name, const DedupMode mode, const int threshold, const std::vector<Step> &steps)
+		{
+			DuplicateDetector detector(mode, threshold);
+			int				  failures = 0;
+			int				  merged   = 0;
+			for (const auto &step: steps)
+			{
+				const Frame &f		   = step.frame;
+				const bool	 duplicate = detector.is_duplicate(f.bgra.data(),
+															   f.bgra_stride(),
+															   f.indices.data(),
+															   f.index_stride(),
+															   f.palette.data(),
+															   f.width,
+															   f.height);
+				if (duplicate != step.duplicate)
+				{
+					std::cerr << std::format("{}: \"{}\" {} merged, expected {}\n",
+											 mode_name,
+											 step.name,
+											 duplicate ? "was" : "was not",
+											 step.duplicate ? "merged" : "kept");
+					++failures;
+				}
+				merged += step.duplicate ? 1 : 0;
+			}
+			if (detector.skipped() != merged)
+			{
+				std::cerr << std::format("{}: skipped() = {}, expected {}\n", mode_name, detector.skipped(), merged);
+				++failures;
+			}
+			return failures;
+		}
+
+		/** @brief 精确模式：只比较索引与调色板 */
+		int check_exact(std::mt19937 &rng)
+		{
+			const Frame base = random_frame(rng);
+
+			Frame one_index = base;
+			++one_index.index(WIDTH - 1, HEIGHT - 1);
+
+			Frame unused_entry = one_index;
+			unused_entry.palette[255] ^= 0x00000001u; // 调色板任一项不同都不算重复
+
+			Frame index_gaps = unused_entry;
+			for (int y = 0; y < HEIGHT; ++y)
+			{
+				std::fill_n(index_gaps.indices.begin() + static_cast<std::ptrdiff_t>(y) * index_gaps.index_stride() + WIDTH, INDEX_PADDING, 0xEE);
+			}
+
+			const std::vector<Step> steps = {
+				{"first frame", base, false},
+				{"identical frame", base, true},
+				{"identical indices, BGRA differs", noisy(rng, base, 20), true},
+				{"one index differs", one_index, false},
+				{"same as the new reference", one_index, true},
+				{"one palette entry differs", unused_entry, false},
+				{"index gap bytes differ", index_gaps, true},
+			};
+			return run("Exact", DedupMode::Exact, THRESHOLD, steps);
+		}
+
+		/** @brief 感知模式：逐块平均通道差与阈值比较，参照帧为上一次输出的帧 */
+		int check_perceptual(std::mt19937 &rng)
+		{
+			const Frame base = random_frame(rng);
+
+			// 中间块内 5x5 的小区域大幅变化：该块的平均通道差为 12.5，整帧平均只有约 4，低于阈值
+			const Frame cursor = inverted(base, 20, 4, 5, 5);
+
+			Frame indices_only = base;
+			std::ranges::fill(indices_only.indices, 0);
+
+			// 右侧与底部不完整的块按实际像素数求平均：5x16 与 37x5 的区域整体加 THRESHOLD + 1 即超过阈值
+			const Frame right  = shifted(cursor, 32, 0, WIDTH - 32, 16, THRESHOLD + 1);
+			const Frame bottom = shifted(right, 0, 16, WIDTH, HEIGHT - 16, THRESHOLD + 1);
+
+			const std::vector<Step> steps = {
+				{"first frame", base, false},
+				{"identical frame", base, true},
+				{"noise below the threshold", noisy(rng, base, 4), true},
+				{"one block shifted below the threshold", shifted(base, 16, 0, 16, 16, THRESHOLD - 1), true},
+				{"whole frame shifted to the threshold", shifted(base, 0, 0, WIDTH, HEIGHT, THRESHOLD), true},
+				{"indices differ, BGRA identical", indices_only, true},
+				{"small patch far above the threshold", cursor, false},
+				{"same as the new reference", cursor, true},
+				{"partial right block above the threshold", right, false},
+				{"partial bottom blocks above the threshold", bottom, false},
+				{"partial corner block at the threshold", shifted(bottom, 32, 16, WIDTH - 32, HEIGHT - 16, THRESHOLD), true},
+			};
+			return run("Perceptual", DedupMode::Perceptual, THRESHOLD, steps);
+		}
+
+		/** @brief 缓慢渐变：与上一次输出的帧比较，累计差异超过阈值后输出新帧并以其为参照 */
+		int check_drift(std::mt19937 &rng)
+		{
+			const Frame base = random_frame(rng);
+
+			std::vector<Step> steps = {{"first frame", base, false}};
+			for (int step = 1; step <= 8; ++step)
+			{
+				// 每帧整体加 3：第 3 帧相对参照帧差 9，超过阈值；之后从第 3 帧重新累计，第 6 帧再次超过
+				steps.push_back({"drift", shifted(base, 0, 0, WIDTH, HEIGHT, 3 * step), step % 3 != 0});
+			}
+			return run("Perceptual drift", DedupMode::Perceptual, THRESHOLD, steps);
+		}
+
+		/** @brief 阈值 0、尺寸变化与关闭检测 */
+		int check_edge_cases(std::mt19937 &rng)
+		{
+			const Frame base = random_frame(rng);
+
+			int failures = run("Perceptual threshold 0",
+							   DedupMode::Perceptual,
+							   0,
+							   {
+								   {"first frame", base, false},
+								   {"identical frame", base, true},
+								   {"one channel off by one", shifted(base, 36, 20, 1, 1, 1), false},
+							   });
+
+			const Frame narrow = random_frame(rng, WIDTH - 1);
+			for (const DedupMode mode: {DedupMode::Exact, DedupMode::Perceptual})
+			{
+				failures += run(mode == DedupMode::Exact ? "Exact resize" : "Perceptual resize",
+								mode,
+								THRESHOLD,
+								{
+									{"first frame", base, false},
+									{"narrower frame", narrow, false},
+									{"same narrower frame", narrow, true},
+									{"original width again", base, false},
+								});
+			}
+
+			failures += run("Off", DedupMode::Off, THRESHOLD, {{"first frame", base, false}, {"identical frame", base, false}});
+			return failures;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	std::mt19937 rng(20240615); // 固定种子，失败可复现
+	const int	 failures = check_exact(rng) + check_perceptual(rng) + check_drift(rng) + check_edge_cases(rng);
+
+	if (failures)
+	{
+		std::cerr << std::format("{} failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::cout << "exact and perceptual duplicate detection merge the expected frames\n";
+	return EXIT_SUCCESS;
+}
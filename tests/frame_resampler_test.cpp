@@ -0,0 +1,304 @@
+/**
+ * @file frame_resampler_test.cpp
+ * @brief 时域重采样器的选帧与帧延迟校验
+ *
+ * 以带抖动、偶有丢帧的合成时间戳序列驱动 FrameResampler，按 GIF 写出器的方式由相邻输出时间戳推出帧延迟：
+ * 每个非空采样区间恰好选中一帧且为区间内第一个到达的帧，wants 对每个被选中的帧都为真，
+ * 帧延迟不小于 MIN_DELAY_CS，全部延迟（含 final_delay）之和与素材时长相差不超过一个采样间隔。
+ * 另外单独检查 MIN_DELAY_CS 对采样间隔与相邻输出时间戳的限制、max_frames 的上限与折算出的采样间隔，
+ * 以及 final_delay 的取值。任一检查失败时输出原因并返回非 0。
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "frame_resampler.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		/**
+		 * @brief 合成的源帧展示时间：标称帧率加 ±jitter 秒的均匀抖动，按 drop_percent% 的概率丢帧
+		 *
+		 * 抖动小于半个源帧间隔，时间戳保持单调递增；首帧固定在 0。
+		 */
+		std::vector<double> jittered_pts(std::mt19937 &rng, const double source_fps, const double duration, const double jitter, const int drop_percent)
+		{
+			std::uniform_real_distribution<double> offset(-jitter, jitter);
+			std::uniform_int_distribution<int>	   percent(0, 99);
+			std::vector<double>					   pts{0.0};
+			for (int i = 1; i / source_fps < duration; ++i)
+			{
+				if (percent(rng) >= drop_percent)
+				{
+					pts.push_back(i / source_fps + offset(rng));
+				}
+			}
+			return pts;
+		}
+
+		/**
+		 * @struct Selection
+		 * @brief 一次重采样的结果：被选中帧的源时间与输出时间戳（厘秒）
+		 */
+		struct Selection
+		{
+			std::vector<double>	 times;
+			std::vector<int64_t> timestamps;
+			int					 unwanted = 0; // accept 为真而 wants 为假的帧数，应为 0
+		};
+
+		Selection run(FrameResampler &resampler, const std::vector<double> &pts)
+		{
+			Selection selection;
+			for (const double t: pts)
+			{
+				const bool wanted = resampler.wants(t);
+				if (resampler.accept(t))
+				{
+					selection.unwanted += wanted ? 0 : 1;
+					selection.times.push_back(t);
+					selection.timestamps.push_back(resampler.last_timestamp());
+				}
+			}
+			return selection;
+		}
+
+		// 与写出器一致：帧延迟为下一帧与本帧输出时间戳之差，最后一帧使用 final_delay
+		std::vector<int64_t> delays_of(const Selection &selection, const FrameResampler &resampler)
+		{
+			std::vector<int64_t> delays;
+			for (std::size_t i = 0; i + 1 < selection.timestamps.size(); ++i)
+			{
+				delays.push_back(selection.timestamps[i + 1] - selection.timestamps[i]);
+			}
+			if (!selection.timestamps.empty())
+			{
+				delays.push_back(resampler.final_delay());
+			}
+			return delays;
+		}
+
+		/** @brief 抖动的可变帧率素材：选帧、延迟下限与延迟总和 */
+		int check_jittered(std::mt19937 &rng)
+		{
+			struct Case
+			{
+				double source_fps;
+				double target_fps;
+				double duration;
+				double jitter;
+				int	   drop_percent;
+			};
+			constexpr Case CASES[] = {
+				{30.0, 10.0, 10.0, 0.004, 5},
+				{29.97, 15.0, 7.3, 0.006, 10},
+				{40.0, 25.0, 4.0, 0.002, 0},
+				{24.0, 24.0, 6.0, 0.008, 3}, // 目标帧率等于源帧率：抖动不得造成漏选或重复
+			};
+
+			int failures = 0;
+			for (const Case &c: CASES)
+			{
+				const auto	 pts	  = jittered_pts(rng, c.source_fps, c.duration, c.jitter, c.drop_percent);
+				const auto	 name	  = std::format("{}fps -> {}fps", c.source_fps, c.target_fps);
+				const double interval = 1.0 / c.target_fps;
+
+				FrameResampler	resampler(c.target_fps, c.duration);
+				const Selection selection = run(resampler, pts);
+				const auto		delays	  = delays_of(selection, resampler);
+
+				// 参考：每个非空区间的第一个源帧。源帧间隔减去两倍抖动后仍不小于 2cs，MIN_DELAY_CS 在这里不起作用
+				std::vector<double> expected;
+				int64_t				last_cell = -1;
+				for (const double t: pts)
+				{
+					const auto cell = static_cast<int64_t>(std::floor(std::max(t, 0.0) / interval + 1e-6));
+					if (cell > last_cell)
+					{
+						expected.push_back(t);
+						last_cell = cell;
+					}
+				}
+				if (selection.times != expected)
+				{
+					std::cerr << std::format("{}: selected {} frames, expected the first frame of each of {} non-empty intervals\n",
+											 name,
+											 selection.times.size(),
+											 expected.size());
+					++failures;
+				}
+				if (selection.unwanted)
+				{
+					std::cerr << std::format("{}: {} accepted frames were rejected by wants()\n", name, selection.unwanted);
+					++failures;
+				}
+				if (resampler.accepted_count() != static_cast<int>(selection.times.size()))
+				{
+					std::cerr << std::format("{}: accepted_count {} but {} frames accepted\n", name, resampler.accepted_count(), selection.times.size());
+					++failures;
+				}
+
+				int64_t total = 0;
+				for (std::size_t i = 0; i < delays.size(); ++i)
+				{
+					total += delays[i];
+					if (delays[i] < FrameResampler::MIN_DELAY_CS || selection.timestamps[i] != std::llround(selection.times[i] * 100.0))
+					{
+						std::cerr << std::format("{}: frame {} at {:.4f}s has timestamp {}cs, delay {}cs\n",
+												 name,
+												 i,
+												 selection.times[i],
+												 selection.timestamps[i],
+												 delays[i]);
+						++failures;
+					}
+				}
+
+				// 最后一帧落在最后一个区间内，延迟总和与时长之差不超过一个采样间隔（另计一厘秒舍入）
+				const auto duration_cs = std::llround(c.duration * 100.0);
+				if (std::llabs(total - duration_cs) > resampler.final_delay() + 1)
+				{
+					std::cerr << std::format("{}: delays sum to {}cs, clip lasts {}cs\n", name, total, duration_cs);
+					++failures;
+				}
+			}
+			return failures;
+		}
+
+		/** @brief MIN_DELAY_CS：采样间隔不小于 2cs，相邻输出时间戳过近的帧不被选中 */
+		int check_min_delay(std::mt19937 &rng)
+		{
+			int failures = 0;
+
+			// 目标帧率 100fps（1cs）被限制为 2cs 的采样间隔
+			FrameResampler	fast(100.0, 3.0);
+			const Selection selection = run(fast, jittered_pts(rng, 120.0, 3.0, 0.001, 0));
+			for (const int64_t delay: delays_of(selection, fast))
+			{
+				if (delay < FrameResampler::MIN_DELAY_CS)
+				{
+					std::cerr << std::format("100fps target: delay {}cs below MIN_DELAY_CS\n", delay);
+					++failures;
+					break;
+				}
+			}
+			if (fast.final_delay() != FrameResampler::MIN_DELAY_CS || selection.times.size() > 151)
+			{
+				std::cerr << std::format("100fps target: final_delay {}cs, {} frames selected from 3s\n", fast.final_delay(), selection.times.size());
+				++failures;
+			}
+
+			// 相邻区间的两帧取整后只差不到 2cs 时，后一帧被拒绝，下一个足够远的帧照常选中
+			FrameResampler boundary(50.0);
+			const bool	   accepted[] = {boundary.accept(0.0), boundary.accept(0.039), boundary.accept(0.0401), boundary.accept(0.06)};
+			if (!accepted[0] || !accepted[1] || accepted[2] || !accepted[3] || boundary.last_timestamp() != 6)
+			{
+				std::cerr << std::format("MIN_DELAY_CS boundary: accepted {} {} {} {}, last timestamp {}cs\n",
+										 accepted[0],
+										 accepted[1],
+										 accepted[2],
+										 accepted[3],
+										 boundary.last_timestamp());
+				++failures;
+			}
+			return failures;
+		}
+
+		/** @brief max_frames：折算为更长的采样间隔让帧均匀覆盖素材，且选中帧数不超过上限 */
+		int check_max_frames(std::mt19937 &rng)
+		{
+			constexpr int	 MAX_FRAMES = 50;
+			constexpr double DURATION	= 20.0;
+
+			int failures = 0;
+
+			FrameResampler	capped(30.0, DURATION, MAX_FRAMES);
+			const Selection selection = run(capped, jittered_pts(rng, 30.0, DURATION, 0.004, 0));
+			const auto		selected  = static_cast<int>(selection.times.size());
+			const double	last	  = selection.times.empty() ? 0.0 : selection.times.back();
+
+			// 上限折算为 0.4s 的间隔；末尾的区间可能因抖动为空，少选一帧也可接受
+			if (selected > MAX_FRAMES || selected < MAX_FRAMES - 1 ||
+				capped.final_delay() != static_cast<int>(DURATION * 100 / MAX_FRAMES) || last < DURATION - 2 * DURATION / MAX_FRAMES)
+			{
+				std::cerr << std::format("max_frames {}: {} frames selected, final_delay {}cs, last frame at {:.2f}s\n",
+										 MAX_FRAMES,
+										 selected,
+										 capped.final_delay(),
+										 last);
+				++failures;
+			}
+
+			// 时长未知时无法折算间隔，达到上限后 wants 与 accept 都拒绝后续帧
+			FrameResampler	unknown(10.0, 0.0, 5);
+			const Selection first = run(unknown, jittered_pts(rng, 30.0, 3.0, 0.004, 0));
+			if (first.times.size() != 5 || unknown.wants(10.0) || unknown.accept(10.0) || unknown.final_delay() != 10)
+			{
+				std::cerr << std::format("max_frames 5 without duration: {} frames selected, final_delay {}cs\n", first.times.size(), unknown.final_delay());
+				++failures;
+			}
+			return failures;
+		}
+
+		/** @brief final_delay：一个采样间隔，取整到厘秒且不小于 MIN_DELAY_CS */
+		int check_final_delay()
+		{
+			struct Case
+			{
+				double target_fps;
+				double duration;
+				int	   max_frames;
+				int	   expected;
+			};
+			constexpr Case CASES[] = {
+				{10.0, 0.0, 0, 10},
+				{7.0, 0.0, 0, 14},	  // 14.29cs
+				{60.0, 0.0, 0, 2},	  // 1.67cs 提升到 MIN_DELAY_CS
+				{15.0, 12.0, 40, 30}, // 上限折算的间隔 0.3s 长于 1/15s
+				{15.0, 12.0, 400, 7}, // 折算的间隔更短，沿用 1/15s（6.67cs）
+			};
+
+			int failures = 0;
+			for (const Case &c: CASES)
+			{
+				const FrameResampler resampler(c.target_fps, c.duration, c.max_frames);
+				if (resampler.final_delay() != c.expected)
+				{
+					std::cerr << std::format("final_delay({}fps, {}s, max {}): {}cs, expected {}cs\n",
+											 c.target_fps,
+											 c.duration,
+											 c.max_frames,
+											 resampler.final_delay(),
+											 c.expected);
+					++failures;
+				}
+			}
+			return failures;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	std::mt19937 rng(20240614); // 固定种子，失败可复现
+	const int	 failures = check_jittered(rng) + check_min_delay(rng) + check_max_frames(rng) + check_final_delay();
+
+	if (failures)
+	{
+		std::cerr << std::format("{} failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::cout << "resampler selects one frame per interval; delays, MIN_DELAY_CS, max_frames and final_delay hold\n";
+	return EXIT_SUCCESS;
+}
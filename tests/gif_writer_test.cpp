@@ -0,0 +1,865 @@
+/**
+ * @file gif_writer_test.cpp
+ * @brief 自研 LZW 编码器与 GIF 写出器的往返校验
+ *
+ * LZW：最小码长 2-8 下的随机、长游程与空输入经测试内独立实现的 GIF LZW 解码器还原，须与输入逐字节一致；
+ * 大块随机数据会写满 4096 项字典，覆盖满表清表后的码流。
+ * 写出器：按文件模式与内存模式、有无线程池各写出一次同一组帧（含子矩形、透明色、局部颜色表、空矩形与超长延迟），
+ * 逐块解析输出的文件结构——文件头、全局/局部颜色表、图形控制扩展中的延迟、NETSCAPE2.0 循环扩展，
+ * 以及 Hex Hack 依赖的结尾符 0x3B——并解码每帧的图像数据。
+ * 有损：抖动渐变经 encode_lossy 压缩后须可解码，每个像素与源颜色的距离不超过误差预算，透明像素保持透明，
+ * 体积相对无损输出的缩减量被打印并与下限比较；误差预算为 0 时输出须与 encode 逐字节一致。任一检查失败时输出原因并返回非 0。
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "frame_delta.h"
+#include "gif_lzw.h"
+#include "gif_writer.h"
+#include "thread_pool.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int MAX_CODE_BITS = 12;
+		constexpr int TABLE_SIZE	= 1 << MAX_CODE_BITS;
+
+		/**
+		 * @struct LzwResult
+		 * @brief 解码得到的索引与码流中的清表码个数（含开头的一个）
+		 */
+		struct LzwResult
+		{
+			std::vector<uint8_t> pixels;
+			int					 clears = 0;
+		};
+
+		/**
+		 * @brief 独立实现的 GIF LZW 解码器，按规范处理码长增长、满表与清表
+		 * @param pos 输入为最小码长字节的位置，返回时指向块终止符之后
+		 * @return 码流不合法（缺少结束码、引用未定义的码等）时返回 std::nullopt
+		 */
+		std::optional<LzwResult> decode_lzw(const std::vector<uint8_t> &data, std::size_t &pos)
+		{
+			if (pos >= data.size())
+			{
+				return std::nullopt;
+			}
+			const int min_code_size = data[pos++];
+			if (min_code_size < 2 || min_code_size > 8)
+			{
+				return std::nullopt;
+			}
+
+			// 拼接子块
+			std::vector<uint8_t> stream;
+			while (true)
+			{
+				if (pos >= data.size())
+				{
+					return std::nullopt;
+				}
+				const std::size_t length = data[pos++];
+				if (length == 0)
+				{
+					break;
+				}
+				if (pos + length > data.size())
+				{
+					return std::nullopt;
+				}
+				stream.insert(stream.end(), data.begin() + static_cast<std::ptrdiff_t>(pos), data.begin() + static_cast<std::ptrdiff_t>(pos + length));
+				pos += length;
+			}
+
+			const int clear	= 1 << min_code_size;
+			const int eoi	= clear + 1;
+
+			std::array<int, TABLE_SIZE>		prefix{};
+			std::array<uint8_t, TABLE_SIZE>	suffix{};
+			std::array<uint8_t, TABLE_SIZE>	first{};
+			for (int c = 0; c < clear; ++c)
+			{
+				suffix[c] = static_cast<uint8_t>(c);
+				first[c]  = static_cast<uint8_t>(c);
+			}
+
+			LzwResult			 result;
+			std::vector<uint8_t> string;
+			int					 bits = min_code_size + 1;
+			int					 next = clear + 2;
+			int					 prev = -1;
+			std::size_t			 bit  = 0;
+
+			// 按码展开字符串（逆序收集后翻转）
+			auto expand = [&](int code)
+			{
+				string.clear();
+				while (code >= clear)
+				{
+					string.push_back(suffix[code]);
+					code = prefix[code];
+				}
+				string.push_back(static_cast<uint8_t>(code));
+				std::reverse(string.begin(), string.end());
+			};
+
+			while (true)
+			{
+				if (bit + bits > stream.size() * 8)
+				{
+					return std::nullopt; // 没有结束码
+				}
+				int code = 0;
+				for (int b = 0; b < bits; ++b, ++bit)
+				{
+					code |= ((stream[bit / 8] >> (bit % 8)) & 1) << b;
+				}
+
+				if (code == clear)
+				{
+					bits = min_code_size + 1;
+					next = clear + 2;
+					prev = -1;
+					++result.clears;
+					continue;
+				}
+				if (code == eoi)
+				{
+					break;
+				}
+				if (prev < 0)
+				{
+					if (code > clear)
+					{
+						return std::nullopt;
+					}
+					result.pixels.push_back(static_cast<uint8_t>(code));
+					prev = code;
+					continue;
+				}
+
+				if (code < next)
+				{
+					expand(code);
+				}
+				else if (code == next && next < TABLE_SIZE)
+				{
+					expand(prev);
+					string.push_back(first[prev]);
+				}
+				else
+				{
+					return std::nullopt;
+				}
+				result.pixels.insert(result.pixels.end(), string.begin(), string.end());
+
+				// 字典已满时不再添加，直到遇到清表码
+				if (next < TABLE_SIZE)
+				{
+					prefix[next] = prev;
+					suffix[next] = string.front();
+					first[next]	 = first[prev];
+					++next;
+					if (next == (1 << bits) && bits < MAX_CODE_BITS)
+					{
+						++bits;
+					}
+				}
+				prev = code;
+			}
+			return result;
+		}
+
+		/**
+		 * @struct ParsedFrame
+		 * @brief 从文件中解析出的一帧
+		 */
+		struct ParsedFrame
+		{
+			int					  delay		  = -1; // 未找到图形控制扩展时为 -1
+			int					  transparent = -1;
+			int					  disposal	  = 0;
+			DeltaRect			  rect;
+			int					  table_bits = 0; // 局部颜色表位数，0 表示没有局部颜色表
+			std::vector<uint32_t> table;
+			std::vector<uint8_t>  pixels;
+		};
+
+		/**
+		 * @struct ParsedGif
+		 * @brief 逐块解析得到的文件结构
+		 */
+		struct ParsedGif
+		{
+			int						 width		 = 0;
+			int						 height		 = 0;
+			int						 global_bits = 0;
+			std::vector<uint32_t>	 global_table;
+			int						 loop_count = -1; // 未找到 NETSCAPE2.0 扩展时为 -1
+			std::vector<ParsedFrame> frames;
+		};
+
+		int read_u16(const std::vector<uint8_t> &data, const std::size_t pos)
+		{
+			return data[pos] | (data[pos + 1] << 8);
+		}
+
+		std::vector<uint32_t> read_table(const std::vector<uint8_t> &data, std::size_t &pos, const int bits)
+		{
+			std::vector<uint32_t> table(static_cast<std::size_t>(1) << bits);
+			for (auto &c: table)
+			{
+				c = 0xFF000000u | (static_cast<uint32_t>(data[pos]) << 16) | (static_cast<uint32_t>(data[pos + 1]) << 8) | data[pos + 2];
+				pos += 3;
+			}
+			return table;
+		}
+
+		/** @brief 解析完整的 GIF89a 文件；结构错误时在 error 中给出原因 */
+		std::optional<ParsedGif> parse_gif(const std::vector<uint8_t> &data, std::string &error)
+		{
+			static constexpr std::string_view SIGNATURE = "GIF89a";
+			if (data.size() < 13 || !std::equal(SIGNATURE.begin(), SIGNATURE.end(), data.begin()))
+			{
+				error = "missing GIF89a header";
+				return std::nullopt;
+			}
+
+			ParsedGif gif;
+			gif.width  = read_u16(data, 6);
+			gif.height = read_u16(data, 8);
+
+			const int	packed = data[10];
+			std::size_t	pos	   = 13;
+			if (packed & 0x80)
+			{
+				gif.global_bits	 = (packed & 0x07) + 1;
+				gif.global_table = read_table(data, pos, gif.global_bits);
+			}
+
+			ParsedFrame pending;
+			while (pos < data.size())
+			{
+				const int introducer = data[pos++];
+				if (introducer == 0x3B)
+				{
+					if (pos != data.size())
+					{
+						error = std::format("{} bytes after the trailer", data.size() - pos);
+						return std::nullopt;
+					}
+					return gif;
+				}
+
+				if (introducer == 0x21 && pos < data.size())
+				{
+					const int label = data[pos++];
+					if (label == 0xF9)
+					{
+						if (data[pos] != 4 || data[pos + 5] != 0)
+						{
+							error = "malformed graphic control extension";
+							return std::nullopt;
+						}
+						const int flags		= data[pos + 1];
+						pending.disposal	= (flags >> 2) & 0x07;
+						pending.delay		= read_u16(data, pos + 2);
+						pending.transparent = (flags & 1) ? data[pos + 4] : -1;
+						pos += 6;
+						continue;
+					}
+					if (label == 0xFF)
+					{
+						static constexpr std::string_view NETSCAPE = "NETSCAPE2.0";
+						if (data[pos] != 11 || !std::equal(NETSCAPE.begin(), NETSCAPE.end(), data.begin() + static_cast<std::ptrdiff_t>(pos + 1)))
+						{
+							error = "unknown application extension";
+							return std::nullopt;
+						}
+						pos += 12;
+						if (data[pos] != 3 || data[pos + 1] != 1 || data[pos + 4] != 0)
+						{
+							error = "malformed NETSCAPE2.0 loop block";
+							return std::nullopt;
+						}
+						gif.loop_count = read_u16(data, pos + 2);
+						pos += 5;
+						continue;
+					}
+					error = std::format("unexpected extension 0x{:02X}", label);
+					return std::nullopt;
+				}
+
+				if (introducer == 0x2C && pos + 9 <= data.size())
+				{
+					ParsedFrame frame = pending;
+					pending			  = {};
+					frame.rect		  = {read_u16(data, pos), read_u16(data, pos + 2), read_u16(data, pos + 4), read_u16(data, pos + 6)};
+					const int flags	  = data[pos + 8];
+					pos += 9;
+					if (flags & 0x40)
+					{
+						error = "interlaced frame";
+						return std::nullopt;
+					}
+					if (flags & 0x80)
+					{
+						frame.table_bits = (flags & 0x07) + 1;
+						frame.table		 = read_table(data, pos, frame.table_bits);
+					}
+					auto decoded = decode_lzw(data, pos);
+					if (!decoded)
+					{
+						error = std::format("frame {}: LZW data does not decode", gif.frames.size());
+						return std::nullopt;
+					}
+					frame.pixels = std::move(decoded->pixels);
+					gif.frames.push_back(std::move(frame));
+					continue;
+				}
+
+				error = std::format("unexpected block 0x{:02X} at offset {}", introducer, pos - 1);
+				return std::nullopt;
+			}
+			error = "missing 0x3B trailer";
+			return std::nullopt;
+		}
+
+		std::vector<uint8_t> random_pixels(std::mt19937 &rng, const std::size_t count, const int colors)
+		{
+			std::uniform_int_distribution<int> value(0, colors - 1);
+			std::vector<uint8_t>			   pixels(count);
+			for (auto &p: pixels)
+			{
+				p = static_cast<uint8_t>(value(rng));
+			}
+			return pixels;
+		}
+
+		// 长游程：同一值重复随机次数，产生远长于字典项的串
+		std::vector<uint8_t> run_pixels(std::mt19937 &rng, const std::size_t count, const int colors)
+		{
+			std::uniform_int_distribution<int> value(0, colors - 1);
+			std::uniform_int_distribution<int> run(1, 3000);
+			std::vector<uint8_t>			   pixels;
+			while (pixels.size() < count)
+			{
+				pixels.insert(pixels.end(), std::min<std::size_t>(run(rng), count - pixels.size()), static_cast<uint8_t>(value(rng)));
+			}
+			return pixels;
+		}
+
+		/** @brief LzwEncoder::encode 的输出经独立解码器还原 */
+		int check_lzw(std::mt19937 &rng)
+		{
+			constexpr std::size_t LARGE = 100000; // 随机数据远超 4096 项字典，必然满表清表
+
+			LzwEncoder encoder; // 与写出器一样在各次编码之间复用
+			int		   failures = 0;
+			for (int min_code_size = 2; min_code_size <= 8; ++min_code_size)
+			{
+				const int colors = 1 << min_code_size;
+				struct Input
+				{
+					std::string_view	 name;
+					std::vector<uint8_t> pixels;
+					bool				 fills_table;
+				};
+				const std::array<Input, 6> inputs = {{
+					{"empty", {}, false},
+					{"single", random_pixels(rng, 1, colors), false},
+					{"short", random_pixels(rng, 37, colors), false},
+					{"constant", std::vector<uint8_t>(LARGE, static_cast<uint8_t>(colors - 1)), false},
+					{"runs", run_pixels(rng, LARGE, colors), false},
+					{"random", random_pixels(rng, LARGE, colors), true},
+				}};
+
+				for (const auto &input: inputs)
+				{
+					std::vector<uint8_t> encoded;
+					encoder.encode(input.pixels.data(), input.pixels.size(), min_code_size, encoded);
+
+					std::size_t pos		= 0;
+					const auto	decoded = decode_lzw(encoded, pos);
+					if (!decoded || pos != encoded.size())
+					{
+						std::cerr << std::format("lzw min_code_size={} {}: output does not decode\n", min_code_size, input.name);
+						++failures;
+						continue;
+					}
+					if (decoded->pixels != input.pixels)
+					{
+						std::cerr << std::format("lzw min_code_size={} {}: decoded {} pixels, expected {} (contents differ)\n",
+												 min_code_size,
+												 input.name,
+												 decoded->pixels.size(),
+												 input.pixels.size());
+						++failures;
+					}
+					if (input.fills_table && decoded->clears < 2)
+					{
+						std::cerr << std::format("lzw min_code_size={} {}: expected a clear code after the dictionary filled\n", min_code_size, input.name);
+						++failures;
+					}
+				}
+			}
+			return failures;
+		}
+
+		/**
+		 * @struct InputFrame
+		 * @brief 提交给写出器的一帧及其预期
+		 */
+		struct InputFrame
+		{
+			std::vector<uint8_t> indices; // 整帧索引平面
+			DeltaRect			 rect;
+			const uint32_t		*palette	 = nullptr;
+			int					 colors		 = 0;
+			int					 transparent = -1;
+			int64_t				 pts		 = 0;
+		};
+
+		constexpr int		  FRAME_WIDTH  = 40;
+		constexpr int		  FRAME_HEIGHT = 30;
+		constexpr int		  COLORS	   = 12;	// 颜色表位数为 4，表中多出的项同样写出
+		constexpr int		  TABLE_BITS   = 4;
+		constexpr int		  FINAL_DELAY  = 5;
+		constexpr int		  LONG_GAP	   = 70000; // 超出 16 位延迟，写出时截断为 0xFFFF
+		constexpr std::size_t RING_FRAMES  = 40;	// 多于写出器的在途帧数，覆盖任务槽的循环复用
+
+		std::vector<InputFrame> make_frames(std::mt19937 &rng, const std::array<uint32_t, 256> &palette_a, const std::array<uint32_t, 256> &palette_b)
+		{
+			std::vector<InputFrame> frames;
+			auto					add = [&](const DeltaRect &rect, const std::array<uint32_t, 256> &palette, const int transparent, const int64_t pts)
+			{
+				frames.push_back({random_pixels(rng, FRAME_WIDTH * FRAME_HEIGHT, COLORS), rect, palette.data(), COLORS, transparent, pts});
+			};
+
+			add({0, 0, FRAME_WIDTH, FRAME_HEIGHT}, palette_a, -1, 0);		// 首帧：调色板成为全局颜色表
+			add({5, 4, 10, 7}, palette_a, COLORS - 1, 7);					// 子矩形 + 透明色
+			add({0, 0, FRAME_WIDTH, FRAME_HEIGHT}, palette_b, -1, 19);		// 调色板不同：局部颜色表
+			add({}, palette_a, COLORS - 1, 20);								// 空矩形按 1x1 写出
+			add({39, 29, 1, 1}, palette_a, -1, 20 + LONG_GAP);				// 右下角单像素，之后的延迟超出 16 位
+			std::uniform_int_distribution<int> coord(0, FRAME_WIDTH - 1);
+			std::uniform_int_distribution<int> step(0, 9);
+			int64_t							   pts = 40 + LONG_GAP;
+			for (std::size_t i = 0; i < RING_FRAMES; ++i)
+			{
+				const int x = coord(rng) % FRAME_WIDTH;
+				const int y = coord(rng) % FRAME_HEIGHT;
+				const int w = 1 + coord(rng) % (FRAME_WIDTH - x);
+				const int h = 1 + coord(rng) % (FRAME_HEIGHT - y);
+				add({x, y, w, h}, i % 3 == 0 ? palette_b : palette_a, i % 2 ? COLORS - 1 : -1, pts);
+				pts += step(rng);
+			}
+			return frames;
+		}
+
+		// 写出器按下一帧的时间戳推出延迟，最后一帧使用 finish 的参数
+		int expected_delay(const std::vector<InputFrame> &frames, const std::size_t i)
+		{
+			if (i + 1 == frames.size())
+			{
+				return FINAL_DELAY;
+			}
+			return static_cast<int>(std::min<int64_t>(frames[i + 1].pts - frames[i].pts, 0xFFFF));
+		}
+
+		/** @brief 检查一份输出的结构与内容 */
+		int check_output(const std::string_view				 mode,
+						 const std::vector<uint8_t>			&bytes,
+						 const std::vector<InputFrame>		&frames,
+						 const std::array<uint32_t, 256>	&palette_a)
+		{
+			std::string error;
+			const auto	gif = parse_gif(bytes, error);
+			if (!gif)
+			{
+				std::cerr << std::format("{}: {}\n", mode, error);
+				return 1;
+			}
+
+			int	 failures = 0;
+			auto fail	  = [&](const std::string &message)
+			{
+				std::cerr << std::format("{}: {}\n", mode, message);
+				++failures;
+			};
+
+			if (gif->width != FRAME_WIDTH || gif->height != FRAME_HEIGHT)
+			{
+				fail(std::format("logical screen {}x{}", gif->width, gif->height));
+			}
+			if (gif->global_bits != TABLE_BITS || !std::equal(gif->global_table.begin(), gif->global_table.end(), palette_a.begin()))
+			{
+				fail(std::format("global colour table ({} bits) does not match the first frame's palette", gif->global_bits));
+			}
+			if (gif->loop_count != 0)
+			{
+				fail(std::format("NETSCAPE2.0 loop count {} (expected 0, infinite)", gif->loop_count));
+			}
+			if (gif->frames.size() != frames.size())
+			{
+				fail(std::format("{} frames written, expected {}", gif->frames.size(), frames.size()));
+				return failures;
+			}
+
+			for (std::size_t i = 0; i < frames.size(); ++i)
+			{
+				const InputFrame  &in	= frames[i];
+				const ParsedFrame &out	= gif->frames[i];
+				const DeltaRect	   rect = in.rect.empty() ? DeltaRect{0, 0, 1, 1} : in.rect;
+
+				if (out.delay != expected_delay(frames, i))
+				{
+					fail(std::format("frame {}: delay {} expected {}", i, out.delay, expected_delay(frames, i)));
+				}
+				if (out.transparent != in.transparent || out.disposal != 1)
+				{
+					fail(std::format("frame {}: transparent {} disposal {}", i, out.transparent, out.disposal));
+				}
+				if (out.rect.x != rect.x || out.rect.y != rect.y || out.rect.width != rect.width || out.rect.height != rect.height)
+				{
+					fail(std::format("frame {}: rect {},{} {}x{}", i, out.rect.x, out.rect.y, out.rect.width, out.rect.height));
+				}
+
+				// 与全局颜色表相同的调色板不带局部颜色表，不同的带完整的局部颜色表
+				const bool local = in.palette != palette_a.data();
+				if (local != (out.table_bits != 0) || (local && (out.table_bits != TABLE_BITS || !std::equal(out.table.begin(), out.table.end(), in.palette))))
+				{
+					fail(std::format("frame {}: local colour table ({} bits) does not match", i, out.table_bits));
+				}
+
+				std::vector<uint8_t> expected;
+				for (int y = rect.y; y < rect.y + rect.height; ++y)
+				{
+					const auto row = in.indices.begin() + static_cast<std::ptrdiff_t>(y) * FRAME_WIDTH + rect.x;
+					expected.insert(expected.end(), row, row + rect.width);
+				}
+				if (out.pixels != expected)
+				{
+					fail(std::format("frame {}: decoded pixels differ from the sub-rectangle", i));
+				}
+			}
+			return failures;
+		}
+
+		std::vector<uint8_t> read_file(const std::filesystem::path &path)
+		{
+			std::ifstream in(path, std::ios::binary);
+			return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+		}
+
+		void submit_frames(GifWriter &writer, const std::vector<InputFrame> &frames)
+		{
+			for (const auto &f: frames)
+			{
+				writer.add_frame(f.indices.data(), FRAME_WIDTH, f.rect, f.palette, f.colors, f.transparent, f.pts);
+			}
+		}
+
+		/** @brief 文件模式与内存模式、有无线程池分别写出同一组帧，输出须逐字节一致且结构正确 */
+		int check_writer(std::mt19937 &rng, const std::filesystem::path &dir)
+		{
+			std::array<uint32_t, 256>				palette_a{};
+			std::array<uint32_t, 256>				palette_b{};
+			std::uniform_int_distribution<uint32_t>	color(0, 0xFFFFFF);
+			for (std::size_t i = 0; i < palette_a.size(); ++i)
+			{
+				palette_a[i] = 0xFF000000u | color(rng);
+				palette_b[i] = 0xFF000000u | color(rng);
+			}
+			const auto frames = make_frames(rng, palette_a, palette_b);
+
+			ThreadPool							pool(4);
+			std::optional<std::vector<uint8_t>>	reference;
+			int									failures = 0;
+			for (ThreadPool *writer_pool: {static_cast<ThreadPool *>(nullptr), &pool})
+			{
+				const std::string_view threading = writer_pool ? "pool" : "inline";
+
+				// 文件模式
+				{
+					const auto path = dir / std::format("{}.gif", threading);
+					GifWriter  writer;
+					if (!writer.open(path, FRAME_WIDTH, FRAME_HEIGHT, writer_pool, 0))
+					{
+						std::cerr << std::format("file/{}: cannot open {}\n", threading, path.string());
+						++failures;
+						continue;
+					}
+					submit_frames(writer, frames);
+					const std::size_t reported = (writer.finish(FINAL_DELAY), writer.size());
+					const auto		  bytes	   = read_file(path);
+					if (reported != bytes.size())
+					{
+						std::cerr << std::format("file/{}: size() reports {} bytes, file has {}\n", threading, reported, bytes.size());
+						++failures;
+					}
+					failures += check_output(std::format("file/{}", threading), bytes, frames, palette_a);
+					if (!reference)
+					{
+						reference = bytes;
+					}
+					else if (bytes != *reference)
+					{
+						std::cerr << std::format("file/{}: output differs from the first run\n", threading);
+						++failures;
+					}
+				}
+
+				// 内存模式，复用同一个写出器写两次，第二次的输出不应残留第一次的内容
+				{
+					GifWriter writer;
+					for (int round = 0; round < 2; ++round)
+					{
+						writer.open_memory(FRAME_WIDTH, FRAME_HEIGHT, writer_pool, 0);
+						submit_frames(writer, frames);
+						if (!writer.finish(FINAL_DELAY))
+						{
+							std::cerr << std::format("memory/{}: finish failed\n", threading);
+							++failures;
+							continue;
+						}
+						const auto mode = std::format("memory/{}/round {}", threading, round);
+						failures += check_output(mode, writer.bytes(), frames, palette_a);
+						if (writer.bytes() != *reference)
+						{
+							std::cerr << std::format("{}: output differs from file mode\n", mode);
+							++failures;
+						}
+					}
+				}
+			}
+			return failures;
+		}
+
+		constexpr int LOSSY_WIDTH  = 192;
+		constexpr int LOSSY_HEIGHT = 128;
+		constexpr int RATIO_ERROR  = 24; // 统计压缩率时的误差预算，与码率控制第二档一致
+		constexpr int MIN_SAVING   = 40; // 体积至少减少的百分比，远低于实测值，只防止有损路径退化为无损
+		constexpr int FRAME_ERROR  = 48; // 写出器路径使用的误差预算
+
+		// 相邻项颜色相近的渐变调色板，colors 项均匀取自同一条渐变
+		std::array<uint32_t, 256> ramp_palette(const int colors)
+		{
+			std::array<uint32_t, 256> palette{};
+			for (int i = 0; i < colors; ++i)
+			{
+				const int v = i * 255 / std::max(colors - 1, 1);
+				palette[i]	= 0xFF000000u | (static_cast<uint32_t>(v) << 16) | (static_cast<uint32_t>(64 + v / 2) << 8) | static_cast<uint32_t>(255 - v);
+			}
+			return palette;
+		}
+
+		// 抖动后的渐变：索引沿对角线缓慢变化并叠加随机扰动；透明色只出现在若干矩形区域内（transparent 须不小于 1）
+		std::vector<uint8_t> dithered_pixels(std::mt19937 &rng, const int colors, const int transparent)
+		{
+			std::uniform_int_distribution<int> noise(-2, 2);
+			std::vector<uint8_t>			   pixels(static_cast<std::size_t>(LOSSY_WIDTH) * LOSSY_HEIGHT);
+			for (int y = 0; y < LOSSY_HEIGHT; ++y)
+			{
+				uint8_t *row = pixels.data() + static_cast<std::size_t>(y) * LOSSY_WIDTH;
+				for (int x = 0; x < LOSSY_WIDTH; ++x)
+				{
+					const bool hole	 = transparent >= 0 && (x / 24 + y / 16) % 5 == 0;
+					const int  value = std::clamp((x + y) * (colors - 1) / (LOSSY_WIDTH + LOSSY_HEIGHT) + noise(rng), 0, colors - 1);
+					row[x]			 = static_cast<uint8_t>(hole ? transparent : value == transparent ? value - 1 : value);
+				}
+			}
+			return pixels;
+		}
+
+		/**
+		 * @brief 核对有损解码结果：透明像素保持透明，其余像素不变为透明且与源颜色的距离不超过 max_error
+		 * @return 违反的像素数
+		 */
+		int count_violations(const std::vector<uint8_t> &source,
+							 const std::vector<uint8_t> &decoded,
+							 const uint32_t				*palette,
+							 const int					 transparent,
+							 const int					 max_error)
+		{
+			if (decoded.size() != source.size())
+			{
+				return static_cast<int>(std::max(decoded.size(), source.size()));
+			}
+			int violations = 0;
+			for (std::size_t i = 0; i < source.size(); ++i)
+			{
+				if ((source[i] == transparent) != (decoded[i] == transparent))
+				{
+					++violations;
+					continue;
+				}
+				const int dr = static_cast<int>((palette[source[i]] >> 16) & 0xFF) - static_cast<int>((palette[decoded[i]] >> 16) & 0xFF);
+				const int dg = static_cast<int>((palette[source[i]] >> 8) & 0xFF) - static_cast<int>((palette[decoded[i]] >> 8) & 0xFF);
+				const int db = static_cast<int>(palette[source[i]] & 0xFF) - static_cast<int>(palette[decoded[i]] & 0xFF);
+				if (dr * dr + dg * dg + db * db > max_error * max_error)
+				{
+					++violations;
+				}
+			}
+			return violations;
+		}
+
+		/** @brief LzwEncoder::encode_lossy：可解码、误差有界、透明色不变、体积减小，误差预算为 0 时与 encode 逐字节一致 */
+		int check_lossy(std::mt19937 &rng)
+		{
+			LzwEncoder encoder;
+			int		   failures = 0;
+			for (int min_code_size = 2; min_code_size <= 8; ++min_code_size)
+			{
+				const int  colors	   = 1 << min_code_size;
+				const int  transparent = colors - 1;
+				const auto palette	   = ramp_palette(colors);
+				const auto pixels	   = dithered_pixels(rng, colors, transparent);
+
+				std::vector<uint8_t> lossless;
+				encoder.encode(pixels.data(), pixels.size(), min_code_size, lossless);
+				std::vector<uint8_t> zero;
+				encoder.encode_lossy(pixels.data(), pixels.size(), min_code_size, palette.data(), transparent, 0, zero);
+				if (zero != lossless)
+				{
+					std::cerr << std::format("lossy min_code_size={}: lossy_error=0 output differs from the lossless encoder\n", min_code_size);
+					++failures;
+				}
+
+				for (const int max_error: {8, RATIO_ERROR, 80})
+				{
+					std::vector<uint8_t> encoded;
+					encoder.encode_lossy(pixels.data(), pixels.size(), min_code_size, palette.data(), transparent, max_error, encoded);
+
+					std::size_t pos		= 0;
+					const auto	decoded = decode_lzw(encoded, pos);
+					if (!decoded || pos != encoded.size())
+					{
+						std::cerr << std::format("lossy min_code_size={} error={}: output does not decode\n", min_code_size, max_error);
+						++failures;
+						continue;
+					}
+					if (const int violations = count_violations(pixels, decoded->pixels, palette.data(), transparent, max_error))
+					{
+						std::cerr << std::format("lossy min_code_size={} error={}: {} pixels exceed the error budget or change transparency\n",
+												 min_code_size,
+												 max_error,
+												 violations);
+						++failures;
+					}
+
+					if (min_code_size == 8 && max_error == RATIO_ERROR)
+					{
+						const auto saving = 100.0 - 100.0 * static_cast<double>(encoded.size()) / static_cast<double>(lossless.size());
+						std::cout << std::format("lossy error={}: {} -> {} bytes ({:.1f}% smaller)\n", max_error, lossless.size(), encoded.size(), saving);
+						if (saving < MIN_SAVING)
+						{
+							std::cerr << std::format("lossy error={}: only {:.1f}% smaller than lossless, expected at least {}%\n",
+													 max_error,
+													 saving,
+													 MIN_SAVING);
+							++failures;
+						}
+					}
+				}
+			}
+			return failures;
+		}
+
+		/** @brief 写出器的有损路径：局部颜色表与透明色下的帧同样可解码且误差有界 */
+		int check_lossy_writer(std::mt19937 &rng)
+		{
+			constexpr int COLORS_LOSSY = 256;
+			constexpr int FRAMES	   = 6;
+
+			const auto				  palette = ramp_palette(COLORS_LOSSY);
+			std::array<uint32_t, 256> shifted = palette; // 与全局颜色表不同，第 2、4、6 帧携带局部颜色表
+			shifted[0] ^= 0x00010101u;
+
+			ThreadPool						  pool(4);
+			std::vector<std::vector<uint8_t>> sources;
+			GifWriter						  lossless;
+			GifWriter						  lossy;
+			lossless.open_memory(LOSSY_WIDTH, LOSSY_HEIGHT, &pool, 0);
+			lossy.open_memory(LOSSY_WIDTH, LOSSY_HEIGHT, &pool, FRAME_ERROR);
+			for (int i = 0; i < FRAMES; ++i)
+			{
+				const int transparent = i % 2 ? 17 : -1;
+				sources.push_back(dithered_pixels(rng, COLORS_LOSSY, transparent));
+				const uint32_t *frame_palette = i % 2 ? shifted.data() : palette.data();
+				for (GifWriter *writer: {&lossless, &lossy})
+				{
+					writer->add_frame(sources.back().data(), LOSSY_WIDTH, {0, 0, LOSSY_WIDTH, LOSSY_HEIGHT}, frame_palette, COLORS_LOSSY, transparent, i * 4);
+				}
+			}
+			if (!lossless.finish(4) || !lossy.finish(4))
+			{
+				std::cerr << "lossy writer: finish failed\n";
+				return 1;
+			}
+
+			std::string error;
+			const auto	gif = parse_gif(lossy.bytes(), error);
+			if (!gif || gif->frames.size() != FRAMES)
+			{
+				std::cerr << std::format("lossy writer: {}\n", gif ? "wrong frame count" : error);
+				return 1;
+			}
+			int failures = 0;
+			for (int i = 0; i < FRAMES; ++i)
+			{
+				const ParsedFrame &frame	   = gif->frames[i];
+				const auto		  &table	   = frame.table_bits ? frame.table : gif->global_table;
+				const int		   transparent = i % 2 ? 17 : -1;
+				if (const int violations = count_violations(sources[i], frame.pixels, table.data(), transparent, FRAME_ERROR))
+				{
+					std::cerr << std::format("lossy writer frame {}: {} pixels exceed the error budget or change transparency\n", i, violations);
+					++failures;
+				}
+			}
+			std::cout << std::format("lossy writer error={}: {} -> {} bytes\n", FRAME_ERROR, lossless.size(), lossy.size());
+			if (lossy.size() >= lossless.size())
+			{
+				std::cerr << "lossy writer: output is not smaller than lossless\n";
+				++failures;
+			}
+			return failures;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	const auto dir = std::filesystem::temp_directory_path() / "ssg_gif_writer_test";
+	std::filesystem::create_directories(dir);
+
+	std::mt19937 rng(20240612); // 固定种子，失败可复现
+	const int	 failures = check_lzw(rng) + check_writer(rng, dir) + check_lossy(rng) + check_lossy_writer(rng);
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	if (failures)
+	{
+		std::cerr << std::format("{} failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::cout << "LZW streams decode for min code sizes 2-8; file and memory output parse and decode; lossy output stays within its error budget\n";
+	return EXIT_SUCCESS;
+}
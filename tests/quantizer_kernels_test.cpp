@@ -0,0 +1,235 @@
+/**
+ * @file quantizer_kernels_test.cpp
+ * @brief SIMD 量化内核与标量参考实现的逐字节比对
+ *
+ * 只测试当前 CPU 支持的内核。随机 BGRA 行覆盖 1-67 像素的全部宽度（包含不是 4/8/16 整数倍的剩余像素）
+ * 与切片、展柜宽度，分别在无偏置与有序抖动偏置下比对；再经 Quantizer::map 以真实的抖动偏置比对整幅图像。
+ * 任一结果不一致时输出首个差异并返回非 0。
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "cpu_features.h"
+#include "quantizer.h"
+#include "quantizer_kernels.h"
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		namespace qk = QuantizerKernels;
+
+		struct KernelCase
+		{
+			std::string_view  name;
+			Quantizer::Kernel kernel;
+			qk::MapRow		  map_row;
+		};
+
+		std::vector<KernelCase> supported_kernels()
+		{
+			std::vector<KernelCase> kernels;
+#if SSG_ARCH_X86
+			const auto &cpu = cpu_features();
+			if (cpu.sse41)
+			{
+				kernels.push_back({"sse41", Quantizer::Kernel::Sse41, qk::map_row_sse41});
+			}
+			if (cpu.avx2)
+			{
+				kernels.push_back({"avx2", Quantizer::Kernel::Avx2, qk::map_row_avx2});
+			}
+			if (cpu.avx512)
+			{
+				kernels.push_back({"avx512", Quantizer::Kernel::Avx512, qk::map_row_avx512});
+			}
+#endif
+			return kernels;
+		}
+
+		std::vector<uint8_t> random_bytes(std::mt19937 &rng, const std::size_t count)
+		{
+			std::uniform_int_distribution<int> byte(0, 255);
+			std::vector<uint8_t>			   bytes(count);
+			for (auto &b: bytes)
+			{
+				b = static_cast<uint8_t>(byte(rng));
+			}
+			return bytes;
+		}
+
+		/**
+		 * @brief 随机有序抖动偏置：与 Quantizer 生成的偏置一样，每个字节只有 bias_add 或 bias_sub 之一非 0
+		 *
+		 * 两者同时非 0 时标量实现的 clamp(v + add - sub) 与 SIMD 的先饱和加、再饱和减本就不等价。
+		 * 幅度取满 0-255，覆盖两个方向的饱和。
+		 */
+		void random_bias(std::mt19937 &rng, const std::size_t count, std::vector<uint8_t> &bias_add, std::vector<uint8_t> &bias_sub)
+		{
+			std::uniform_int_distribution<int> bias(-255, 255);
+			bias_add.assign(count, 0);
+			bias_sub.assign(count, 0);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const int b = bias(rng);
+				(b >= 0 ? bias_add[i] : bias_sub[i]) = static_cast<uint8_t>(b >= 0 ? b : -b);
+			}
+		}
+
+		Palette random_palette(std::mt19937 &rng, const int size)
+		{
+			std::uniform_int_distribution<uint32_t> color(0, 0xFFFFFF);
+			Palette									palette;
+			palette.size = size;
+			for (int i = 0; i < size; ++i)
+			{
+				palette.colors[i] = 0xFF000000u | color(rng);
+			}
+			return palette;
+		}
+
+		// 返回首个差异的位置，一致时返回 -1
+		int first_mismatch(const std::vector<uint8_t> &expected, const std::vector<uint8_t> &actual)
+		{
+			for (std::size_t i = 0; i < expected.size(); ++i)
+			{
+				if (expected[i] != actual[i])
+				{
+					return static_cast<int>(i);
+				}
+			}
+			return -1;
+		}
+
+		/** @brief 直接调用各内核，与 map_row_scalar 逐行比对 */
+		int check_rows(std::mt19937 &rng, const std::vector<KernelCase> &kernels)
+		{
+			// 随机逆色表能区分每个像素落在哪一格；末尾填充供 gather 越界读取
+			const std::vector<uint8_t> lut = random_bytes(rng, qk::LUT_SIZE + qk::LUT_PADDING);
+
+			std::vector<int> widths;
+			for (int w = 1; w <= 67; ++w)
+			{
+				widths.push_back(w);
+			}
+			widths.insert(widths.end(), {150, 766});
+
+			int failures = 0;
+			for (const int width: widths)
+			{
+				const auto			 bytes = static_cast<std::size_t>(width) * 4;
+				std::vector<uint8_t> bias_add, bias_sub;
+				random_bias(rng, bytes, bias_add, bias_sub);
+
+				for (const bool biased: {false, true})
+				{
+					// 每种组合换一行像素，覆盖更多的表项
+					const std::vector<uint8_t> row = random_bytes(rng, bytes);
+					const uint8_t			  *add = biased ? bias_add.data() : nullptr;
+					const uint8_t			  *sub = biased ? bias_sub.data() : nullptr;
+
+					std::vector<uint8_t> expected(width);
+					qk::map_row_scalar(row.data(), width, lut.data(), add, sub, expected.data());
+
+					for (const auto &kernel: kernels)
+					{
+						std::vector<uint8_t> actual(width);
+						kernel.map_row(row.data(), width, lut.data(), add, sub, actual.data());
+						if (const int x = first_mismatch(expected, actual); x >= 0)
+						{
+							std::cerr << std::format("map_row_{} width={} biased={}: pixel {} got {} expected {}\n",
+													 kernel.name,
+													 width,
+													 biased,
+													 x,
+													 actual[x],
+													 expected[x]);
+							++failures;
+						}
+					}
+				}
+			}
+			return failures;
+		}
+
+		/** @brief 经 Quantizer::map 比对整幅图像，偏置由 Quantizer 按抖动方式生成 */
+		int check_quantizer(std::mt19937 &rng, const std::vector<KernelCase> &kernels)
+		{
+			constexpr int HEIGHT = 19; // 不是抖动矩阵边长的整数倍，覆盖偏置行的循环
+
+			int failures = 0;
+			for (const int colors: {2, 16, 256})
+			{
+				const Palette palette = random_palette(rng, colors);
+				for (const DitherMode dither: {DitherMode::None, DitherMode::Bayer, DitherMode::BlueNoise})
+				{
+					for (const int width: {1, 7, 15, 31, 33, 150, 153})
+					{
+						const int				   stride = width * 4 + 12; // 行间留有间隙，确认内核不依赖连续存储
+						const std::vector<uint8_t> image  = random_bytes(rng, static_cast<std::size_t>(stride) * HEIGHT);
+
+						Quantizer scalar(Quantizer::Kernel::Scalar);
+						scalar.set_palette(palette);
+						scalar.set_dither(dither);
+						std::vector<uint8_t> expected(static_cast<std::size_t>(width) * HEIGHT);
+						scalar.map(image.data(), stride, width, HEIGHT, expected.data(), width);
+
+						for (const auto &kernel: kernels)
+						{
+							Quantizer quantizer(kernel.kernel);
+							quantizer.set_palette(palette);
+							quantizer.set_dither(dither);
+							std::vector<uint8_t> actual(expected.size());
+							quantizer.map(image.data(), stride, width, HEIGHT, actual.data(), width);
+							if (const int i = first_mismatch(expected, actual); i >= 0)
+							{
+								std::cerr << std::format("Quantizer({}) colors={} dither={} width={}: pixel ({}, {}) got {} expected {}\n",
+														 kernel.name,
+														 colors,
+														 static_cast<int>(dither),
+														 width,
+														 i % width,
+														 i / width,
+														 actual[i],
+														 expected[i]);
+								++failures;
+							}
+						}
+					}
+				}
+			}
+			return failures;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	const auto kernels = supported_kernels();
+	if (kernels.empty())
+	{
+		std::cout << "no SIMD kernels supported on this CPU, nothing to compare\n";
+		return EXIT_SUCCESS;
+	}
+
+	std::mt19937 rng(20240611); // 固定种子，失败可复现
+	const int	 failures = check_rows(rng, kernels) + check_quantizer(rng, kernels);
+
+	if (failures)
+	{
+		std::cerr << std::format("{} mismatches\n", failures);
+		return EXIT_FAILURE;
+	}
+	for (const auto &kernel: kernels)
+	{
+		std::cout << std::format("{}: matches scalar\n", kernel.name);
+	}
+	return EXIT_SUCCESS;
+}
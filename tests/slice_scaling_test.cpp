@@ -0,0 +1,224 @@
+/**
+ * @file slice_scaling_test.cpp
+ * @brief 解码流水线中并行缩放的结果校验
+ *
+ * 按 run_internal 解码循环的方式驱动 EncodeStage：合成的源帧引用进帧槽，经 EncodeStage::scale 在共享调度器上缩放，
+ * 多个在途帧的缩放同时进行，完成顺序不定。源帧在几种分辨率之间轮换，缩放上下文每帧都需重建；
+ * 量化前的钩子核对帧仍按提交顺序到达，并把各切片的缩放结果与单线程、独立上下文得到的参考结果逐字节比对，
+ * 出现差异时返回非 0。
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <stop_token>
+#include <vector>
+#include "encode_stage.h"
+#include "encoder_pool.h"
+#include "gif_writer.h"
+#include "quantizer.h"
+#include "slice_scaler.h"
+#include "task_options.h"
+#include "thread_pool.h"
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int SLICE_COUNT	= EncodeStage::SLICE_COUNT;
+		constexpr int SLICE_WIDTH	= SliceScaler::SLICE_WIDTH;
+		constexpr int SLICE_HEIGHT	= 96;
+		constexpr int SOURCE_FRAMES = 12;  // 循环使用的合成帧数
+		constexpr int TOTAL_FRAMES	= 240; // 远多于帧槽数，各帧槽都经过多轮复用
+
+		// 相邻帧分辨率不同，同时缩放的两帧共用一个上下文时必然互相破坏
+		constexpr std::array<std::array<int, 2>, 3> SOURCE_SIZES = {{{640, 360}, {1280, 720}, {854, 480}}};
+
+		/** @brief 一帧五个切片的参考缩放结果（紧密排列的 BGRA 行） */
+		using Reference = std::array<std::vector<uint8_t>, SLICE_COUNT>;
+
+		// 亮度与色度平面上的斜向渐变，各帧的相位与分辨率都不同
+		AVFrame *make_source(const int index)
+		{
+			const auto [width, height] = SOURCE_SIZES[index % SOURCE_SIZES.size()];
+			AVFrame *frame			   = av_frame_alloc();
+			if (!frame)
+			{
+				return nullptr;
+			}
+			frame->format = AV_PIX_FMT_YUV420P;
+			frame->width  = width;
+			frame->height = height;
+			if (av_frame_get_buffer(frame, 32) < 0)
+			{
+				av_frame_free(&frame);
+				return nullptr;
+			}
+			for (int p = 0; p < 3; ++p)
+			{
+				const int w = p == 0 ? width : width / 2;
+				const int h = p == 0 ? height : height / 2;
+				for (int y = 0; y < h; ++y)
+				{
+					uint8_t *row = frame->data[p] + static_cast<std::ptrdiff_t>(y) * frame->linesize[p];
+					for (int x = 0; x < w; ++x)
+					{
+						row[x] = static_cast<uint8_t>((x + y * (p + 1) + index * 11) & 0xFF);
+					}
+				}
+			}
+			return frame;
+		}
+
+		// 单线程、每个切片一个独立上下文，得到比对用的参考结果
+		bool make_reference(const AVFrame &source, const int sws_flags, Reference &reference)
+		{
+			AVFrame *dst = SliceScaler::alloc_frame(SLICE_WIDTH, SLICE_HEIGHT, AV_PIX_FMT_BGRA);
+			bool	 ok	 = dst != nullptr;
+			for (int i = 0; ok && i < SLICE_COUNT; ++i)
+			{
+				SwsContext *context = nullptr;
+				ok					= SliceScaler::scale(context, sws_flags, SliceScaler::map_source(source, i), dst);
+				sws_freeContext(context);
+				reference[i].resize(static_cast<std::size_t>(SLICE_WIDTH) * SLICE_HEIGHT * 4);
+				for (int y = 0; ok && y < SLICE_HEIGHT; ++y)
+				{
+					std::memcpy(reference[i].data() + static_cast<std::size_t>(y) * SLICE_WIDTH * 4,
+								dst->data[0] + static_cast<std::ptrdiff_t>(y) * dst->linesize[0],
+								SLICE_WIDTH * 4);
+				}
+			}
+			av_frame_free(&dst);
+			return ok;
+		}
+
+		bool matches(const AVFrame &scaled, const std::vector<uint8_t> &reference)
+		{
+			for (int y = 0; y < SLICE_HEIGHT; ++y)
+			{
+				if (std::memcmp(scaled.data[0] + static_cast<std::ptrdiff_t>(y) * scaled.linesize[0],
+								reference.data() + static_cast<std::size_t>(y) * SLICE_WIDTH * 4,
+								SLICE_WIDTH * 4) != 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	constexpr int quality_mode = 2;
+	const int	  sws_flags	   = SliceScaler::select_sws_flags(quality_mode);
+
+	std::vector<AVFrame *> sources(SOURCE_FRAMES);
+	std::vector<Reference> references(SOURCE_FRAMES);
+	bool				   prepared = true;
+	for (int f = 0; f < SOURCE_FRAMES; ++f)
+	{
+		sources[f] = make_source(f);
+		prepared   = prepared && sources[f] && make_reference(*sources[f], sws_flags, references[f]);
+	}
+
+	ThreadPool				  pool(4);
+	std::vector<EncoderState> encoders(SLICE_COUNT);
+	for (auto &e: encoders)
+	{
+		e.native = std::make_unique<GifWriter>();
+		e.native->open_memory(SLICE_WIDTH, SLICE_HEIGHT, &pool, 0);
+	}
+
+	int checked		 = 0;
+	int mismatches	 = 0;
+	int out_of_order = 0;
+	{
+		const std::stop_source stop;
+		TaskOptions			   options;
+		Quantizer			   quantizer;
+		options.quality_mode = quality_mode;
+
+		// 钩子在量化 Strand 上执行，此时该帧的缩放已全部完成；时间戳应与提交顺序一致
+		EncodeStage stage(pool,
+						  encoders,
+						  SLICE_HEIGHT,
+						  options,
+						  quantizer,
+						  PaletteMode::PerFrame,
+						  255,
+						  stop.get_token(),
+						  [&](const EncodeStage::FrameSlot &slot)
+						  {
+							  if (slot.pts != static_cast<int64_t>(checked) * 4)
+							  {
+								  ++out_of_order;
+							  }
+							  const Reference &reference = references[static_cast<std::size_t>(slot.pts / 4) % SOURCE_FRAMES];
+							  for (int i = 0; i < SLICE_COUNT; ++i)
+							  {
+								  if (!matches(*slot.scaled[i], reference[i]))
+								  {
+									  ++mismatches;
+								  }
+							  }
+							  ++checked;
+						  });
+		if (!prepared || !stage.ready())
+		{
+			std::cerr << "setting up the synthetic frames or the encode stage failed\n";
+			return EXIT_FAILURE;
+		}
+
+		// 与 run_internal 的解码循环一致：帧槽引用源帧，缩放任务提交后立即提交量化，随即处理下一帧
+		for (int f = 0; f < TOTAL_FRAMES; ++f)
+		{
+			EncodeStage::FrameSlot *slot = stage.acquire();
+			if (!slot)
+			{
+				break;
+			}
+			av_frame_unref(slot->frame);
+			if (av_frame_ref(slot->frame, sources[f % SOURCE_FRAMES]) < 0)
+			{
+				break;
+			}
+			slot->pts = static_cast<int64_t>(f) * 4;
+			stage.scale(*slot);
+			stage.submit(*slot);
+		}
+		stage.wait_idle();
+	}
+
+	for (auto &e: encoders)
+	{
+		e.native->finish(4);
+	}
+	for (auto &f: sources)
+	{
+		av_frame_free(&f);
+	}
+
+	if (checked != TOTAL_FRAMES || mismatches || out_of_order)
+	{
+		std::cerr << std::format(
+			"{} of {} frames scaled, {} out of order, {} slices differ from the single-threaded reference\n", checked, TOTAL_FRAMES, out_of_order, mismatches);
+		return EXIT_FAILURE;
+	}
+	std::cout << std::format("{} frames scaled concurrently, all slices match the single-threaded reference\n", checked);
+	return EXIT_SUCCESS;
+}
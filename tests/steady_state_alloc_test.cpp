@@ -0,0 +1,321 @@
+/**
+ * @file steady_state_alloc_test.cpp
+ * @brief 自研后端逐帧编码循环的堆分配计数
+ *
+ * 替换全局 operator new 统计分配次数，驱动 run_internal 所用的 EncodeStage：合成帧直接写入帧槽的缩放平面，
+ * 量化、去重与帧间增量经各切片的 Strand 在共享调度器上逐帧执行，GifWriter 的 LZW 压缩同样交给调度器。
+ * 预热之后的若干帧内（含调度器工作线程）不允许出现任何分配，出现时返回非 0。
+ * 解码与缩放依赖 FFmpeg 的内部分配（见 VideoDecoder::decode_next），不在本测试范围内。
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stop_token>
+#include <string_view>
+#include <vector>
+#include "encode_stage.h"
+#include "encoder_pool.h"
+#include "gif_writer.h"
+#include "palette.h"
+#include "quantizer.h"
+#include "task_options.h"
+#include "thread_pool.h"
+
+extern "C"
+{
+#include <libavutil/frame.h>
+}
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace
+{
+	std::atomic<bool>		 counting{false};
+	std::atomic<std::size_t> allocations{0};
+
+	void *allocate(const std::size_t size)
+	{
+		if (counting.load(std::memory_order_relaxed))
+		{
+			allocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (void *p = std::malloc(size ? size : 1))
+		{
+			return p;
+		}
+		throw std::bad_alloc();
+	}
+
+	void *allocate_aligned(const std::size_t size, const std::align_val_t alignment)
+	{
+		if (counting.load(std::memory_order_relaxed))
+		{
+			allocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		const auto align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+		void *p = _aligned_malloc(size ? size : 1, align);
+#else
+		void *p = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+		if (p)
+		{
+			return p;
+		}
+		throw std::bad_alloc();
+	}
+
+	void release_aligned(void *p)
+	{
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+} // namespace
+
+// 其余形式（nothrow、对齐且带大小的 delete）默认转发到以下版本
+void *operator new(const std::size_t size)
+{
+	return allocate(size);
+}
+
+void *operator new[](const std::size_t size)
+{
+	return allocate(size);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return allocate_aligned(size, alignment);
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+	return allocate_aligned(size, alignment);
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+	release_aligned(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+	release_aligned(p);
+}
+
+namespace SteamShowcaseGen
+{
+	namespace
+	{
+		constexpr int SLICE_COUNT	 = EncodeStage::SLICE_COUNT;
+		constexpr int SLICE_WIDTH	 = SliceScaler::SLICE_WIDTH;
+		constexpr int SLICE_HEIGHT	 = 96;
+		constexpr int SOURCE_FRAMES	 = 24; // 循环使用的合成帧数
+		constexpr int WARMUP_FRAMES	 = 64; // 多于 GifWriter 的任务槽数，所有缓冲区都已达到稳态容量
+		constexpr int MEASURE_FRAMES = 64;
+
+		/**
+		 * @struct Config
+		 * @brief 一组编码参数
+		 */
+		struct Config
+		{
+			std::string_view name;
+			PaletteMode		 palette_mode;
+			DitherMode		 dither;
+			DedupMode		 dedup;
+			int				 lossy_error;
+		};
+
+		/** @brief 合成的一帧：五个切片的 BGRA 平面 */
+		struct SourceFrame
+		{
+			std::array<std::vector<uint8_t>, SLICE_COUNT> slices;
+		};
+
+		// 渐变背景上移动的色块：每帧都有变化区域，也不会被判为重复帧
+		std::vector<SourceFrame> make_frames()
+		{
+			std::vector<SourceFrame> frames(SOURCE_FRAMES);
+			for (int f = 0; f < SOURCE_FRAMES; ++f)
+			{
+				for (int i = 0; i < SLICE_COUNT; ++i)
+				{
+					auto &plane = frames[f].slices[i];
+					plane.resize(static_cast<std::size_t>(SLICE_WIDTH) * SLICE_HEIGHT * 4);
+					for (int y = 0; y < SLICE_HEIGHT; ++y)
+					{
+						for (int x = 0; x < SLICE_WIDTH; ++x)
+						{
+							const bool block = x / 24 == (f + i) % 6 && y / 24 == f % 4;
+							uint8_t	  *p	 = plane.data() + (static_cast<std::size_t>(y) * SLICE_WIDTH + x) * 4;
+							p[0]			 = static_cast<uint8_t>(block ? 255 - x : x + i * 20);
+							p[1]			 = static_cast<uint8_t>(block ? f * 10 : y * 2);
+							p[2]			 = static_cast<uint8_t>(block ? 40 : (x + y + f * 3) & 0xFF);
+							p[3]			 = 255;
+						}
+					}
+				}
+			}
+			return frames;
+		}
+
+		// 代替解码与缩放：取出空闲帧槽，写入合成帧后提交，与 run_internal 的解码循环一致
+		void feed(EncodeStage &stage, const SourceFrame &frame, const int64_t pts)
+		{
+			EncodeStage::FrameSlot *slot = stage.acquire();
+			if (!slot)
+			{
+				return;
+			}
+			for (int i = 0; i < SLICE_COUNT; ++i)
+			{
+				AVFrame		  *dst = slot->scaled[i];
+				const uint8_t *src = frame.slices[i].data();
+				for (int y = 0; y < SLICE_HEIGHT; ++y)
+				{
+					std::memcpy(dst->data[0] + static_cast<std::ptrdiff_t>(y) * dst->linesize[0], src + y * SLICE_WIDTH * 4, SLICE_WIDTH * 4);
+				}
+			}
+			slot->pts = pts;
+			stage.submit(*slot);
+		}
+	} // namespace
+} // namespace SteamShowcaseGen
+
+int main()
+{
+	using namespace SteamShowcaseGen;
+
+	static constexpr std::array<Config, 3> configs = {{
+		{"global_none_exact", PaletteMode::Global, DitherMode::None, DedupMode::Exact, 0},
+		{"global_bayer_lossy", PaletteMode::Global, DitherMode::Bayer, DedupMode::Perceptual, 32},
+		{"per_frame_blue_noise", PaletteMode::PerFrame, DitherMode::BlueNoise, DedupMode::Exact, 0},
+	}};
+
+	const auto frames = make_frames();
+	const auto dir	  = std::filesystem::temp_directory_path() / "ssg_steady_state_alloc_test";
+	std::filesystem::create_directories(dir);
+
+	ThreadPool pool(4);
+	int		   failures = 0;
+	for (const auto &config: configs)
+	{
+		TaskOptions options;
+		options.palette_mode	= config.palette_mode;
+		options.dither			= config.dither;
+		options.dedup			= config.dedup;
+		options.dedup_threshold = 2;
+		options.delta_frames	= true;
+
+		// 与 run_internal 相同：帧间增量在调色板中预留一个透明色
+		Quantizer quantizer;
+		quantizer.set_dither(config.dither);
+		if (config.palette_mode == PaletteMode::Global)
+		{
+			ColorHistogram histogram;
+			for (const auto &frame: frames)
+			{
+				histogram.add(frame.slices[0].data(), SLICE_WIDTH * 4, SLICE_WIDTH, SLICE_HEIGHT);
+			}
+			quantizer.set_palette(histogram.build_palette(255));
+		}
+
+		std::vector<EncoderState> encoders(SLICE_COUNT);
+		bool					  opened = true;
+		for (int i = 0; i < SLICE_COUNT; ++i)
+		{
+			const auto path	   = dir / std::format("{}_{}.gif", config.name, i);
+			encoders[i].native = std::make_unique<GifWriter>();
+			if (!encoders[i].native->open(path, SLICE_WIDTH, SLICE_HEIGHT, &pool, config.lossy_error))
+			{
+				opened = false;
+			}
+		}
+
+		std::size_t counted = 0;
+		{
+			const std::stop_source stop;
+			EncodeStage			   stage(pool, encoders, SLICE_HEIGHT, options, quantizer, config.palette_mode, 255, stop.get_token());
+			if (!opened || !stage.ready())
+			{
+				std::cerr << std::format("{}: setting up the encode stage failed\n", config.name);
+				++failures;
+				continue;
+			}
+
+			int frame = 0;
+			for (; frame < WARMUP_FRAMES; ++frame)
+			{
+				feed(stage, frames[frame % SOURCE_FRAMES], frame * 4);
+			}
+			stage.wait_idle();
+
+			allocations.store(0);
+			counting.store(true);
+			for (; frame < WARMUP_FRAMES + MEASURE_FRAMES; ++frame)
+			{
+				feed(stage, frames[frame % SOURCE_FRAMES], frame * 4);
+			}
+			stage.wait_idle();
+			counting.store(false);
+			counted = allocations.load();
+		}
+
+		bool written = true;
+		for (auto &e: encoders)
+		{
+			written = e.native->finish(4) && written;
+		}
+		if (!written)
+		{
+			std::cerr << std::format("{}: writing the output failed\n", config.name);
+			++failures;
+		}
+		if (counted)
+		{
+			std::cerr << std::format("{}: {} heap allocations in {} warmed-up frames\n", config.name, counted, MEASURE_FRAMES);
+			++failures;
+			continue;
+		}
+		std::cout << std::format("{}: no heap allocations in {} warmed-up frames\n", config.name, MEASURE_FRAMES);
+	}
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}